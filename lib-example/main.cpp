@@ -61,13 +61,9 @@ int main(int argc, char *argv[])
     // Render
     auto comp = comps->values[0];
     QImage bmp(comp->width.get(), comp->height.get(), QImage::Format_ARGB32);
-    bmp.fill(Qt::transparent);
-
+    // The renderer and image can be reused to render more frames
     auto renderer = renderer::RendererRegistry::instance().default_renderer(10);
-    renderer->set_image_surface(&bmp);
-    renderer->render_start();
-    comp->paint(renderer.get(), frame, model::VisualNode::Render);
-    renderer->render_end();
+    comp->render_image(frame, bmp, renderer.get());
 
     bmp.save(out_filename);
 
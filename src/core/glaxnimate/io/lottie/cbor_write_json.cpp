@@ -373,3 +373,115 @@ QByteArray glaxnimate::io::lottie::cbor_write_json(const QCborMap &o, bool compa
     json += compact ? "}" : "}\n";
     return json;
 }
+
+glaxnimate::io::lottie::CborJsonStreamWriter::CborJsonStreamWriter(QIODevice* device, bool compact)
+    : device(device), compact(compact)
+{
+}
+
+glaxnimate::io::lottie::CborJsonStreamWriter::~CborJsonStreamWriter()
+{
+    flush();
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::flush()
+{
+    if ( !buffer.isEmpty() )
+    {
+        device->write(buffer);
+        buffer.clear();
+    }
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::start_element()
+{
+    if ( after_key )
+    {
+        after_key = false;
+        return;
+    }
+
+    if ( empty.empty() )
+        return;
+
+    if ( !empty.back() )
+        buffer += compact ? "," : ",\n";
+    empty.back() = false;
+
+    if ( !compact )
+        buffer += QByteArray(4 * (empty.size() - 1), ' ');
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::end_container(char close)
+{
+    bool was_empty = empty.back();
+    empty.pop_back();
+
+    if ( !compact && !was_empty )
+        buffer += '\n';
+
+    if ( empty.empty() )
+    {
+        buffer += close;
+        if ( !compact )
+            buffer += '\n';
+        flush();
+        return;
+    }
+
+    if ( !compact )
+        buffer += QByteArray(4 * (empty.size() - 1), ' ');
+    buffer += close;
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::start_object()
+{
+    start_element();
+    buffer += compact ? "{" : "{\n";
+    empty.push_back(true);
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::end_object()
+{
+    end_container('}');
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::start_array()
+{
+    start_element();
+    buffer += compact ? "[" : "[\n";
+    empty.push_back(true);
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::end_array()
+{
+    end_container(']');
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::write_key(const QString& key)
+{
+    start_element();
+    buffer += '"';
+    buffer += escapedString(key);
+    buffer += compact ? "\":" : "\": ";
+    after_key = true;
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::write_value(const QCborValue& value)
+{
+    start_element();
+    valueToJson(value, buffer, compact ? 0 : empty.size() - 1, compact);
+
+    // Keep the buffer small while still avoiding lots of tiny writes
+    if ( buffer.size() >= 0x10000 )
+        flush();
+}
+
+void glaxnimate::io::lottie::CborJsonStreamWriter::write_members(const QCborMap& object)
+{
+    for ( auto it = object.begin(); it != object.end(); ++it )
+    {
+        write_key(it.key().toString());
+        write_value(it.value());
+    }
+}
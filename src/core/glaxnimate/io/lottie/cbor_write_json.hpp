@@ -6,12 +6,60 @@
 
 #pragma once
 
+#include <vector>
+
 #include <QCborMap>
 #include <QCborArray>
+#include <QIODevice>
 
 namespace glaxnimate::io::lottie {
 
 
 QByteArray cbor_write_json(const QCborMap& obj, bool compact);
 
+/**
+ * \brief Writes JSON to a device as it's being generated
+ *
+ * Produces the same output as cbor_write_json() but objects and arrays
+ * can be written a piece at a time so the full document is never in memory.
+ */
+class CborJsonStreamWriter
+{
+public:
+    CborJsonStreamWriter(QIODevice* device, bool compact);
+    ~CborJsonStreamWriter();
+
+    void start_object();
+    void end_object();
+    void start_array();
+    void end_array();
+
+    /**
+     * \brief Writes an object key, must be followed by a value, object, or array
+     */
+    void write_key(const QString& key);
+    void write_value(const QCborValue& value);
+
+    /**
+     * \brief Writes all the keys and values in \p object into the current object
+     */
+    void write_members(const QCborMap& object);
+
+    /**
+     * \brief Writes any buffered data to the device
+     */
+    void flush();
+
+private:
+    void start_element();
+    void end_container(char close);
+
+    QIODevice* device;
+    bool compact;
+    QByteArray buffer;
+    /// For each open object or array, whether it's still empty
+    std::vector<bool> empty;
+    bool after_key = false;
+};
+
 } // namespace glaxnimate::io::lottie
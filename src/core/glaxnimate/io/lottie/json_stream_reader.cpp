@@ -0,0 +1,264 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "glaxnimate/io/lottie/json_stream_reader.hpp"
+
+#include <QJsonDocument>
+#include <QJsonArray>
+
+#include "glaxnimate/utils/i18n.hpp"
+
+static constexpr qint64 chunk_size = 0x10000;
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+glaxnimate::io::lottie::JsonStreamReader::JsonStreamReader(QIODevice* device)
+    : device(device)
+{
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::fill()
+{
+    if ( pos < buffer.size() )
+        return true;
+
+    buffer_start += buffer.size();
+    buffer = device->read(chunk_size);
+    pos = 0;
+    return !buffer.isEmpty();
+}
+
+char glaxnimate::io::lottie::JsonStreamReader::peek()
+{
+    while ( fill() )
+    {
+        char c = buffer[pos];
+        if ( !is_space(c) )
+            return c;
+        pos++;
+    }
+
+    return 0;
+}
+
+void glaxnimate::io::lottie::JsonStreamReader::set_error(const QString& message)
+{
+    if ( error.isEmpty() )
+        error = i18n("Could not parse JSON at offset %1: %2", position(), message);
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::expect(char c)
+{
+    if ( !error.isEmpty() )
+        return false;
+
+    char next = peek();
+    if ( next != c )
+    {
+        set_error(next ? i18n("Expected '%1'", QChar(c)) : i18n("Unexpected end of file"));
+        return false;
+    }
+    pos++;
+    return true;
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::begin_object()
+{
+    if ( !expect('{') )
+        return false;
+    first.push_back(true);
+    return true;
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::begin_array()
+{
+    if ( !expect('[') )
+        return false;
+    first.push_back(true);
+    return true;
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::next_is_object()
+{
+    return error.isEmpty() && peek() == '{';
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::next_is_array()
+{
+    return error.isEmpty() && peek() == '[';
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::next_item(char close)
+{
+    if ( !error.isEmpty() || first.empty() )
+        return false;
+
+    if ( peek() == close )
+    {
+        pos++;
+        first.pop_back();
+        return false;
+    }
+
+    if ( first.back() )
+        first.back() = false;
+    else if ( !expect(',') )
+        return false;
+
+    return true;
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::next_member(QString& key)
+{
+    if ( !next_item('}') )
+        return false;
+
+    if ( peek() != '"' )
+    {
+        set_error(i18n("Expected object key"));
+        return false;
+    }
+
+    key = read_value().toString();
+    return expect(':');
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::next_element()
+{
+    return next_item(']');
+}
+
+QByteArray glaxnimate::io::lottie::JsonStreamReader::raw_value()
+{
+    QByteArray out;
+
+    char start = peek();
+    if ( !start || start == ',' || start == ':' || start == '}' || start == ']' )
+    {
+        set_error(start ? i18n("Expected value") : i18n("Unexpected end of file"));
+        return out;
+    }
+
+    bool scalar = start != '"' && start != '{' && start != '[';
+    bool in_string = false;
+    bool escape = false;
+    int depth = 0;
+
+    // Scan for the end of the value, appending whole chunks at a time
+    while ( fill() )
+    {
+        int chunk_start = pos;
+        for ( ; pos < buffer.size(); pos++ )
+        {
+            char c = buffer[pos];
+            if ( in_string )
+            {
+                if ( escape )
+                {
+                    escape = false;
+                }
+                else if ( c == '\\' )
+                {
+                    escape = true;
+                }
+                else if ( c == '"' )
+                {
+                    in_string = false;
+                    if ( depth == 0 )
+                    {
+                        pos++;
+                        out.append(buffer.constData() + chunk_start, pos - chunk_start);
+                        return out;
+                    }
+                }
+            }
+            else if ( scalar )
+            {
+                if ( is_space(c) || c == ',' || c == '}' || c == ']' )
+                {
+                    out.append(buffer.constData() + chunk_start, pos - chunk_start);
+                    return out;
+                }
+            }
+            else if ( c == '"' )
+            {
+                in_string = true;
+            }
+            else if ( c == '{' || c == '[' )
+            {
+                depth++;
+            }
+            else if ( c == '}' || c == ']' )
+            {
+                depth--;
+                if ( depth == 0 )
+                {
+                    pos++;
+                    out.append(buffer.constData() + chunk_start, pos - chunk_start);
+                    return out;
+                }
+            }
+        }
+        out.append(buffer.constData() + chunk_start, pos - chunk_start);
+    }
+
+    // A number at the end of the file is complete, anything else is truncated
+    if ( !scalar )
+        set_error(i18n("Unexpected end of file"));
+    return out;
+}
+
+QJsonValue glaxnimate::io::lottie::JsonStreamReader::read_value()
+{
+    if ( !error.isEmpty() )
+        return {};
+
+    QByteArray raw = raw_value();
+    if ( !error.isEmpty() )
+        return {};
+
+    bool container = raw[0] == '{' || raw[0] == '[';
+    // QJsonDocument only parses objects and arrays at the top level
+    if ( !container )
+        raw = '[' + raw + ']';
+
+    QJsonParseError parse_error;
+    QJsonDocument doc = QJsonDocument::fromJson(raw, &parse_error);
+    if ( parse_error.error != QJsonParseError::NoError )
+    {
+        set_error(parse_error.errorString());
+        return {};
+    }
+
+    if ( !container )
+        return doc.array()[0];
+    if ( doc.isObject() )
+        return doc.object();
+    return doc.array();
+}
+
+void glaxnimate::io::lottie::JsonStreamReader::skip_value()
+{
+    raw_value();
+}
+
+bool glaxnimate::io::lottie::JsonStreamReader::has_error() const
+{
+    return !error.isEmpty();
+}
+
+QString glaxnimate::io::lottie::JsonStreamReader::error_string() const
+{
+    return error;
+}
+
+qint64 glaxnimate::io::lottie::JsonStreamReader::position() const
+{
+    return buffer_start + pos;
+}
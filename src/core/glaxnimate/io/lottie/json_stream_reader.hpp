@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <QIODevice>
+#include <QJsonValue>
+
+namespace glaxnimate::io::lottie {
+
+/**
+ * \brief Pull parser that reads JSON from a device a piece at a time
+ *
+ * Objects and arrays can be walked one member / element at a time and
+ * each value is only parsed into a QJsonValue when read_value() is called,
+ * so the whole file never needs to be in memory at once.
+ */
+class JsonStreamReader
+{
+public:
+    explicit JsonStreamReader(QIODevice* device);
+
+    /**
+     * \brief Enters the object at the current position
+     * \return \b false if the next value isn't an object
+     */
+    bool begin_object();
+
+    /**
+     * \brief Enters the array at the current position
+     * \return \b false if the next value isn't an array
+     */
+    bool begin_array();
+
+    /**
+     * \brief Advances to the next member of the current object
+     * \param[out] key Name of the member, its value is the next to be read
+     * \return \b false at the end of the object or on errors
+     */
+    bool next_member(QString& key);
+
+    /**
+     * \brief Advances to the next element of the current array
+     * \return \b false at the end of the array or on errors
+     */
+    bool next_element();
+
+    bool next_is_object();
+    bool next_is_array();
+
+    /**
+     * \brief Parses the value at the current position
+     */
+    QJsonValue read_value();
+
+    void skip_value();
+
+    bool has_error() const;
+    QString error_string() const;
+
+    /**
+     * \brief Number of bytes from the device that have been consumed
+     */
+    qint64 position() const;
+
+private:
+    bool fill();
+    char peek();
+    bool expect(char c);
+    bool next_item(char close);
+    QByteArray raw_value();
+    void set_error(const QString& message);
+
+    QIODevice* device;
+    QByteArray buffer;
+    int pos = 0;
+    qint64 buffer_start = 0;
+    /// For each open object or array, whether no items have been read yet
+    std::vector<bool> first;
+    QString error;
+};
+
+} // namespace glaxnimate::io::lottie
@@ -56,29 +56,49 @@ public:
         json["op"_l] = animation->last_frame.get();
     }
 
-    void convert_composition(model::Composition* composition, QCborMap& json)
+    /**
+     * \brief Converts the layers of \p composition calling \p on_layer for each lottie layer in output order
+     */
+    template<class Callback>
+    void convert_layers(model::Composition* composition, const Callback& on_layer)
     {
-        QCborArray layers;
-        for ( const auto& layer : composition->shapes )
+        // Lottie layers go from top to bottom and a shape can expand to
+        // multiple layers so go backwards to output each layer as it's done
+        for ( int i = composition->shapes.size() - 1; i >= 0; i-- )
         {
+            auto layer = composition->shapes[i];
             if ( !strip || layer->visible.get() )
             {
                 wrap_to_layer.clear();
-                shape_is_layer(layer.get());
-                convert_as_layer(layer.get(), layers, nullptr, true, {}, composition->animation.get());
+                shape_is_layer(layer);
+                QCborArray layers;
+                convert_as_layer(layer, layers, nullptr, true, {}, composition->animation.get());
+                for ( const auto& json : layers )
+                    on_layer(json.toMap());
             }
         }
+    }
 
+    void convert_composition(model::Composition* composition, QCborMap& json)
+    {
+        QCborArray layers;
+        convert_layers(composition, [&layers](const QCborMap& layer){ layers.push_back(layer); });
         json["layers"_l] = layers;
     }
 
-    QCborMap convert_main(model::Composition* animation)
+    QCborMap convert_main_header(model::Composition* animation)
     {
-        layer_indices.clear();
         QCborMap json;
         json["v"_l] = version;
         convert_animation_container(animation->animation.get(), json);
         convert_object_basic(animation, json);
+        return json;
+    }
+
+    QCborMap convert_main(model::Composition* animation)
+    {
+        layer_indices.clear();
+        QCborMap json = convert_main_header(animation);
         json["assets"_l] = convert_assets(animation);
         convert_composition(animation, json);
         if ( !strip )
@@ -86,6 +106,37 @@ public:
         return json;
     }
 
+    /**
+     * \brief Writes the same JSON as to_json() with each asset and layer written as soon as it's converted
+     * \param extra Additional members for the top-level object
+     */
+    void write_json(CborJsonStreamWriter& writer, const QCborMap& extra = {})
+    {
+        layer_indices.clear();
+        writer.start_object();
+        writer.write_members(convert_main_header(main));
+
+        writer.write_key("assets"_l);
+        writer.start_array();
+        convert_assets(main, [&writer](const QCborMap& asset){ writer.write_value(asset); });
+        writer.end_array();
+
+        writer.write_key("layers"_l);
+        writer.start_array();
+        convert_layers(main, [&writer](const QCborMap& layer){ writer.write_value(layer); });
+        writer.end_array();
+
+        if ( !strip )
+        {
+            QCborMap meta;
+            convert_meta(meta);
+            writer.write_members(meta);
+        }
+
+        writer.write_members(extra);
+        writer.end_object();
+    }
+
     void convert_meta(QCborMap& json)
     {
         QCborMap meta;
@@ -766,7 +817,13 @@ public:
     QCborArray convert_assets(model::Composition* animation)
     {
         QCborArray assets;
+        convert_assets(animation, [&assets](const QCborMap& asset){ assets.push_back(asset); });
+        return assets;
+    }
 
+    template<class Callback>
+    void convert_assets(model::Composition* animation, const Callback& on_asset)
+    {
         if ( !strip_raster )
         {
             for ( const auto& bmp : document->assets()->images->values )
@@ -775,11 +832,11 @@ public:
                 {
                     auto clone = bmp->clone_covariant();
                     clone->embed(true);
-                    assets.push_back(convert_bitmat(clone.get()));
+                    on_asset(convert_bitmat(clone.get()));
                 }
                 else
                 {
-                    assets.push_back(convert_bitmat(bmp.get()));
+                    on_asset(convert_bitmat(bmp.get()));
                 }
             }
         }
@@ -787,10 +844,8 @@ public:
         for ( const auto& comp : document->assets()->compositions->values )
         {
             if ( comp.get() != animation )
-                assets.push_back(convert_precomp(comp.get()));
+                on_asset(convert_precomp(comp.get()));
         }
-
-        return assets;
     }
 
     QCborMap convert_bitmat(model::Bitmap* bmp)
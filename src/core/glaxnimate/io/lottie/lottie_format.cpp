@@ -12,10 +12,19 @@
 bool glaxnimate::io::lottie::LottieFormat::on_save(QIODevice& file, const QString&,
                                                    model::Composition* comp, const QVariantMap& setting_values)
 {
-    file.write(cbor_write_json(to_json(comp, setting_values["strip"].toBool(), false, setting_values), !setting_values["pretty"].toBool()));
+    write_json(file, comp, !setting_values["pretty"].toBool(), setting_values["strip"].toBool(), false, setting_values);
     return true;
 }
 
+void glaxnimate::io::lottie::LottieFormat::write_json(QIODevice& device, model::Composition* comp, bool compact,
+                                                      bool strip, bool strip_raster,
+                                                      const QVariantMap& settings, const QCborMap& extra)
+{
+    detail::LottieExporterState exp(this, comp, strip, strip_raster, settings);
+    CborJsonStreamWriter writer(&device, compact);
+    exp.write_json(writer, extra);
+}
+
 QCborMap glaxnimate::io::lottie::LottieFormat::to_json(model::Composition* comp, bool strip, bool strip_raster, const QVariantMap& settings)
 {
     detail::LottieExporterState exp(this, comp, strip, strip_raster, settings);
@@ -46,9 +55,24 @@ bool glaxnimate::io::lottie::LottieFormat::load_json(const QByteArray& data, mod
     return true;
 }
 
+bool glaxnimate::io::lottie::LottieFormat::load_json(QIODevice& device, model::Document* document)
+{
+    // Progress is in KiB so large files fit in an int
+    qint64 size = device.isSequential() ? 0 : device.size() - device.pos();
+    if ( size > 0 )
+        Q_EMIT progress_max_changed(size / 1024);
+
+    JsonStreamReader reader(&device);
+    detail::LottieImporterState imp{document, this};
+    return imp.load(reader, [this, size](qint64 pos){
+        if ( size > 0 )
+            Q_EMIT progress(pos / 1024);
+    });
+}
+
 bool glaxnimate::io::lottie::LottieFormat::on_open(QIODevice& file, const QString&, model::Document* document, const QVariantMap&)
 {
-    return load_json(file.readAll(), document);
+    return load_json(file, document);
 }
 
 std::unique_ptr<glaxnimate::settings::SettingsGroup> glaxnimate::io::lottie::LottieFormat::save_settings(model::Composition*) const
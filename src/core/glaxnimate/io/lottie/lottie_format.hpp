@@ -28,6 +28,19 @@ public:
     QCborMap to_json(model::Composition* comp, bool strip = false, bool strip_raster = false, const QVariantMap& settings = {});
     bool load_json(const QByteArray& data, model::Document* document);
 
+    /**
+     * \brief Loads the JSON from \p device as it's being read, reporting progress
+     */
+    bool load_json(QIODevice& device, model::Document* document);
+
+    /**
+     * \brief Writes the JSON for \p comp to \p device without building the whole document in memory
+     * \param extra Additional members for the top-level object
+     */
+    void write_json(QIODevice& device, model::Composition* comp, bool compact,
+                    bool strip = false, bool strip_raster = false,
+                    const QVariantMap& settings = {}, const QCborMap& extra = {});
+
 private:
     bool on_save(QIODevice& file, const QString& filename, model::Composition* comp, const QVariantMap& setting_values) override;
 
@@ -14,6 +14,7 @@
 #include <QJsonArray>
 
 #include "glaxnimate/io/lottie/lottie_private_common.hpp"
+#include "glaxnimate/io/lottie/json_stream_reader.hpp"
 #include "glaxnimate/io/svg/svg_parser.hpp"
 #include "glaxnimate/model/animation/join_animatables.hpp"
 
@@ -46,6 +47,76 @@ public:
         load_comps(comps);
     }
 
+    /**
+     * \brief Loads the animation while it's being read from \p reader
+     *
+     * The raw file is never fully in memory: assets are loaded as soon as
+     * they are read, before the version and metadata which can come later
+     * in the file (neither affects how assets are loaded).
+     *
+     * Top level layers are kept as JSON until the whole file has been read
+     * and only then converted, as mattes and parents can reference layers
+     * further down the list and the composition settings can come after them.
+     * So peak memory still includes the JSON of all the top level layers.
+     * \param on_progress Called with the reader position after each asset and layer
+     * \return \b false on parse errors
+     */
+    template<class ProgressFunc>
+    bool load(JsonStreamReader& reader, const ProgressFunc& on_progress)
+    {
+        if ( !reader.begin_object() )
+        {
+            Q_EMIT format->error(i18n("No JSON object found"));
+            return false;
+        }
+
+        main = document->assets()->compositions->values.insert(std::make_unique<model::Composition>(document));
+        std::vector<std::pair<QJsonObject, model::Composition*>> comps;
+        QJsonObject json;
+        LayerList layers;
+
+        QString key;
+        while ( reader.next_member(key) )
+        {
+            if ( key == "assets" && reader.next_is_array() )
+            {
+                reader.begin_array();
+                while ( reader.next_element() )
+                {
+                    load_asset(reader.read_value().toObject(), comps);
+                    on_progress(reader.position());
+                }
+            }
+            else if ( key == "layers" && reader.next_is_array() )
+            {
+                reader.begin_array();
+                while ( reader.next_element() )
+                {
+                    layers.add(reader.read_value().toObject());
+                    on_progress(reader.position());
+                }
+            }
+            else
+            {
+                json[key] = reader.read_value();
+            }
+        }
+
+        if ( reader.has_error() )
+        {
+            Q_EMIT format->error(reader.error_string());
+            return false;
+        }
+
+        const QJsonObject& top_level = json;
+        load_version(top_level);
+        load_meta(top_level["meta"]);
+        load_fonts(top_level["fonts"]["list"].toArray());
+        load_composition(top_level, main, layers);
+        load_comps(comps);
+        return true;
+    }
+
 private:
     void load_version(const QJsonObject& json)
     {
@@ -123,6 +194,14 @@ private:
     }
 
     void load_composition(const QJsonObject& json, model::Composition* composition)
+    {
+        LayerList layers;
+        for ( auto val : json["layers"].toArray() )
+            layers.add(val.toObject());
+        load_composition(json, composition, layers);
+    }
+
+    void load_composition(const QJsonObject& json, model::Composition* composition, LayerList& layer_list)
     {
         this->composition = composition;
         layer_indices.clear();
@@ -148,31 +227,9 @@ private:
         load_basic(json, composition);
 
 
-        std::vector<LayerData> layers;
-        std::map<int, int> lottie_to_array_index;
-        auto raw_layers = json["layers"].toArray();
-        layers.reserve(layers.size());
-
-        // First pass, get index info
-        for ( auto val : raw_layers )
-        {
-            LayerData data;
-            data.json = val.toObject();
-
-            if ( data.json.contains("parent") )
-                data.has_parent = true;
-
-            if ( data.json.contains("ind") )
-            {
-                data.lottie_index = data.json["ind"].toInt();
-                data.has_index = true;
-                lottie_to_array_index[data.lottie_index] = layers.size();
-            }
-
-            data.name = data.json["nm"].toString();
-
-            layers.emplace_back(std::move(data));
-        }
+        // First pass (getting index info) is done by LayerList::add()
+        auto& layers = layer_list.layers;
+        const auto& lottie_to_array_index = layer_list.lottie_to_array_index;
 
         // Second pass, figure out matte + parent links
         for ( std::size_t i = 0; i < layers.size(); i++ )
@@ -301,6 +358,35 @@ private:
 
     };
 
+    /**
+     * \brief Layers of a composition, indexed as they are added
+     */
+    struct LayerList
+    {
+        std::vector<LayerData> layers;
+        std::map<int, int> lottie_to_array_index;
+
+        void add(QJsonObject json)
+        {
+            LayerData data;
+            data.json = std::move(json);
+
+            if ( data.json.contains("parent") )
+                data.has_parent = true;
+
+            if ( data.json.contains("ind") )
+            {
+                data.lottie_index = data.json["ind"].toInt();
+                data.has_index = true;
+                lottie_to_array_index[data.lottie_index] = layers.size();
+            }
+
+            data.name = data.json["nm"].toString();
+
+            layers.emplace_back(std::move(data));
+        }
+    };
+
     void load_visibility(model::VisualNode* node, const QJsonObject& json)
     {
         if ( json.contains("hd") && json["hd"].toBool() )
@@ -1227,17 +1313,19 @@ private:
         std::vector<std::pair<QJsonObject, model::Composition*>> comps;
 
         for ( const auto& assetv : assets )
-        {
-            QJsonObject asset = assetv.toObject();
-            if ( asset.contains("e") && asset.contains("p") && asset.contains("w") )
-                load_asset_bitmap(asset);
-            else if ( asset.contains("layers") )
-                comps.emplace_back(asset, load_asset_precomp(asset));
-        }
+            load_asset(assetv.toObject(), comps);
 
         return comps;
     }
 
+    void load_asset(const QJsonObject& asset, std::vector<std::pair<QJsonObject, model::Composition*>>& comps)
+    {
+        if ( asset.contains("e") && asset.contains("p") && asset.contains("w") )
+            load_asset_bitmap(asset);
+        else if ( asset.contains("layers") )
+            comps.emplace_back(asset, load_asset_precomp(asset));
+    }
+
     void load_comps(const std::vector<std::pair<QJsonObject, model::Composition*>>& comps)
     {
         for ( const auto& p : comps )
@@ -55,7 +55,7 @@ public:
             if ( auto visual = node->cast<model::VisualNode>() )
             {
                 visual_nodes.push_back(visual);
-                box |= visual->local_bounding_rect(visual->time());
+                box |= visual->cached_local_bounding_rect(visual->time());
             }
         }
 
@@ -79,7 +79,7 @@ public:
         if ( !node )
             return {};
 
-        QImage image(node->local_bounding_rect(time).size().toSize(), QImage::Format_ARGB32);
+        QImage image(node->cached_local_bounding_rect(time).size().toSize(), QImage::Format_ARGB32);
         image.fill(Qt::transparent);
         auto renderer = renderer::RendererRegistry::instance().default_renderer(10);
         renderer->set_image_surface(&image);
@@ -97,7 +97,7 @@ public:
         bmp->data.set(data);
         auto img = std::make_unique<model::Image>(out.document.get());
         img->image.set(bmp);
-        QPointF p(bmp->pixmap().width() / 2.0, bmp->pixmap().height() / 2.0);
+        QPointF p(bmp->width.get() / 2.0, bmp->height.get() / 2.0);
         img->transform->anchor_point.set(p);
         img->transform->position.set(p);
         out.main->shapes.insert(std::move(img));
@@ -8,9 +8,87 @@
 #include "glaxnimate/model/assets/composition.hpp"
 #include "glaxnimate/renderer/renderer.hpp"
 
+#include <atomic>
+#include <cstring>
+
 #include <QImage>
 #include <QPainter>
 #include <QImageWriter>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QThread>
+#include <QThreadPool>
+
+namespace {
+
+struct SheetLayout
+{
+    int frame_width;
+    int frame_height;
+    int columns;
+    int first_frame;
+    int frame_step;
+};
+
+/**
+ * \brief Renders \p cell_count frames starting from the cell \p first_cell into \p sheet
+ *
+ * Each worker renders whole frames into its own tile and copies them into
+ * their cell, so cells can be rendered concurrently.
+ */
+void render_sheet(glaxnimate::model::Composition* comp, QImage& sheet, const SheetLayout& layout, int first_cell, int cell_count, int threads)
+{
+    // Detach before the workers start writing into the sheet
+    uchar* sheet_data = sheet.bits();
+    qsizetype sheet_stride = sheet.bytesPerLine();
+    std::atomic<int> next_cell{0};
+
+    auto work = [&]{
+        auto renderer = glaxnimate::renderer::RendererRegistry::instance().default_renderer(10);
+        QImage tile(layout.frame_width, layout.frame_height, QImage::Format_ARGB32);
+        while ( true )
+        {
+            int cell = next_cell++;
+            if ( cell >= cell_count )
+                return;
+
+            comp->render_image(layout.first_frame + (first_cell + cell) * layout.frame_step, tile, renderer.get());
+
+            qsizetype x = (cell % layout.columns) * layout.frame_width;
+            qsizetype y = (cell / layout.columns) * layout.frame_height;
+            for ( int row = 0; row < layout.frame_height; row++ )
+                std::memcpy(sheet_data + (y + row) * sheet_stride + x * 4, tile.constScanLine(row), layout.frame_width * 4);
+        }
+    };
+
+    threads = qMin(threads, cell_count);
+    if ( threads <= 1 )
+    {
+        work();
+        return;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for ( int i = 0; i < threads; i++ )
+        pool.start(work);
+    pool.waitForDone();
+}
+
+/**
+ * \brief File name for sheets after the first one, eg: `sheet.png` -> `sheet_1.png`
+ */
+QString sheet_filename(const QString& filename, int index)
+{
+    QFileInfo info(filename);
+    QString name = info.completeBaseName() + "_" + QString::number(index);
+    if ( !info.suffix().isEmpty() )
+        name += "." + info.suffix();
+    return info.dir().filePath(name);
+}
+
+} // namespace
 
 
 QStringList glaxnimate::io::raster::SpritesheetFormat::extensions(Direction) const
@@ -33,12 +111,13 @@ std::unique_ptr<glaxnimate::settings::SettingsGroup> glaxnimate::io::raster::Spr
         glaxnimate::settings::Setting("frame_height", i18n("Frame Height"), i18n("Height of each frame"), int(comp->height.get()), 1, 999'999),
         glaxnimate::settings::Setting("columns", i18n("Columns"), i18n("Number of columns in the sheet"), std::ceil(math::sqrt(frames)), 1, 64),
         glaxnimate::settings::Setting("frame_step", i18n("Time Step"), i18n("By how much each rendered frame should increase time (in frames)"), 1, 1, 16),
+        glaxnimate::settings::Setting("threads", i18n("Threads"), i18n("Number of frames rendered in parallel, 0 to use all available cores"), 0, 0, 256),
+        glaxnimate::settings::Setting("max_memory", i18n("Sheet Memory Limit"), i18n("If not 0, the maximum size in MiB of each sheet. Frames that don't fit are saved in additional files"), 0, 0, 999'999),
     });
 }
 
 bool glaxnimate::io::raster::SpritesheetFormat::on_save(QIODevice& file, const QString& filename, model::Composition* comp, const QVariantMap& setting_values)
 {
-    Q_UNUSED(filename);
 
     int frame_w = setting_values["frame_width"].toInt();
     int frame_h = setting_values["frame_height"].toInt();
@@ -50,37 +129,69 @@ bool glaxnimate::io::raster::SpritesheetFormat::on_save(QIODevice& file, const Q
 
     int first_frame = comp->animation->first_frame.get();
     int last_frame = comp->animation->last_frame.get();
-    int frames = (last_frame - first_frame) / frame_step;
+    int frames = qCeil(float(last_frame - first_frame) / frame_step);
+    if ( frames <= 0 )
+        return false;
     int rows = qCeil(float(frames) / columns);
 
-    qreal scale_x = qreal(frame_w) / comp->width.get();
-    qreal scale_y = qreal(frame_h) / comp->height.get();
+    qint64 row_bytes = qint64(frame_w) * frame_h * columns * 4;
+    qint64 max_memory = setting_values["max_memory"].toLongLong() * 1024 * 1024;
+    int sheet_rows = rows;
+    if ( max_memory > 0 )
+        sheet_rows = qBound<qint64>(1, max_memory / row_bytes, rows);
+    int sheet_count = qCeil(float(rows) / sheet_rows);
+
+    if ( sheet_count > 1 && filename.isEmpty() )
+    {
+        error(i18n("The frames don't fit in a single sheet and there is no file name to save the others"));
+        return false;
+    }
+
+    int threads = setting_values["threads"].toInt();
+    if ( threads <= 0 )
+        threads = QThread::idealThreadCount();
 
-    QImage bmp(frame_w * columns, frame_h * rows, QImage::Format_ARGB32);
-    bmp.fill(Qt::transparent);
+    SheetLayout layout{frame_w, frame_h, columns, first_frame, frame_step};
+    int cells_per_sheet = sheet_rows * columns;
 
-    auto renderer = renderer::RendererRegistry::instance().default_renderer(10);
-    renderer->set_image_surface(&bmp);
-    renderer->render_start();
-    for ( int i = first_frame; i <= last_frame; i += frame_step )
+    for ( int sheet_index = 0; sheet_index < sheet_count; sheet_index++ )
     {
-        renderer->layer_start();
-        renderer->scale(scale_x, scale_y);
-        qreal x = (i % columns) * frame_w;
-        qreal y = (i / columns) * frame_h;
-        renderer->translate(x, y);
-        renderer->clip_rect(QRectF(x, y, frame_w, frame_h));
-        comp->paint(renderer.get(), i, model::VisualNode::Render);
-        renderer->layer_end();
+        int first_cell = sheet_index * cells_per_sheet;
+        int cell_count = qMin(cells_per_sheet, frames - first_cell);
+
+        QImage bmp(frame_w * columns, frame_h * qCeil(float(cell_count) / columns), QImage::Format_ARGB32);
+        bmp.fill(Qt::transparent);
+        render_sheet(comp, bmp, layout, first_cell, cell_count, threads);
+
+        if ( sheet_index == 0 )
+        {
+            if ( !write_sheet(bmp, &file, {}) )
+                return false;
+        }
+        else
+        {
+            QString sheet_name = sheet_filename(filename, sheet_index);
+            QFile sheet_file(sheet_name);
+            if ( !sheet_file.open(QIODevice::WriteOnly) )
+            {
+                error(i18n("Could not open %1 for writing", sheet_name));
+                return false;
+            }
+            if ( !write_sheet(bmp, &sheet_file, QFileInfo(sheet_name).suffix().toLatin1()) )
+                return false;
+        }
     }
-    renderer->render_end();
 
-    QImageWriter writer(&file, {});
+    return true;
+}
+
+bool glaxnimate::io::raster::SpritesheetFormat::write_sheet(const QImage& image, QIODevice* device, const QByteArray& format)
+{
+    QImageWriter writer(device, format);
     writer.setOptimizedWrite(true);
-    if ( writer.write(bmp) )
+    if ( writer.write(image) )
         return true;
 
     error(writer.errorString());
     return false;
 }
-
@@ -32,6 +32,9 @@ public:
 protected:
     bool on_save(QIODevice & file, const QString & filename, model::Composition* comp, const QVariantMap & setting_values) override;
 
+private:
+    bool write_sheet(const QImage& image, QIODevice* device, const QByteArray& format);
+
 };
 
 
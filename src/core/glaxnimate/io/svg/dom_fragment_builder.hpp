@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <QDomDocument>
+#include <QXmlStreamReader>
+
+namespace glaxnimate::io::svg::detail {
+
+/**
+ * \brief Builds DOM elements out of the tokens of a QXmlStreamReader
+ *
+ * Used to only materialize the parts of a file that need a DOM,
+ * the resulting elements look the same as the ones QDomDocument would create
+ * when loading with namespace processing.
+ */
+class DomFragmentBuilder
+{
+public:
+    /**
+     * \param dom       Document used to create the nodes
+     * \param parent    If not null, top-level elements are appended to it
+     */
+    explicit DomFragmentBuilder(QDomDocument& dom, QDomNode parent = {})
+        : dom(dom), parent(std::move(parent))
+    {}
+
+    /**
+     * \brief Creates an element for the current start element of \p reader, without children
+     */
+    static QDomElement create_element(QDomDocument& dom, const QXmlStreamReader& reader)
+    {
+        QDomElement element = dom.createElementNS(reader.namespaceUri().toString(), reader.qualifiedName().toString());
+        for ( const auto& attr : reader.attributes() )
+            element.setAttributeNS(attr.namespaceUri().toString(), attr.qualifiedName().toString(), attr.value().toString());
+        return element;
+    }
+
+    /**
+     * \brief Opens an element for the current start element of \p reader
+     *
+     * Further nodes will be added to it until the matching end_element()
+     */
+    QDomElement start_element(const QXmlStreamReader& reader)
+    {
+        QDomElement element = create_element(dom, reader);
+        if ( !open.empty() )
+            open.back().appendChild(element);
+        else if ( !parent.isNull() )
+            parent.appendChild(element);
+        open.push_back(element);
+        return element;
+    }
+
+    /**
+     * \brief Closes the innermost open element and returns it
+     */
+    QDomElement end_element()
+    {
+        if ( open.empty() )
+            return {};
+        QDomElement element = open.back();
+        open.pop_back();
+        return element;
+    }
+
+    /**
+     * \brief Adds the current character data of \p reader to the open element
+     *
+     * Like QDomDocument, it skips text nodes that only contain spaces
+     */
+    void characters(const QXmlStreamReader& reader)
+    {
+        if ( open.empty() )
+            return;
+
+        if ( reader.isCDATA() )
+            open.back().appendChild(dom.createCDATASection(reader.text().toString()));
+        else if ( !reader.isWhitespace() )
+            open.back().appendChild(dom.createTextNode(reader.text().toString()));
+    }
+
+    /**
+     * \brief Whether there is an element being built
+     */
+    bool active() const
+    {
+        return !open.empty();
+    }
+
+private:
+    QDomDocument& dom;
+    QDomNode parent;
+    std::vector<QDomElement> open;
+};
+
+} // namespace glaxnimate::io::svg::detail
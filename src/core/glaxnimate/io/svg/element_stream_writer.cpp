@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "glaxnimate/io/svg/element_stream_writer.hpp"
+
+#include <vector>
+#include <algorithm>
+
+struct glaxnimate::io::svg::detail::StreamNode
+{
+    /// Tag name or text contents for text nodes
+    QString name;
+    bool text = false;
+    std::vector<std::pair<QString, QString>> attributes;
+    /// Children that haven't been written yet
+    std::vector<std::shared_ptr<StreamNode>> children;
+    StreamNode* parent = nullptr;
+    /// Whether the start tag has been written
+    bool started = false;
+    /// Whether the end tag has been written
+    bool finished = false;
+};
+
+void glaxnimate::io::svg::detail::StreamElement::set_attribute(const QString& name, const QString& value)
+{
+    if ( !node || node->started || node->text )
+        return;
+
+    for ( auto& attr : node->attributes )
+    {
+        if ( attr.first == name )
+        {
+            attr.second = value;
+            return;
+        }
+    }
+
+    node->attributes.emplace_back(name, value);
+}
+
+glaxnimate::io::svg::detail::StreamElement glaxnimate::io::svg::detail::StreamElement::append_child(const QString& tag)
+{
+    if ( !node )
+        return {};
+    return writer->append_child(node.get(), tag, ElementStreamWriter::NodeType::Element);
+}
+
+glaxnimate::io::svg::detail::StreamElement glaxnimate::io::svg::detail::StreamElement::append_leaf(const QString& tag)
+{
+    if ( !node )
+        return {};
+    return writer->append_child(node.get(), tag, ElementStreamWriter::NodeType::Leaf);
+}
+
+void glaxnimate::io::svg::detail::StreamElement::append_text(const QString& text)
+{
+    if ( node )
+        writer->append_child(node.get(), text, ElementStreamWriter::NodeType::Text);
+}
+
+glaxnimate::io::svg::detail::StreamElement glaxnimate::io::svg::detail::StreamElement::wrap(const QString& tag)
+{
+    if ( !node )
+        return {};
+    return writer->wrap(node, tag);
+}
+
+glaxnimate::io::svg::detail::ElementStreamWriter::ElementStreamWriter(QIODevice* device, bool indent)
+    : device(device), root(std::make_shared<StreamNode>())
+{
+    buffer.open(QIODevice::WriteOnly);
+    writer.setDevice(&buffer);
+    writer.setAutoFormatting(indent);
+    writer.setAutoFormattingIndent(4);
+    root->started = true;
+}
+
+glaxnimate::io::svg::detail::ElementStreamWriter::~ElementStreamWriter() = default;
+
+glaxnimate::io::svg::detail::StreamElement glaxnimate::io::svg::detail::ElementStreamWriter::document()
+{
+    return {this, root};
+}
+
+void glaxnimate::io::svg::detail::ElementStreamWriter::close()
+{
+    if ( closed )
+        return;
+
+    flush_children(root.get(), root->children.size());
+    writer.writeEndDocument();
+    flush_output(1);
+    closed = true;
+}
+
+glaxnimate::io::svg::detail::StreamElement glaxnimate::io::svg::detail::ElementStreamWriter::append_child(
+    StreamNode* parent, const QString& name, NodeType type)
+{
+    if ( closed || parent->finished || parent->text )
+        return {};
+
+    if ( type == NodeType::Element )
+        start(parent);
+
+    // Elements are written in order so the previous siblings are complete
+    if ( parent->started )
+        flush_children(parent, parent->children.size());
+
+    flush_output(chunk_size);
+
+    auto node = std::make_shared<StreamNode>();
+    node->name = name;
+    node->text = type == NodeType::Text;
+    node->parent = parent;
+    parent->children.push_back(node);
+    return {this, node};
+}
+
+glaxnimate::io::svg::detail::StreamElement glaxnimate::io::svg::detail::ElementStreamWriter::wrap(
+    const std::shared_ptr<StreamNode>& node, const QString& tag)
+{
+    StreamNode* parent = node->parent;
+    if ( closed || node->started || node->text || !parent )
+        return {};
+
+    auto it = std::find(parent->children.begin(), parent->children.end(), node);
+    if ( it == parent->children.end() )
+        return {};
+
+    auto wrapper = std::make_shared<StreamNode>();
+    wrapper->name = tag;
+    wrapper->parent = parent;
+    wrapper->children.push_back(node);
+    node->parent = wrapper.get();
+    *it = wrapper;
+    return {this, wrapper};
+}
+
+void glaxnimate::io::svg::detail::ElementStreamWriter::start(StreamNode* node)
+{
+    if ( node->started )
+        return;
+
+    StreamNode* parent = node->parent;
+    start(parent);
+
+    // Siblings before this node are complete, the ones after it are leaves
+    // added to a wrapper and need to stay after it
+    auto it = std::find_if(parent->children.begin(), parent->children.end(), [node](const auto& p){ return p.get() == node; });
+    flush_children(parent, it - parent->children.begin());
+
+    writer.writeStartElement(node->name);
+    for ( const auto& attr : node->attributes )
+        writer.writeAttribute(attr.first, attr.second);
+    node->attributes.clear();
+    node->started = true;
+}
+
+void glaxnimate::io::svg::detail::ElementStreamWriter::write(StreamNode* node)
+{
+    if ( node->text )
+    {
+        writer.writeCharacters(node->name);
+        node->finished = true;
+        return;
+    }
+
+    if ( !node->started )
+    {
+        writer.writeStartElement(node->name);
+        for ( const auto& attr : node->attributes )
+            writer.writeAttribute(attr.first, attr.second);
+        node->attributes.clear();
+        node->started = true;
+    }
+
+    flush_children(node, node->children.size());
+    writer.writeEndElement();
+    node->finished = true;
+}
+
+void glaxnimate::io::svg::detail::ElementStreamWriter::flush_children(StreamNode* node, std::size_t count)
+{
+    count = std::min(count, node->children.size());
+    for ( std::size_t i = 0; i < count; i++ )
+        write(node->children[i].get());
+    node->children.erase(node->children.begin(), node->children.begin() + count);
+}
+
+void glaxnimate::io::svg::detail::ElementStreamWriter::flush_output(qint64 min_size)
+{
+    if ( buffer.size() < min_size )
+        return;
+
+    device->write(buffer.data());
+    buffer.buffer().clear();
+    buffer.seek(0);
+}
@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <QBuffer>
+#include <QXmlStreamWriter>
+
+namespace glaxnimate::io::svg::detail {
+
+class ElementStreamWriter;
+struct StreamNode;
+
+/**
+ * \brief Handle to an element created by ElementStreamWriter
+ *
+ * Attributes can be changed until the start tag has been written,
+ * which happens once the element gets a child that isn't a leaf
+ * or when one of its ancestors gets a new child.
+ */
+class StreamElement
+{
+public:
+    StreamElement() = default;
+
+    bool isNull() const { return !node; }
+
+    /**
+     * \brief Sets an attribute, has no effect once the start tag has been written
+     */
+    void set_attribute(const QString& name, const QString& value);
+
+    /**
+     * \brief Appends a child element, previous children are considered complete
+     *
+     * The start tag of this element is written so its attributes can no longer change.
+     */
+    StreamElement append_child(const QString& tag);
+
+    /**
+     * \brief Appends a child element that won't have children of its own
+     *
+     * Unlike append_child(), this element can still get attributes afterwards.
+     */
+    StreamElement append_leaf(const QString& tag);
+
+    /**
+     * \brief Appends a text node, like append_leaf() it doesn't write the start tag
+     */
+    void append_text(const QString& text);
+
+    /**
+     * \brief Moves this element into a new element that takes its place in the tree
+     * \returns The new parent element
+     */
+    StreamElement wrap(const QString& tag);
+
+private:
+    StreamElement(ElementStreamWriter* writer, std::shared_ptr<StreamNode> node)
+        : writer(writer), node(std::move(node))
+    {}
+
+    ElementStreamWriter* writer = nullptr;
+    std::shared_ptr<StreamNode> node;
+    friend class ElementStreamWriter;
+};
+
+/**
+ * \brief Writes an XML tree to a device while it's being built
+ *
+ * Elements are created in document order, adding a child to an element
+ * marks its previous children as complete so they can be written out.
+ * Only the innermost open elements (and the small leaf elements attached to them)
+ * are kept in memory.
+ *
+ * Output is passed on to the device in chunks, which keeps compressed
+ * streams from having to process every single token.
+ */
+class ElementStreamWriter
+{
+public:
+    ElementStreamWriter(QIODevice* device, bool indent);
+    ~ElementStreamWriter();
+
+    /**
+     * \brief Virtual node containing the document element
+     */
+    StreamElement document();
+
+    /**
+     * \brief Writes all the remaining elements, no more elements can be added after this
+     */
+    void close();
+
+private:
+    enum class NodeType
+    {
+        Element,
+        Leaf,
+        Text,
+    };
+
+    StreamElement append_child(StreamNode* parent, const QString& name, NodeType type);
+    StreamElement wrap(const std::shared_ptr<StreamNode>& node, const QString& tag);
+
+    void start(StreamNode* node);
+    void write(StreamNode* node);
+    void flush_children(StreamNode* node, std::size_t count);
+    void flush_output(qint64 min_size);
+
+    static constexpr qint64 chunk_size = 64 * 1024;
+
+    QIODevice* device;
+    QBuffer buffer;
+    QXmlStreamWriter writer;
+    std::shared_ptr<StreamNode> root;
+    bool closed = false;
+    friend class StreamElement;
+};
+
+} // namespace glaxnimate::io::svg::detail
@@ -67,18 +67,18 @@ std::unique_ptr<glaxnimate::settings::SettingsGroup> glaxnimate::io::svg::SvgFor
 
 bool glaxnimate::io::svg::SvgFormat::on_save(QIODevice& file, const QString&, model::Composition* comp, const QVariantMap& options)
 {
-    SvgRenderer rend(SMIL, CssFontType(options["font_type"].toInt()));
+    SvgRenderer rend(&file, SMIL, CssFontType(options["font_type"].toInt()));
     rend.write_main(comp, comp->document()->current_time());
-    rend.write(&file, true);
+    rend.close();
     return true;
 }
 
 bool glaxnimate::io::svg::SvgFormat::on_save_static(QIODevice &file, const QString &, model::Composition *comp, model::FrameTime time, const QVariantMap &)
 {
     // TODO settings?
-    io::svg::SvgRenderer rend(io::svg::NotAnimated, io::svg::CssFontType::FontFace);
+    io::svg::SvgRenderer rend(&file, io::svg::NotAnimated, io::svg::CssFontType::FontFace);
     rend.write_main(comp, time);
-    rend.write(&file, true);
+    rend.close();
     return true;
 }
 
@@ -5,8 +5,12 @@
  */
 
 #include "glaxnimate/io/svg/svg_parser.hpp"
+
+#include <QBuffer>
+
 #include "glaxnimate/io/svg/svg_parser_private.hpp"
 #include "glaxnimate/io/svg/enum_map.hpp"
+#include "glaxnimate/io/svg/dom_fragment_builder.hpp"
 
 using namespace glaxnimate::io::svg::detail;
 
@@ -26,9 +30,50 @@ public:
         default_asset_path(default_asset_path)
     {}
 
+    /**
+     * \brief Reads the document, building a full DOM only if it has SMIL animations
+     *
+     * Animations can target any element from anywhere in the file so they
+     * need the DOM, otherwise the model is built while streaming the file
+     * and only the elements that are referenced by others are kept around.
+     * \throws SvgParseError on error
+     */
+    void open(QIODevice* device)
+    {
+        if ( device->isSequential() )
+        {
+            // The file is read twice, keep the data around for the second pass
+            buffer.setData(device->readAll());
+            buffer.open(QIODevice::ReadOnly);
+            device = &buffer;
+        }
+
+        qint64 start = device->pos();
+        bool animated = prescan(device);
+        device->seek(start);
+
+        if ( animated )
+        {
+            dom = QDomDocument();
+            referenced_ids.clear();
+            load(device);
+            return;
+        }
+
+        stream = std::make_unique<QXmlStreamReader>(device);
+        // Move to the root element
+        stream->readNextStartElement();
+    }
+
 protected:
     void on_parse_prepare(const QDomElement&) override
     {
+        if ( stream )
+        {
+            to_process = stream_shape_count;
+            return;
+        }
+
         for ( const auto& p : shape_parsers )
             to_process += dom.elementsByTagName(p.first).count();
     }
@@ -104,7 +149,12 @@ protected:
         Style default_style(Style::Map{
             {"fill", "black"},
         });
-        parse_children({svg, &parent_layer->shapes, parse_style(svg, default_style), false});
+        if ( stream )
+            stream_element = svg;
+        parse_group_children({svg, &parent_layer->shapes, parse_style(svg, default_style), false});
+        if ( stream )
+            throw_if_error(*stream);
+        parse_pending();
 
         main->name.set(
             attr(svg, "sodipodi", "docname", "")
@@ -120,6 +170,254 @@ protected:
     }
 
 private:
+    /**
+     * \brief Element whose children haven't been read from the stream yet
+     */
+    QDomElement stream_element;
+
+    struct PendingShape
+    {
+        QDomElement element;
+        model::ShapeListProperty* shape_parent;
+        Style parent_style;
+        bool in_group;
+        // Position in shape_parent
+        int index;
+    };
+
+    /**
+     * \brief Reads the whole file once without building a DOM
+     *
+     * Styles, gradients and metadata are needed before any shape is parsed,
+     * so they are added to \p dom under an element with the root attributes.
+     * It also collects the ids referenced by `use`, masks and clip paths.
+     *
+     * \returns \b true if the file contains SMIL animations
+     */
+    bool prescan(QIODevice* device)
+    {
+        QXmlStreamReader reader(device);
+        QDomElement root;
+        std::unique_ptr<DomFragmentBuilder> builder;
+        int depth = 0;
+        std::vector<QString> references;
+
+        while ( !reader.atEnd() )
+        {
+            switch ( reader.readNext() )
+            {
+                case QXmlStreamReader::StartElement:
+                {
+                    depth++;
+                    QString tag = reader.qualifiedName().toString();
+                    if ( tag.startsWith("animate") )
+                        return true;
+
+                    if ( shape_parsers.count(tag) )
+                        stream_shape_count++;
+
+                    collect_references(reader, references);
+
+                    if ( depth == 1 )
+                    {
+                        root = DomFragmentBuilder::create_element(dom, reader);
+                        dom.appendChild(root);
+                        builder = std::make_unique<DomFragmentBuilder>(dom, root);
+                    }
+                    else if ( builder->active() || tag == "style" || tag == "link" ||
+                              tag == "linearGradient" || tag == "radialGradient" ||
+                              (tag == "metadata" && depth == 2) )
+                    {
+                        builder->start_element(reader);
+                    }
+                    break;
+                }
+                case QXmlStreamReader::EndElement:
+                    depth--;
+                    if ( builder )
+                        builder->end_element();
+                    break;
+                case QXmlStreamReader::Characters:
+                    if ( builder )
+                        builder->characters(reader);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        throw_if_error(reader);
+
+        referenced_ids.insert(references.begin(), references.end());
+        return false;
+    }
+
+    /**
+     * \brief Reports malformed XML found by \p reader the same way as the DOM parser
+     * \throws SvgParseError
+     */
+    static void throw_if_error(const QXmlStreamReader& reader)
+    {
+        if ( reader.hasError() )
+        {
+            SvgParseError err;
+            err.message = reader.errorString();
+            err.line = reader.lineNumber();
+            err.column = reader.columnNumber();
+            throw err;
+        }
+    }
+
+    /**
+     * \brief Adds the ids the current element of \p reader needs from element_by_id()
+     */
+    void collect_references(const QXmlStreamReader& reader, std::vector<QString>& references)
+    {
+        auto attrs = reader.attributes();
+        if ( reader.qualifiedName() == QLatin1String("use") )
+        {
+            QString href = attrs.value(xmlns.at("xlink"), "href").toString();
+            if ( href.startsWith('#') )
+                references.push_back(href.mid(1));
+        }
+
+        for ( const char* name : {"clip-path", "mask"} )
+        {
+            if ( attrs.hasAttribute(name) )
+            {
+                auto match = url_re.match(attrs.value(name).toString());
+                if ( match.hasMatch() )
+                    references.push_back(match.captured(1).mid(1));
+            }
+        }
+    }
+
+    void parse_group_children(const ParseFuncArgs& args)
+    {
+        // Groups read from the stream have no children in the DOM
+        if ( stream && args.element == stream_element )
+        {
+            while ( stream->readNextStartElement() )
+                stream_shape(args);
+        }
+        else
+        {
+            parse_children(args);
+        }
+    }
+
+    /**
+     * \brief Parses the current element of the stream as a child of \p parent
+     */
+    void stream_shape(const ParseFuncArgs& parent)
+    {
+        QString tag = stream->qualifiedName().toString();
+        auto attrs = stream->attributes();
+        bool referenced = referenced_ids.count(attrs.value("id").toString());
+        bool masked = attrs.hasAttribute("clip-path") || attrs.hasAttribute("mask");
+
+        if ( tag == "g" && !referenced && !masked )
+        {
+            // Only the attributes are needed, the children are parsed as they are read
+            QDomElement element = DomFragmentBuilder::create_element(dom, *stream);
+            stream_element = element;
+            parse_shape({element, parent.shape_parent, parent.parent_style, parent.in_group});
+        }
+        else if ( referenced || masked || shape_parsers.count(tag) )
+        {
+            std::vector<QString> references;
+            QDomElement element = read_fragment(references);
+
+            // Forward reference, wait until the rest of the file has been read
+            for ( const auto& id : references )
+            {
+                if ( !map_ids.count(id) )
+                {
+                    pending.push_back({element, parent.shape_parent, parent.parent_style, parent.in_group, parent.shape_parent->size()});
+                    return;
+                }
+            }
+
+            parse_shape({element, parent.shape_parent, parent.parent_style, parent.in_group});
+        }
+        else
+        {
+            skip_element();
+        }
+    }
+
+    /**
+     * \brief Reads the current element of the stream and its contents into a DOM element
+     *
+     * Referenced elements found along the way are made available to element_by_id()
+     */
+    QDomElement read_fragment(std::vector<QString>& references)
+    {
+        DomFragmentBuilder builder(dom);
+        QDomElement root;
+
+        do
+        {
+            if ( stream->isStartElement() )
+            {
+                collect_references(*stream, references);
+                QDomElement element = builder.start_element(*stream);
+                if ( root.isNull() )
+                    root = element;
+            }
+            else if ( stream->isEndElement() )
+            {
+                QDomElement element = builder.end_element();
+                QString id = element.attribute("id");
+                if ( !id.isEmpty() && referenced_ids.count(id) )
+                    map_ids[id] = element;
+            }
+            else if ( stream->isCharacters() )
+            {
+                builder.characters(*stream);
+            }
+        }
+        while ( builder.active() && stream->readNext() != QXmlStreamReader::Invalid );
+
+        return root;
+    }
+
+    /**
+     * \brief Skips the current element of the stream, keeping referenced descendants
+     */
+    void skip_element()
+    {
+        while ( stream->readNextStartElement() )
+        {
+            if ( referenced_ids.count(stream->attributes().value("id").toString()) )
+            {
+                std::vector<QString> references;
+                read_fragment(references);
+            }
+            else
+            {
+                skip_element();
+            }
+        }
+    }
+
+    /**
+     * \brief Parses shapes that had forward references now that all the file has been read
+     */
+    void parse_pending()
+    {
+        // Backwards so the stored indices are still valid when inserting
+        for ( auto it = pending.rbegin(); it != pending.rend(); ++it )
+        {
+            auto holder = std::make_unique<model::Group>(document);
+            parse_shape({it->element, &holder->shapes, it->parent_style, it->in_group});
+            int index = it->index;
+            while ( holder->shapes.size() )
+                it->shape_parent->insert(holder->shapes.remove(0), index++);
+        }
+        pending.clear();
+    }
+
     void parse_css()
     {
         CssParser parser(css_blocks);
@@ -986,7 +1284,7 @@ private:
         set_name(g_node, args.element);
         // Avoid doubling opacity values
         style.map.erase("opacity");
-        parse_children(args);
+        parse_group_children(args);
         parse_transform(args.element, g_node, transform);
     }
 
@@ -1473,6 +1771,12 @@ private:
     std::vector<CssStyleBlock> css_blocks;
     QDir default_asset_path;
 
+    QBuffer buffer;
+    std::unique_ptr<QXmlStreamReader> stream;
+    int stream_shape_count = 0;
+    std::unordered_set<QString> referenced_ids;
+    std::vector<PendingShape> pending;
+
     static const std::map<QString, void (Private::*)(const ParseFuncArgs&)> shape_parsers;
     static const QRegularExpression transform_re;
     static const QRegularExpression url_re;
@@ -1510,7 +1814,7 @@ glaxnimate::io::svg::SvgParser::SvgParser(
 )
     : d(std::make_unique<Private>(document, on_warning, io, forced_size, default_time, group_mode, default_asset_path))
 {
-    d->load(device);
+    d->open(device);
 }
 
 glaxnimate::io::svg::SvgParser::~SvgParser()
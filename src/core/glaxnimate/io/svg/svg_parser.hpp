@@ -50,7 +50,13 @@ public:
     );
     ~SvgParser();
 
+    /**
+     * \throws SvgParseError if the XML turns out to be malformed while streaming
+     */
     void parse_to_document();
+    /**
+     * \throws SvgParseError if the XML turns out to be malformed while streaming
+     */
     io::mime::DeserializedData parse_to_objects();
 
     class Private;
@@ -6,6 +6,8 @@
 
 #include "glaxnimate/io/svg/svg_renderer.hpp"
 
+#include <QBuffer>
+
 #include "glaxnimate/model/document.hpp"
 #include "glaxnimate/model/shapes/composable/group.hpp"
 #include "glaxnimate/model/shapes/composable/layer.hpp"
@@ -23,6 +25,7 @@
 #include "glaxnimate/math/math.hpp"
 
 #include "glaxnimate/io/svg/detail.hpp"
+#include "glaxnimate/io/svg/element_stream_writer.hpp"
 #include "glaxnimate/io/svg/font_weight.hpp"
 #include "glaxnimate/io/utils.hpp"
 #include "glaxnimate/io/svg/enum_map.hpp"
@@ -45,7 +48,7 @@ public:
             animated = NotAnimated;
 
         at_start = false;
-        defs = element(svg, "defs");
+        auto defs = element(svg, "defs");
         for ( const auto& color : comp->document()->assets()->colors->values )
             write_named_color(defs, color.get(), t);
         for ( const auto& color : comp->document()->assets()->gradient_colors->values )
@@ -54,11 +57,11 @@ public:
             write_gradient(defs, gradient.get(), t);
 
         auto view = element(svg, "sodipodi:namedview");
-        view.setAttribute("inkscape:pagecheckerboard", "true");
-        view.setAttribute("borderlayer", "true");
-        view.setAttribute("bordercolor", "#666666");
-        view.setAttribute("pagecolor", "#ffffff");
-        view.setAttribute("inkscape:document-units", "px");
+        view.set_attribute("inkscape:pagecheckerboard", "true");
+        view.set_attribute("borderlayer", "true");
+        view.set_attribute("bordercolor", "#666666");
+        view.set_attribute("pagecolor", "#ffffff");
+        view.set_attribute("inkscape:document-units", "px");
 
         add_fonts(comp->document());
 
@@ -69,26 +72,26 @@ public:
     {
         auto rdf = element(element(svg, "metadata"), "rdf:RDF");
         auto work = element(rdf, "cc:Work");
-        element(work, "dc:format").appendChild(dom.createTextNode("image/svg+xml"));
+        element(work, "dc:format").append_text("image/svg+xml");
         QString dc_type = animated ? "MovingImage" : "StillImage";
-        element(work, "dc:type").setAttribute("rdf:resource", "http://purl.org/dc/dcmitype/" + dc_type);
-        element(work, "dc:title").appendChild(dom.createTextNode(comp->name.get()));
+        element(work, "dc:type").set_attribute("rdf:resource", "http://purl.org/dc/dcmitype/" + dc_type);
+        element(work, "dc:title").append_text(comp->name.get());
         auto document = comp->document();
 
         if ( document->info().empty() )
             return;
 
         if ( !document->info().author.isEmpty() )
-            element(element(element(work, "dc:creator"), "cc:Agent"), "dc:title").appendChild(dom.createTextNode(document->info().author));
+            element(element(element(work, "dc:creator"), "cc:Agent"), "dc:title").append_text(document->info().author);
 
         if ( !document->info().description.isEmpty() )
-            element(work, "dc:description").appendChild(dom.createTextNode(document->info().description));
+            element(work, "dc:description").append_text(document->info().description);
 
         if ( !document->info().keywords.empty() )
         {
             auto bag = element(element(work, "dc:subject"), "rdf:Bag");
             for ( const auto& kw: document->info().keywords )
-                element(bag, "rdf:li").appendChild(dom.createTextNode(kw));
+                element(bag, "rdf:li").append_text(kw);
         }
     }
 
@@ -119,10 +122,10 @@ public:
             if ( type == CssFontType::Link )
             {
                 auto link = element(svg, "link");
-                link.setAttribute("xmlns", "http://www.w3.org/1999/xhtml");
-                link.setAttribute("rel", "stylesheet");
-                link.setAttribute("href", font->css_url.get());
-                link.setAttribute("type", "text/css");
+                link.set_attribute("xmlns", "http://www.w3.org/1999/xhtml");
+                link.set_attribute("rel", "stylesheet");
+                link.set_attribute("href", font->css_url.get());
+                link.set_attribute("type", "text/css");
             }
             else if ( type == CssFontType::FontFace )
             {
@@ -148,31 +151,29 @@ public:
         }
 
         if ( !css.isEmpty() )
-            element(svg, "style").appendChild(dom.createTextNode(css));
+            element(svg, "style").append_text(css);
     }
 
-    QDomElement element(QDomNode parent, const char* tag)
+    StreamElement element(StreamElement parent, const char* tag)
     {
-        QDomElement e = dom.createElement(tag);
-        parent.appendChild(e);
-        return e;
+        return parent.append_child(tag);
     }
 
-    void write_composition(QDomElement& parent, model::Composition* comp, model::FrameTime t)
+    void write_composition(StreamElement& parent, model::Composition* comp, model::FrameTime t)
     {
         for ( const auto& lay : comp->shapes )
             write_shape(parent, lay.get(), false, t);
     }
 
-    void write_visibility_attributes(QDomElement& parent, model::VisualNode* node)
+    void write_visibility_attributes(StreamElement& parent, model::VisualNode* node)
     {
         if ( !node->visible.get() )
-            parent.setAttribute("display", "none");
+            parent.set_attribute("display", "none");
         if ( node->locked.get() )
-            parent.setAttribute("sodipodi:insensitive", "true");
+            parent.set_attribute("sodipodi:insensitive", "true");
     }
 
-    void write_shapes(QDomElement& parent, const model::ShapeListProperty& shapes, bool has_mask, model::FrameTime t)
+    void write_shapes(StreamElement& parent, const model::ShapeListProperty& shapes, bool has_mask, model::FrameTime t)
     {
         if ( shapes.empty() )
             return;
@@ -195,27 +196,59 @@ public:
         return styler->color.get().name();
     }
 
-    QDomElement write_styler_shapes(QDomElement& parent, model::Styler* styler, const Style::Map& style, model::FrameTime t)
+    void write_styler_shapes(StreamElement& parent, model::Styler* styler, const Style::Map& style, model::FrameTime t)
     {
         if ( styler->affected().size() == 1 )
         {
-            write_shape_shape(parent, styler->affected()[0], style, t);
-            write_visibility_attributes(parent, styler);
-            parent.setAttribute("id", id(styler));
-            return parent;
+            write_shape_shape(parent, styler->affected()[0], style, t, styler);
+            return;
         }
 
         auto g = start_group(parent, styler);
         write_style(g, style);
-        write_visibility_attributes(g, styler);
-        g.setAttribute("id", id(styler));
+        write_owner_attributes(g, styler, t);
 
         for ( model::ShapeElement* subshape : styler->affected() )
         {
             write_shape_shape(g, subshape, style, t);
         }
+    }
 
-        return g;
+    /**
+     * \brief Writes the attributes of the node represented by \p element
+     *
+     * Needs to be called before adding children to \p element as their
+     * contents are written out as they are created.
+     * \param owner    Styler or shape drawn by \p element, can be null
+     */
+    void write_owner_attributes(StreamElement& element, model::ShapeElement* owner, model::FrameTime t)
+    {
+        if ( !owner )
+            return;
+
+        write_visibility_attributes(element, owner);
+        element.set_attribute("id", id(owner));
+
+        if ( !animated )
+            return;
+
+        if ( auto stroke = qobject_cast<model::Stroke*>(owner) )
+        {
+            write_styler_attrs(element, stroke, "stroke", t);
+            write_property(element, &stroke->width, "stroke-width", t);
+        }
+        else if ( auto fill = qobject_cast<model::Fill*>(owner) )
+        {
+            write_styler_attrs(element, fill, "fill", t);
+        }
+    }
+
+    StreamElement start_shape(StreamElement& parent, const char* tag, const Style::Map& style, model::ShapeElement* owner, model::FrameTime t)
+    {
+        auto e = element(parent, tag);
+        write_style(e, style);
+        write_owner_attributes(e, owner, t);
+        return e;
     }
 
     QString unlerp_time(model::FrameTime time) const
@@ -319,7 +352,7 @@ public:
         }
 
         void add_dom(
-            QDomElement& element, const char* tag = "animate", const QString& type = {},
+            StreamElement& element, const char* tag = "animate", const QString& type = {},
             const QString& path = {}, bool auto_orient = false
         )
         {
@@ -341,25 +374,25 @@ public:
             QString key_splines_str = key_splines.join("; ");
             for ( const auto& data : attributes )
             {
-                QDomElement animation = parent->element(element, tag);
-                animation.setAttribute("begin", parent->clock(time_start + time_stretch * parent->ip));
-                animation.setAttribute("dur", parent->clock(time_start + time_stretch * parent->op-parent->ip));
-                animation.setAttribute("attributeName", data.attribute);
-                animation.setAttribute("calcMode", "spline");
+                StreamElement animation = element.append_leaf(tag);
+                animation.set_attribute("begin", parent->clock(time_start + time_stretch * parent->ip));
+                animation.set_attribute("dur", parent->clock(time_start + time_stretch * parent->op-parent->ip));
+                animation.set_attribute("attributeName", data.attribute);
+                animation.set_attribute("calcMode", "spline");
                 if ( !path.isEmpty() )
                 {
-                    animation.setAttribute("path", path);
-                    animation.setAttribute("keyPoints", key_points.join("; "));
+                    animation.set_attribute("path", path);
+                    animation.set_attribute("keyPoints", key_points.join("; "));
                     if ( auto_orient )
-                        animation.setAttribute("rotate", "auto");
+                        animation.set_attribute("rotate", "auto");
                 }
-                animation.setAttribute("keyTimes", key_times_str);
-                animation.setAttribute("keySplines", key_splines_str);
-                animation.setAttribute("repeatCount", "indefinite");
+                animation.set_attribute("keyTimes", key_times_str);
+                animation.set_attribute("keySplines", key_splines_str);
+                animation.set_attribute("repeatCount", "indefinite");
                 if ( !type.isEmpty() )
-                    animation.setAttribute("type", type);
+                    animation.set_attribute("type", type);
                 if ( !data.values.isEmpty() )
-                    animation.setAttribute("values", data.values.join("; "));
+                    animation.set_attribute("values", data.values.join("; "));
             }
         }
 
@@ -375,13 +408,13 @@ public:
     };
 
     void write_property(
-        QDomElement& element,
+        StreamElement& element,
         model::AnimatedPropertyBase* property,
         const QString& attr,
         model::FrameTime t
     )
     {
-        element.setAttribute(attr, property->value(t).toString());
+        element.set_attribute(attr, property->value(t).toString());
 
         if ( animated )
         {
@@ -411,7 +444,7 @@ public:
 
     template<class Callback>
     void write_properties(
-        QDomElement& element,
+        StreamElement& element,
         model::FrameTime t,
         std::vector<const model::AnimatedPropertyBase*> properties,
         const std::vector<QString>& attrs,
@@ -424,7 +457,7 @@ public:
         {
             auto vals = callback(j.value_at(t));
             for ( std::size_t i = 0; i != attrs.size(); i++ )
-                element.setAttribute(attrs[i], vals[i]);
+                element.set_attribute(attrs[i], vals[i]);
         }
 
         if ( j.animated() && animated )
@@ -452,10 +485,9 @@ public:
         };
     }
 
-    void write_shape_rect(QDomElement& parent, model::Rect* rect, const Style::Map& style, model::FrameTime t)
+    void write_shape_rect(StreamElement& parent, model::Rect* rect, const Style::Map& style, model::ShapeElement* owner, model::FrameTime t)
     {
-        auto e = element(parent, "rect");
-        write_style(e, style);
+        auto e = start_shape(parent, "rect", style, owner, t);
         write_properties(e, t, {&rect->position, &rect->size}, {"x", "y"},
             [this](const std::vector<QVariant>& values){
                 QPointF c = values[0].toPointF();
@@ -478,10 +510,9 @@ public:
         write_property(e, &rect->rounded, "ry", t);
     }
 
-    void write_shape_ellipse(QDomElement& parent, model::Ellipse* ellipse, const Style::Map& style, model::FrameTime t)
+    void write_shape_ellipse(StreamElement& parent, model::Ellipse* ellipse, const Style::Map& style, model::ShapeElement* owner, model::FrameTime t)
     {
-        auto e = element(parent, "ellipse");
-        write_style(e, style);
+        auto e = start_shape(parent, "ellipse", style, owner, t);
         write_properties(e, t, {&ellipse->position}, {"cx", "cy"}, &Private::callback_point);
         write_properties(e, t, {&ellipse->size}, {"rx", "ry"},
             [this](const std::vector<QVariant>& values){
@@ -494,11 +525,11 @@ public:
         );
     }
 
-    void write_shape_star(QDomElement& parent, model::PolyStar* star, const Style::Map& style, model::FrameTime t)
+    void write_shape_star(StreamElement& parent, model::PolyStar* star, const Style::Map& style, model::ShapeElement* owner, model::FrameTime t)
     {
         model::FrameTime time = star->time();
 
-        auto e = write_bezier(parent, star, style, t);
+        auto e = write_bezier(parent, star, style, owner, t);
 
         if ( star->outer_roundness.animated() || !qFuzzyIsNull(star->outer_roundness.get()) ||
              star->inner_roundness.animated() || !qFuzzyIsNull(star->inner_roundness.get()) )
@@ -521,7 +552,7 @@ public:
         set_attribute(e, "sodipodi:arg2", angle + math::pi / sides);
     }
 
-    void write_shape_text(QDomElement& parent, model::TextShape* text, Style::Map style, model::FrameTime t)
+    void write_shape_text(StreamElement& parent, model::TextShape* text, Style::Map style, model::ShapeElement* owner, model::FrameTime t)
     {
         QFontInfo font_info(text->font->query());
 
@@ -543,53 +574,54 @@ public:
             case QFont::StyleOblique: style["font-style"] = "oblique"; break;
         }
 
-        auto e = element(parent, "text");
-        write_style(e, style);
+        auto e = start_shape(parent, "text", style, owner, t);
         write_properties(e, t, {&text->position}, {"x", "y"}, &Private::callback_point);
 
-        model::Font::CharDataCache cache;
         for ( const auto& line : text->font->layout(text->text.get()) )
         {
             auto tspan = element(e, "tspan");
-            tspan.appendChild(dom.createTextNode(line.text));
+            tspan.append_text(line.text);
             set_attribute(tspan, "sodipodi:role", "line");
 
             write_properties(tspan, t, {&text->position}, {"x", "y"}, [base=line.baseline](const std::vector<QVariant>& values){
                 return callback_point_result(values[0].toPointF() + base);
             });
-            tspan.setAttribute("xml:space", "preserve");
+            tspan.set_attribute("xml:space", "preserve");
         }
     }
 
-    void write_shape_shape(QDomElement& parent, model::ShapeElement* shape, const Style::Map& style, model::FrameTime t)
+    /**
+     * \param owner    If not null, its id and attributes are written on the shape element
+     */
+    void write_shape_shape(StreamElement& parent, model::ShapeElement* shape, const Style::Map& style, model::FrameTime t, model::ShapeElement* owner = nullptr)
     {
         if ( auto rect = qobject_cast<model::Rect*>(shape) )
         {
-            write_shape_rect(parent, rect, style, t);
+            write_shape_rect(parent, rect, style, owner, t);
         }
         else if ( auto ellipse = qobject_cast<model::Ellipse*>(shape) )
         {
-            write_shape_ellipse(parent, ellipse, style, t);
+            write_shape_ellipse(parent, ellipse, style, owner, t);
         }
         else if ( auto star = qobject_cast<model::PolyStar*>(shape) )
         {
-            write_shape_star(parent, star, style, t);
+            write_shape_star(parent, star, style, owner, t);
         }
         else if ( auto text = shape->cast<model::TextShape>() )
         {
-            write_shape_text(parent, text, style, t);
+            write_shape_text(parent, text, style, owner, t);
         }
         else if ( !qobject_cast<model::Styler*>(shape) )
         {
-            write_bezier(parent, shape, style, t);
+            write_bezier(parent, shape, style, owner, t);
         }
     }
 
-    void write_styler_attrs(QDomElement& element, model::Styler* styler, const QString& attr, model::FrameTime t)
+    void write_styler_attrs(StreamElement& element, model::Styler* styler, const QString& attr, model::FrameTime t)
     {
         if ( styler->use.get() )
         {
-            element.setAttribute(attr, "url(#" + non_uuid_ids_map[styler->use.get()] + ")");
+            element.set_attribute(attr, "url(#" + non_uuid_ids_map[styler->use.get()] + ")");
             return;
         }
 
@@ -597,7 +629,7 @@ public:
         write_property(element, &styler->opacity, attr+"-opacity", t);
     }
 
-    void write_composable(model::Composable* comp, QDomElement& e, model::FrameTime t)
+    void write_composable(model::Composable* comp, StreamElement& e, model::FrameTime t)
     {
         transform_to_attr(e, t, comp->transform.get());
         if ( comp->blend_mode.get() != renderer::BlendMode::Normal )
@@ -605,7 +637,7 @@ public:
 
     }
 
-    void write_image(model::Image* img, QDomElement& parent, model::FrameTime t)
+    void write_image(model::Image* img, StreamElement& parent, model::FrameTime t)
     {
         if ( img->image.get() )
         {
@@ -619,7 +651,7 @@ public:
         }
     }
 
-    void write_stroke(model::Stroke* stroke, QDomElement& parent, model::FrameTime t)
+    void write_stroke(model::Stroke* stroke, StreamElement& parent, model::FrameTime t)
     {
         Style::Map style;
         style["fill"] = "none";
@@ -656,15 +688,10 @@ public:
                 break;
         }
         style["stroke-dasharray"] = "none";
-        QDomElement g = write_styler_shapes(parent, stroke, style, t);
-        if ( animated )
-        {
-            write_styler_attrs(g, stroke, "stroke", t);
-            write_property(g, &stroke->width, "stroke-width", t);
-        }
+        write_styler_shapes(parent, stroke, style, t);
     }
 
-    void write_fill(model::Fill* fill, QDomElement& parent, model::FrameTime t)
+    void write_fill(model::Fill* fill, StreamElement& parent, model::FrameTime t)
     {
         Style::Map style;
         if ( !animated )
@@ -673,12 +700,10 @@ public:
             style["fill-opacity"] = format_float(fill->opacity.get());
         }
         style["stroke"] = "none";
-        QDomElement g = write_styler_shapes(parent, fill, style, t);
-        if ( animated )
-            write_styler_attrs(g, fill, "fill", t);
+        write_styler_shapes(parent, fill, style, t);
     }
 
-    void write_precomp_layer(model::PreCompLayer* layer, QDomElement& parent, model::FrameTime t)
+    void write_precomp_layer(model::PreCompLayer* layer, StreamElement& parent, model::FrameTime t)
     {
         auto comp = layer->composition.get();
         if ( comp )
@@ -691,7 +716,7 @@ public:
             timing.push_back(layer->timing.get());
             if ( !layer->unbounded.get() )
             {
-                auto clip = element(defs, "clipPath");
+                auto clip = element(element(parent, "defs"), "clipPath");
                 set_attribute(clip, "id", "clip_" + id(layer));
                 set_attribute(clip, "clipPathUnits", "userSpaceOnUse");
                 auto clip_rect = element(clip, "rect");
@@ -704,7 +729,7 @@ public:
             auto e = start_layer(parent, layer);
             write_composable(layer, e, t);
             write_property(e, &layer->opacity, "opacity", t);
-            write_visibility_attributes(parent, layer);
+            write_visibility_attributes(e, layer);
             time_stretch = layer->timing->stretch.get();
             time_start = layer->timing->start_time.get();
             write_time_range_display(e, layer, comp->animation.get());
@@ -715,9 +740,9 @@ public:
         }
     }
 
-    void write_repeater_vis(QDomElement& element, model::Repeater* repeater, int index, int n_copies)
+    void write_repeater_vis(StreamElement& element, model::Repeater* repeater, int index, int n_copies)
     {
-        element.setAttribute("display", index < repeater->copies.get() ? "block" : "none");
+        element.set_attribute("display", index < repeater->copies.get() ? "block" : "none");
 
         float alpha_lerp = float(index) / (n_copies == 1 ? 1 : n_copies - 1);
         model::JoinAnimatables opacity({&repeater->start_opacity, &repeater->end_opacity}, model::JoinAnimatables::NoValues);
@@ -756,35 +781,34 @@ public:
         }
     }
 
-    void write_repeater(model::Repeater* repeater, QDomElement& parent, bool force_draw, model::FrameTime t)
+    void write_repeater(model::Repeater* repeater, StreamElement& parent, bool force_draw, model::FrameTime t)
     {
         int n_copies = repeater->max_copies();
         if ( n_copies < 1 )
             return;
 
-        QDomElement container = start_group(parent, repeater);
+        StreamElement container = start_group(parent, repeater);
         QString base_id = id(repeater);
         QString prev_clone_id = base_id + "_0";
-        QDomElement og = element(container, "g");
-        og.setAttribute("id", prev_clone_id);
+        StreamElement og = element(container, "g");
+        og.set_attribute("id", prev_clone_id);
+        write_repeater_vis(og, repeater, 0, n_copies);
         for ( const auto& sib : repeater->affected() )
             write_shape(og, sib, force_draw, t);
 
-        write_repeater_vis(og, repeater, 0, n_copies);
-
         for ( int i = 1; i < n_copies; i++ )
         {
             QString clone_id = base_id + "_" + QString::number(i);;
-            QDomElement use = element(container, "use");
-            use.setAttribute("xlink:href", "#" + prev_clone_id);
-            use.setAttribute("id", clone_id);
+            StreamElement use = element(container, "use");
+            use.set_attribute("xlink:href", "#" + prev_clone_id);
+            use.set_attribute("id", clone_id);
             write_repeater_vis(use, repeater, i, n_copies);
             transform_to_attr(use, t, repeater->transform.get());
             prev_clone_id = clone_id;
         }
     }
 
-    void write_shape(QDomElement& parent, model::ShapeElement* shape, bool force_draw, model::FrameTime t)
+    void write_shape(StreamElement& parent, model::ShapeElement* shape, bool force_draw, model::FrameTime t)
     {
         if ( auto grp = qobject_cast<model::Group*>(shape) )
         {
@@ -814,16 +838,13 @@ public:
         }
         else if ( force_draw )
         {
-            write_shape_shape(parent, shape, {}, t);
-            write_visibility_attributes(parent, shape);
-            set_attribute(parent, "id", id(shape));
+            write_shape_shape(parent, shape, {}, t, shape);
         }
     }
 
-    QDomElement write_bezier(QDomElement& parent, model::ShapeElement* shape, const Style::Map& style, model::FrameTime t)
+    StreamElement write_bezier(StreamElement& parent, model::ShapeElement* shape, const Style::Map& style, model::ShapeElement* owner, model::FrameTime t)
     {
-        QDomElement path = element(parent, "path");
-        write_style(path, style);
+        StreamElement path = start_shape(parent, "path", style, owner, t);
         QString d;
         QString nodetypes;
         std::tie(d, nodetypes) = path_data(shape->shapes(t));
@@ -860,12 +881,12 @@ public:
      * \param ancestor      Ancestor layer (to create the <g> for)
      * \param descendant    Descendant layer
      */
-    QDomElement start_layer_recurse_parents(const QDomElement& parent, model::Layer* ancestor, model::Layer* descendant, model::FrameTime t)
+    StreamElement start_layer_recurse_parents(const StreamElement& parent, model::Layer* ancestor, model::Layer* descendant, model::FrameTime t)
     {
-        QDomElement g = element(parent, "g");
-        g.setAttribute("id", id(descendant) + "_" + id(ancestor));
-        g.setAttribute("inkscape:label", i18n("%1 (%2)", descendant->object_name(), ancestor->object_name()));
-        g.setAttribute("inkscape:groupmode", "layer");
+        StreamElement g = element(parent, "g");
+        g.set_attribute("id", id(descendant) + "_" + id(ancestor));
+        g.set_attribute("inkscape:label", i18n("%1 (%2)", descendant->object_name(), ancestor->object_name()));
+        g.set_attribute("inkscape:groupmode", "layer");
         transform_to_attr(g, t, ancestor->transform.get());
         return g;
     }
@@ -876,14 +897,14 @@ public:
      * \param ancestor      Ancestor layer (searched recursively for parents)
      * \param descendant    Descendant layer
      */
-    QDomElement recurse_parents(const QDomElement& parent, model::Layer* ancestor, model::Layer* descendant, model::FrameTime t)
+    StreamElement recurse_parents(const StreamElement& parent, model::Layer* ancestor, model::Layer* descendant, model::FrameTime t)
     {
         if ( !ancestor->parent.get() )
             return start_layer_recurse_parents(parent, ancestor, descendant, t);
         return start_layer_recurse_parents(recurse_parents(parent, ancestor->parent.get(), descendant, t), ancestor, descendant, t);
     }
 
-    void write_time_range_display(QDomElement& parent, model::ShapeElement* layer, model::AnimationContainer* lay_range)
+    void write_time_range_display(StreamElement& parent, model::ShapeElement* layer, model::AnimationContainer* lay_range)
     {
         if ( animated && layer->visible.get() )
         {
@@ -895,12 +916,12 @@ public:
 
             if ( has_start || has_end )
             {
-                QDomElement animation = element(parent, "animate");
-                animation.setAttribute("begin", clock(ip));
-                animation.setAttribute("dur", clock(op-ip));
-                animation.setAttribute("calcMode", "discrete");
-                animation.setAttribute("attributeName", "display");
-                animation.setAttribute("repeatCount", "indefinite");
+                StreamElement animation = parent.append_leaf("animate");
+                animation.set_attribute("begin", clock(ip));
+                animation.set_attribute("dur", clock(op-ip));
+                animation.set_attribute("calcMode", "discrete");
+                animation.set_attribute("attributeName", "display");
+                animation.set_attribute("repeatCount", "indefinite");
                 QString times;
                 QString vals;
 
@@ -922,24 +943,38 @@ public:
                     times += unlerp_time(lay_end) + ";";
                 }
 
-                animation.setAttribute("values", vals);
-                animation.setAttribute("keyTimes", times);
+                animation.set_attribute("values", vals);
+                animation.set_attribute("keyTimes", times);
             }
         }
     }
 
-    void write_group_shape(QDomElement& parent, model::Group* group, model::FrameTime t)
+    void write_group_shape(StreamElement& parent, model::Group* group, model::FrameTime t)
     {
-        QDomElement g;
+        StreamElement g;
         bool has_mask = false;
         if ( auto layer = group->cast<model::Layer>() )
         {
             if ( !layer->render.get() )
                 return;
 
+            // The shared <defs> has already been written, so the mask goes in its own before the layer
+            QString mask_id;
+            if ( layer->mask->has_mask() )
+            {
+                has_mask = true;
+
+                StreamElement clip = element(element(parent, "defs"), "mask");
+                mask_id = "clip_" + id(layer);
+                clip.set_attribute("id", mask_id);
+                clip.set_attribute("mask-type", layer->mask->mask.value() == model::MaskSettings::Luma ? "luminance" : "alpha");
+                if ( layer->shapes.size() > 1 )
+                    write_shape(clip, layer->shapes[0], false, t);
+            }
+
             if ( layer->parent.get() )
             {
-                QDomElement parent_g = recurse_parents(parent, layer->parent.get(), layer, t);
+                StreamElement parent_g = recurse_parents(parent, layer->parent.get(), layer, t);
                 g = start_layer(parent_g, group);
             }
             else
@@ -947,19 +982,8 @@ public:
                 g = start_layer(parent, group);
             }
 
-            if ( layer->mask->has_mask() )
-            {
-                has_mask = true;
-
-                QDomElement clip = element(defs, "mask");
-                QString mask_id = "clip_" + id(layer);
-                clip.setAttribute("id", mask_id);
-                clip.setAttribute("mask-type", layer->mask->mask.value() == model::MaskSettings::Luma ? "luminance" : "alpha");
-                if ( layer->shapes.size() > 1 )
-                    write_shape(clip, layer->shapes[0], false, t);
-
-                g.setAttribute("mask", "url(#" + mask_id + ")");
-            }
+            if ( has_mask )
+                g.set_attribute("mask", "url(#" + mask_id + ")");
 
             write_time_range_display(g, layer, layer->animation.get());
         }
@@ -975,18 +999,14 @@ public:
     }
 
     template<class PropT, class Callback>
-    QDomElement transform_property(
-        QDomElement& e, model::FrameTime t, const char* name, PropT* prop, const Callback& callback,
+    StreamElement transform_property(
+        StreamElement& e, model::FrameTime t, const char* name, PropT* prop, const Callback& callback,
         const math::bezier::Bezier& path = {}, bool auto_orient = false
     )
     {
         model::JoinAnimatables j({prop}, model::JoinAnimatables::NoValues);
 
-        auto parent = e.parentNode();
-        QDomElement g = dom.createElement("g");
-        parent.insertBefore(g, e);
-        parent.removeChild(e);
-        g.appendChild(e);
+        StreamElement g = e.wrap("g");
 
         if ( j.animated() )
         {
@@ -1021,15 +1041,15 @@ public:
             }
         }
 
-        g.setAttribute("transform", QString("%1(%2)").arg(name).arg(callback(prop->get_at(t))));
+        g.set_attribute("transform", QString("%1(%2)").arg(name).arg(callback(prop->get_at(t))));
         return g;
     }
 
-    void transform_to_attr(QDomElement& parent, model::FrameTime t, model::Transform* transf)
+    void transform_to_attr(StreamElement& parent, model::FrameTime t, model::Transform* transf)
     {
         if ( animated && (transf->position.animated() || transf->scale.animated() || transf->rotation.animated() || transf->anchor_point.animated()) )
         {
-            QDomElement subject = parent;
+            StreamElement subject = parent;
 
             if ( transf->anchor_point.animated() || transf->anchor_point.get() != QPointF() )
                 subject = transform_property(subject, t, "translate", &transf->anchor_point, [](const QPointF& val){
@@ -1057,7 +1077,7 @@ public:
         else
         {
             auto matr = transf->transform_matrix(t);
-            parent.setAttribute("transform", QString("matrix(%1, %2, %3, %4, %5, %6)")
+            parent.set_attribute("transform", QString("matrix(%1, %2, %3, %4, %5, %6)")
                 .arg(matr.m11())
                 .arg(matr.m12())
                 .arg(matr.m21())
@@ -1068,7 +1088,7 @@ public:
         }
     }
 
-    void write_style(QDomElement& element, const Style::Map& s)
+    void write_style(StreamElement& element, const Style::Map& s)
     {
         QString st;
         for ( auto it : s )
@@ -1078,21 +1098,21 @@ public:
             st.append(it.second);
             st.append(';');
         }
-        element.setAttribute("style", st);
+        element.set_attribute("style", st);
     }
 
-    QDomElement start_group(QDomElement& parent, model::DocumentNode* node)
+    StreamElement start_group(StreamElement& parent, model::DocumentNode* node)
     {
-        QDomElement g = element(parent, "g");
-        g.setAttribute("id", id(node));
-        g.setAttribute("inkscape:label", node->object_name());
+        StreamElement g = element(parent, "g");
+        g.set_attribute("id", id(node));
+        g.set_attribute("inkscape:label", node->object_name());
         return g;
     }
 
-    QDomElement start_layer(QDomElement& parent, model::DocumentNode* node)
+    StreamElement start_layer(StreamElement& parent, model::DocumentNode* node)
     {
         auto g = start_group(parent, node);
-        g.setAttribute("inkscape:groupmode", "layer");
+        g.set_attribute("inkscape:groupmode", "layer");
         return g;
     }
 
@@ -1116,16 +1136,16 @@ public:
                 c == '-';
     }
 
-    void write_named_color(QDomElement& parent, model::NamedColor* color, model::FrameTime t)
+    void write_named_color(StreamElement& parent, model::NamedColor* color, model::FrameTime t)
     {
         auto gradient = element(parent, "linearGradient");
-        gradient.setAttribute("osb:paint", "solid");
+        gradient.set_attribute("osb:paint", "solid");
         QString id = pretty_id(color->name.get(), color);
         non_uuid_ids_map[color] = id;
-        gradient.setAttribute("id", id);
+        gradient.set_attribute("id", id);
 
         auto stop = element(gradient, "stop");
-        stop.setAttribute("offset", "0");
+        stop.set_attribute("offset", "0");
         write_property(stop, &color->color, "stop-color", t);
     }
 
@@ -1160,34 +1180,34 @@ public:
 
     template<class T>
     std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>
-    set_attribute(QDomElement& e, const QString& name, T val)
+    set_attribute(StreamElement& e, const QString& name, T val)
     {
         // not using e.setAttribute overloads to bypass locale settings
-        e.setAttribute(name, QString::number(val));
+        e.set_attribute(name, QString::number(val));
     }
 
-    void set_attribute(QDomElement& e, const QString& name, bool val)
+    void set_attribute(StreamElement& e, const QString& name, bool val)
     {
-        e.setAttribute(name, val ? "true" : "false");
+        e.set_attribute(name, val ? "true" : "false");
     }
 
-    void set_attribute(QDomElement& e, const QString& name, const char* val)
+    void set_attribute(StreamElement& e, const QString& name, const char* val)
     {
-        e.setAttribute(name, val);
+        e.set_attribute(name, val);
     }
 
-    void set_attribute(QDomElement& e, const QString& name, const QString& val)
+    void set_attribute(StreamElement& e, const QString& name, const QString& val)
     {
-        e.setAttribute(name, val);
+        e.set_attribute(name, val);
     }
 
 
-    void write_gradient_colors(QDomElement& parent, model::GradientColors* gradient)
+    void write_gradient_colors(StreamElement& parent, model::GradientColors* gradient)
     {
         auto e = element(parent, "linearGradient");
         QString id = pretty_id(gradient->name.get(), gradient);
         non_uuid_ids_map[gradient] = id;
-        e.setAttribute("id", id);
+        e.set_attribute("id", id);
 
         if ( animated && gradient->colors.keyframe_count() > 1 )
         {
@@ -1211,9 +1231,9 @@ public:
                 }
 
                 auto s = element(e, "stop");
-                s.setAttribute("stop-opacity", "1");
+                s.set_attribute("stop-opacity", "1");
                 set_attribute(s, "offset", stops[i].first);
-                s.setAttribute("stop-color", stops[i].second.name());
+                s.set_attribute("stop-color", stops[i].second.name());
                 data.add_dom(s);
             }
         }
@@ -1222,16 +1242,16 @@ public:
             for ( const auto& stop : gradient->colors.get() )
             {
                 auto s = element(e, "stop");
-                s.setAttribute("stop-opacity", "1");
+                s.set_attribute("stop-opacity", "1");
                 set_attribute(s, "offset", stop.first);
-                s.setAttribute("stop-color", stop.second.name());
+                s.set_attribute("stop-color", stop.second.name());
             }
         }
     }
 
-    void write_gradient(QDomElement& parent, model::Gradient* gradient, model::FrameTime t)
+    void write_gradient(StreamElement& parent, model::Gradient* gradient, model::FrameTime t)
     {
-        QDomElement e;
+        StreamElement e;
         if ( gradient->type.get() == model::Gradient::Radial || gradient->type.get() == model::Gradient::Conical )
         {
             e = element(parent, "radialGradient");
@@ -1254,12 +1274,12 @@ public:
 
         QString id = pretty_id(gradient->name.get(), gradient);
         non_uuid_ids_map[gradient] = id;
-        e.setAttribute("id", id);
-        e.setAttribute("gradientUnits", "userSpaceOnUse");
+        e.set_attribute("id", id);
+        e.set_attribute("gradientUnits", "userSpaceOnUse");
 
         auto it = non_uuid_ids_map.find(gradient->colors.get());
         if ( it != non_uuid_ids_map.end() )
-            e.setAttribute("xlink:href", "#" + it->second);
+            e.set_attribute("xlink:href", "#" + it->second);
     }
 
     QString clock(model::FrameTime time)
@@ -1275,7 +1295,9 @@ public:
     }
 
     std::vector<model::StretchableTime*> timing;
-    QDomDocument dom;
+    /// Holds the output when not writing directly to a device
+    QBuffer buffer;
+    std::unique_ptr<ElementStreamWriter> writer;
     qreal fps = 60;
     qreal ip = 0;
     qreal op = 60;
@@ -1283,8 +1305,7 @@ public:
     std::set<QString> non_uuid_ids;
     std::map<model::DocumentNode*, QString> non_uuid_ids_map;
     AnimationType animated;
-    QDomElement svg;
-    QDomElement defs;
+    StreamElement svg;
     CssFontType font_type;
     qreal time_stretch = 1;
     model::FrameTime time_start = 0;
@@ -1293,25 +1314,37 @@ public:
 
 io::svg::SvgRenderer::SvgRenderer(AnimationType animated, CssFontType font_type)
     : d(std::make_unique<Private>())
+{
+    d->buffer.open(QIODevice::WriteOnly);
+    init(&d->buffer, animated, font_type, true);
+}
+
+io::svg::SvgRenderer::SvgRenderer(QIODevice* device, AnimationType animated, CssFontType font_type, bool indent)
+    : d(std::make_unique<Private>())
+{
+    init(device, animated, font_type, indent);
+}
+
+void io::svg::SvgRenderer::init(QIODevice* device, AnimationType animated, CssFontType font_type, bool indent)
 {
     d->animated = animated;
     d->font_type = font_type;
-    d->svg = d->dom.createElement("svg");
-    d->dom.appendChild(d->svg);
-    d->svg.setAttribute("xmlns", detail::xmlns.at("svg"));
+    d->writer = std::make_unique<ElementStreamWriter>(device, indent);
+    d->svg = d->writer->document().append_child("svg");
+    d->svg.set_attribute("xmlns", detail::xmlns.at("svg"));
     for ( const auto& p : detail::xmlns )
     {
         if ( !p.second.contains("android") )
-            d->svg.setAttribute("xmlns:" + p.first, p.second);
+            d->svg.set_attribute("xmlns:" + p.first, p.second);
     }
 
     d->write_style(d->svg, {
         {"fill", "none"},
         {"stroke", "none"}
     });
-    d->svg.setAttribute("inkscape:export-xdpi", "96");
-    d->svg.setAttribute("inkscape:export-ydpi", "96");
-    d->svg.setAttribute("version", "1.1");
+    d->svg.set_attribute("inkscape:export-xdpi", "96");
+    d->svg.set_attribute("inkscape:export-ydpi", "96");
+    d->svg.set_attribute("version", "1.1");
 }
 
 io::svg::SvgRenderer::~SvgRenderer()
@@ -1332,10 +1365,10 @@ void io::svg::SvgRenderer::write_main(model::Composition* comp, model::FrameTime
     {
         QString w  = QString::number(comp->width.get());
         QString h = QString::number(comp->height.get());
-        d->svg.setAttribute("width", w);
-        d->svg.setAttribute("height", h);
-        d->svg.setAttribute("viewBox", QString("0 0 %1 %2").arg(w).arg(h));
-        d->svg.appendChild(d->dom.createElement("title")).appendChild(d->dom.createTextNode(comp->name.get()));
+        d->svg.set_attribute("width", w);
+        d->svg.set_attribute("height", h);
+        d->svg.set_attribute("viewBox", QString("0 0 %1 %2").arg(w).arg(h));
+        d->svg.append_child("title").append_text(comp->name.get());
         write_composition(comp, t);
     }
     else
@@ -1358,14 +1391,26 @@ void io::svg::SvgRenderer::write_node(model::DocumentNode* node, model::FrameTim
         write_shape(sh, t);
 }
 
+void io::svg::SvgRenderer::close()
+{
+    d->writer->close();
+}
+
 QDomDocument io::svg::SvgRenderer::dom() const
 {
-    return d->dom;
+    d->writer->close();
+    QDomDocument dom;
+    dom.setContent(d->buffer.data());
+    return dom;
 }
 
 void io::svg::SvgRenderer::write(QIODevice* device, bool indent)
 {
-    device->write(d->dom.toByteArray(indent ? 4 : -1));
+    d->writer->close();
+    if ( indent )
+        device->write(d->buffer.data());
+    else
+        device->write(dom().toByteArray(-1));
 }
 
 glaxnimate::io::svg::CssFontType glaxnimate::io::svg::SvgRenderer::suggested_type(model::EmbeddedFont* font)
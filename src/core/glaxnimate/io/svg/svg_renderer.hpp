@@ -31,10 +31,24 @@ enum class CssFontType
     Link,
 };
 
+/**
+ * \brief Renders nodes as SVG
+ *
+ * Elements are written out as soon as they are complete so only the
+ * elements being rendered are kept in memory.
+ */
 class SvgRenderer
 {
 public:
+    /**
+     * \brief Renders into an internal buffer, retrieved with dom() or write()
+     */
     SvgRenderer(AnimationType animated, CssFontType font_type);
+
+    /**
+     * \brief Renders directly into \p device, call close() when done
+     */
+    SvgRenderer(QIODevice* device, AnimationType animated, CssFontType font_type, bool indent = true);
     ~SvgRenderer();
 
     void write_composition(model::Composition* comp, model::FrameTime t);
@@ -42,12 +56,27 @@ public:
     void write_shape(model::ShapeElement* shape, model::FrameTime t);
     void write_node(model::DocumentNode* node, model::FrameTime t);
 
+    /**
+     * \brief Finishes the document, nothing else can be written after this
+     */
+    void close();
+
+    /**
+     * \brief Finishes the document and parses the buffered output
+     * \pre Not constructed with a device
+     */
     QDomDocument dom() const;
 
+    /**
+     * \brief Finishes the document and writes the buffered output to \p device
+     * \pre Not constructed with a device
+     */
     void write(QIODevice* device, bool indent);
 
     static CssFontType suggested_type(model::EmbeddedFont* font);
 private:
+    void init(QIODevice* device, AnimationType animated, CssFontType font_type, bool indent);
+
     class Private;
     std::unique_ptr<Private> d;
 };
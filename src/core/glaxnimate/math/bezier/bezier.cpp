@@ -30,6 +30,33 @@ QRectF math::bezier::Bezier::bounding_box() const
     return box;
 }
 
+QRectF math::bezier::Bezier::control_box() const
+{
+    if ( size() < 2 )
+        return {};
+
+    QPointF top_left = points_[0].pos;
+    QPointF bottom_right = top_left;
+    auto add = [&top_left, &bottom_right](const QPointF& p){
+        top_left.setX(qMin(top_left.x(), p.x()));
+        top_left.setY(qMin(top_left.y(), p.y()));
+        bottom_right.setX(qMax(bottom_right.x(), p.x()));
+        bottom_right.setY(qMax(bottom_right.y(), p.y()));
+    };
+
+    for ( int i = 0; i < size(); i++ )
+    {
+        add(points_[i].pos);
+        // The outer tangents of open curves aren't drawn
+        if ( closed_ || i > 0 )
+            add(points_[i].tan_in);
+        if ( closed_ || i < size() - 1 )
+            add(points_[i].tan_out);
+    }
+
+    return QRectF(top_left, bottom_right);
+}
+
 void math::bezier::Bezier::split_segment(int index, qreal factor)
 {
     if ( points_.empty() )
@@ -257,6 +284,20 @@ QRectF math::bezier::MultiBezier::bounding_box() const
     return box;
 }
 
+QRectF math::bezier::MultiBezier::control_box() const
+{
+    QRectF box;
+    for ( const Bezier& bez : beziers_ )
+    {
+        QRectF bb = bez.control_box();
+        if ( box.isNull() )
+            box = bb;
+        else if ( !bb.isNull() )
+            box |= bb;
+    }
+    return box;
+}
+
 void math::bezier::MultiBezier::append(const QPainterPath& path)
 {
     std::array<QPointF, 3> data;
@@ -147,8 +147,18 @@ public:
      */
     void reverse();
 
+    /**
+     * \brief Smallest rect containing the curve
+     */
     QRectF bounding_box() const;
 
+    /**
+     * \brief Rect containing all the points and tangents used by the curve
+     *
+     * It always contains bounding_box() and it's cheaper to compute
+     */
+    QRectF control_box() const;
+
     /**
      * \brief Split a segmet
      * \param index index of the point at the beginning of the segment to split
@@ -267,6 +277,7 @@ public:
     }
 
     QRectF bounding_box() const;
+    QRectF control_box() const;
 
     QPainterPath painter_path() const
     {
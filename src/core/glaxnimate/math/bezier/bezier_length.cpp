@@ -6,6 +6,8 @@
 
 #include "glaxnimate/math/bezier/bezier_length.hpp"
 
+#include <algorithm>
+
 
 
 glaxnimate::math::bezier::LengthData::LengthData(const Solver& segment, int steps)
@@ -142,3 +144,52 @@ qreal glaxnimate::math::bezier::LengthData::child_end(int index) const
 {
     return children_[index].cumulative_length_;
 }
+
+glaxnimate::math::bezier::SegmentLengthTable::SegmentLengthTable(const Solver& segment, int steps)
+    : points_(segment.points())
+{
+    cumulative_.reserve(steps + 1);
+    cumulative_.push_back(0);
+
+    QPointF p = segment.points()[0];
+    qreal length = 0;
+
+    for ( int i = 1; i <= steps; i++ )
+    {
+        QPointF q = segment.solve(qreal(i) / steps);
+        length += math::length(p - q);
+        cumulative_.push_back(length);
+        p = q;
+    }
+}
+
+qreal glaxnimate::math::bezier::SegmentLengthTable::t_at_ratio(qreal ratio) const
+{
+    qreal length = cumulative_.back() * ratio;
+    if ( length <= 0 )
+        return 0;
+
+    if ( length >= cumulative_.back() )
+        return 1;
+
+    int steps = cumulative_.size() - 1;
+    // First sample past the target length
+    int index = std::upper_bound(cumulative_.begin(), cumulative_.end(), length) - cumulative_.begin();
+    qreal step_length = cumulative_[index] - cumulative_[index - 1];
+    qreal step_ratio = qFuzzyIsNull(step_length) ? 0 : (length - cumulative_[index - 1]) / step_length;
+    return math::lerp(qreal(index - 1) / steps, qreal(index) / steps, step_ratio);
+}
+
+qreal glaxnimate::math::bezier::SegmentLengthTable::length_at_t(qreal t) const
+{
+    if ( t <= 0 )
+        return 0;
+
+    if ( t >= 1 )
+        return cumulative_.back();
+
+    int steps = cumulative_.size() - 1;
+    qreal scaled = t * steps;
+    int index = qMin(int(scaled), steps - 1);
+    return math::lerp(cumulative_[index], cumulative_[index + 1], scaled - index);
+}
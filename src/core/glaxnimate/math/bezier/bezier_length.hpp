@@ -66,4 +66,44 @@ private:
 
 };
 
+/**
+ * \brief Flat arc length parameterization of a single cubic segment
+ *
+ * Gives the same results as LengthData for a segment but it's stored
+ * contiguously and looked up with a binary search, so it's cheap to keep around
+ */
+class SegmentLengthTable
+{
+public:
+    explicit SegmentLengthTable(const Solver& segment, int steps);
+
+    /**
+     * \brief Returns the value of t at the given fraction of the total length
+     */
+    qreal t_at_ratio(qreal ratio) const;
+
+    /**
+     * \brief Returns the length of the segment from its start up to \p t
+     */
+    qreal length_at_t(qreal t) const;
+
+    qreal length() const noexcept
+    {
+        return cumulative_.back();
+    }
+
+    /**
+     * \brief Control points of the segment the table has been built from
+     */
+    const std::array<QPointF, 4>& points() const noexcept
+    {
+        return points_;
+    }
+
+private:
+    std::array<QPointF, 4> points_;
+    /// cumulative_[i] is the length at t = i / steps
+    std::vector<qreal> cumulative_;
+};
+
 } // namespace glaxnimate::math::bezier
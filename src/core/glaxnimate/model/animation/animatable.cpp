@@ -120,6 +120,12 @@ glaxnimate::model::AnimatedPropertyBase::AnimatedPropertyBase(Object *object, co
     object->grouped_animations().add_animatable(this);
 }
 
+void glaxnimate::model::AnimatedPropertyBase::keyframes_changed()
+{
+    if ( auto document = object()->document() )
+        Q_EMIT document->keyframes_changed();
+}
+
 bool glaxnimate::model::AnimatedPropertyBase::set_undoable(const QVariant& val, bool commit)
 {
     if ( !valid_value(val) )
@@ -238,9 +244,8 @@ void glaxnimate::model::detail::AnimatedPropertyPosition::split_segment(int inde
         value = kf_before->lerp(*kf_after, factor);
 
         // Reverse length.at_ratio() to get the correct time at which the transition is equal to `value`
-        math::bezier::Solver segment(kf_before->get(), kf_before->point().tan_out, kf_after->point().tan_in, kf_after->get());
-        math::bezier::LengthData length(segment, 20);
-        qreal time_factor = qFuzzyIsNull(length.length()) ? 0 : length.from_ratio(factor) / length.length();
+        auto length = kf_before->length_table(kf_before->bezier_solver(*kf_after));
+        qreal time_factor = qFuzzyIsNull(length->length()) ? 0 : length->length_at_t(factor) / length->length();
         time = qRound(math::lerp(kf_before->time(), kf_after->time(), time_factor));
     }
 
@@ -333,6 +338,7 @@ glaxnimate::model::detail::AnimatedPropertyPosition::keyframe_type*
     {
         auto kf = detail::AnimatedProperty<QPointF>::set_keyframe(time, v->pos, info, force_insert);
         kf->set_point(*v);
+        keyframes_changed();
         Q_EMIT bezier_set(bezier());
         return kf;
     }
@@ -401,8 +407,7 @@ QUndoCommand* glaxnimate::model::detail::AnimatedPropertyPosition::command_add_s
 
                 auto factor = first->transition().lerp_factor(scaled_time);
                 auto solver = first->bezier_solver(*second);
-                math::bezier::LengthData len(solver, 20);
-                auto t = len.at_ratio(factor).ratio;
+                auto t = first->length_table(solver)->t_at_ratio(factor);
                 auto split = solver.split(t);
 
                 auto before = bezier();
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <limits>
+#include <memory>
 
 #include <QList>
 
@@ -138,6 +139,11 @@ public:
 protected:
     virtual void on_set_time(FrameTime time) = 0;
 
+    /**
+     * \brief Notifies the document, unlike value changes this can affect any frame
+     */
+    void keyframes_changed();
+
     FrameTime current_time = 0;
 };
 
@@ -257,6 +263,7 @@ public:
     void set(reference value)
     {
         point_.translate_to(value);
+        std::atomic_store(&length_table_, {});
     }
 
     reference get() const
@@ -291,14 +298,33 @@ public:
             return math::lerp(get(), other.get(), factor);
 
         auto solver = bezier_solver(other);
-        math::bezier::LengthData len(solver, 20);
-        return solver.solve(len.at_ratio(factor).ratio);
+        return solver.solve(length_table(solver)->t_at_ratio(factor));
     }
 
     void set_point(const math::bezier::Point& point)
     {
         point_ = point;
         linear = point_is_linear(point);
+        std::atomic_store(&length_table_, {});
+    }
+
+    /**
+     * \brief Arc length table for the motion path from this keyframe to the next
+     * \param solver Result of bezier_solver() for the next keyframe
+     *
+     * The table is cached and rebuilt when the segment changes,
+     * either from this keyframe or the next one being modified.
+     */
+    std::shared_ptr<const math::bezier::SegmentLengthTable> length_table(const math::bezier::CubicBezierSolver<QPointF>& solver) const
+    {
+        auto table = std::atomic_load(&length_table_);
+        if ( !table || table->points() != solver.points() )
+        {
+            table = std::make_shared<const math::bezier::SegmentLengthTable>(solver, 20);
+            // Lerp can be called from multiple threads at once
+            std::atomic_store(&length_table_, table);
+        }
+        return table;
     }
 
     const math::bezier::Point& point() const
@@ -345,6 +371,7 @@ private:
     math::bezier::Point point_;
     bool linear = true;
     KeyframeTransition transition_;
+    mutable std::shared_ptr<const math::bezier::SegmentLengthTable> length_table_;
 };
 
 template<class Type>
@@ -403,6 +430,7 @@ public:
         this->keyframes_.clear();
         for ( int i = n - 1; i >= 0; i-- )
             Q_EMIT this->keyframe_removed(i);
+        this->keyframes_changed();
     }
 
     bool remove_keyframe_at_time(FrameTime time) override
@@ -415,6 +443,7 @@ public:
             if ( update_prev )
                 --prev;
             this->keyframes_.erase(iter);
+            this->keyframes_changed();
             Q_EMIT this->keyframe_removed(time);
             if ( update_prev )
                 on_keyframe_updated(prev);
@@ -511,6 +540,7 @@ public:
         if ( kf != this->keyframes_.end() )
         {
             kf->set_transition(transition);
+            this->keyframes_changed();
             if ( this->keyframes_.affects_time(kf, this->time()) )
                 this->set_time(this->time());
             Q_EMIT this->transition_changed(time, transition.before_descriptive(), transition.after_descriptive());
@@ -525,6 +555,7 @@ public:
         --kf;
 
         kf->set_transition(transition);
+        this->keyframes_changed();
         if ( this->keyframes_.affects_time(kf, time) )
             this->set_time(this->time());
         Q_EMIT this->transition_changed(time, transition.before_descriptive(), transition.after_descriptive());
@@ -565,6 +596,7 @@ public:
         {
             kf_at->set_time(to_time);
             kf_at = this->keyframes_.move(kf_at, to_time);
+            this->keyframes_changed();
             if ( includes_current_time || this->keyframes_.affects_time(kf_at, this->time()) )
                 this->set_time(this->time());
             Q_EMIT this->keyframe_moved(from_time, to_time);
@@ -575,6 +607,9 @@ public:
         iter->set_transition(kf_at->transition());
         iter->set(kf_at->get());
         this->keyframes_.erase(kf_at);
+        // Erasing invalidates iterators after kf_at
+        iter = this->keyframes_.find(to_time);
+        this->keyframes_changed();
         if ( includes_current_time || this->keyframes_.affects_time(iter, this->time()) )
             this->set_time(this->time());
         Q_EMIT this->keyframe_removed(from_time);
@@ -647,6 +682,7 @@ public:
         }
 
         this->current_time *= multiplier;
+        this->keyframes_changed();
     }
 
 protected:
@@ -663,6 +699,8 @@ protected:
 
     void on_keyframe_updated(mutable_iterator kf)
     {
+        this->keyframes_changed();
+
         auto cur_time = this->time();
         // if no keyframes or the current keyframe is being modified => update value_
         if ( !this->keyframes_.empty() && cur_time != kf->time() )
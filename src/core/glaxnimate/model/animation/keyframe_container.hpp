@@ -5,9 +5,11 @@
  */
 #pragma once
 
-#include <map>
+#include <vector>
 #include <memory>
 #include <iterator>
+#include <atomic>
+#include <algorithm>
 
 #include "glaxnimate/model/animation/frame_time.hpp"
 
@@ -65,16 +67,16 @@ private:
         }
     };
 
-    template<class MapIter>
+    template<class ContainerIter>
     class TemplateIter : public VirtualIter
     {
     public:
-        MapIter iter;
-        TemplateIter(MapIter iter, bool end) : iter(iter) { this->end = end; }
+        ContainerIter iter;
+        TemplateIter(ContainerIter iter, bool end) : iter(iter) { this->end = end; }
 
         void increment() override { ++iter; }
         void decrement() override { --iter; }
-        pointer value() const override { return &iter->second; }
+        pointer value() const override { return iter.ptr(); }
         std::unique_ptr<VirtualIter> copy() const override { return std::make_unique<TemplateIter>(iter, this->end); }
 
     };
@@ -83,8 +85,8 @@ private:
 
 public:
 
-    template<class MapIter>
-    TypeErasedKeyframeIterator(MapIter iter, bool at_end) : iter(std::make_unique<TemplateIter<MapIter>>(iter, at_end)) {}
+    template<class ContainerIter>
+    TypeErasedKeyframeIterator(ContainerIter iter, bool at_end) : iter(std::make_unique<TemplateIter<ContainerIter>>(iter, at_end)) {}
     TypeErasedKeyframeIterator(const TypeErasedKeyframeIterator& oth) : iter(oth.iter->copy()) {}
     TypeErasedKeyframeIterator& operator=(const TypeErasedKeyframeIterator& oth) { iter = oth.iter->copy(); return *this; }
     TypeErasedKeyframeIterator(TypeErasedKeyframeIterator&& oth) = default;
@@ -104,73 +106,133 @@ using TypeErasedKeyframeRange = SimpleRange<TypeErasedKeyframeIterator>;
 
 } // namespace detail
 
+/**
+ * \brief Sorted keyframe storage
+ *
+ * Times are kept in a contiguous sorted array so lookups are a binary search
+ * on cache-friendly data. Keyframes themselves are allocated individually
+ * so pointers to them stay valid as other keyframes are added or removed.
+ *
+ * Time lookups remember the last segment they found, so evaluating frames
+ * in increasing order (playback, export) is amortized constant time.
+ */
 template<class T>
 class KeyframeContainer
 {
 private:
-    using container = std::map<FrameTime, T>;
-    template<class InnerIter, class CVT>
+    template<class CVT>
     class iterator_type
     {
+    private:
+        using container_pointer = std::conditional_t<std::is_const_v<CVT>, const KeyframeContainer*, KeyframeContainer*>;
+
     public:
         using value_type = std::decay_t<T>;
         using reference = CVT&;
         using pointer = CVT*;
-        using iterator_category = typename InnerIter::iterator_category;
-        using difference_type = typename InnerIter::difference_type;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
 
-        iterator_type(InnerIter iter) noexcept : iter(iter) {}
-        iterator_type& operator++() noexcept { ++iter; return *this; }
+        iterator_type(container_pointer container, int index) noexcept : container(container), index(index) {}
+        iterator_type& operator++() noexcept { ++index; return *this; }
         iterator_type operator++(int) noexcept { auto copy = *this; ++*this; return copy; }
-        iterator_type& operator--() noexcept { --iter; return *this; }
+        iterator_type& operator--() noexcept { --index; return *this; }
         iterator_type operator--(int) noexcept { auto copy = *this; --*this; return copy; }
-        bool operator==(const iterator_type& oth) const noexcept { return iter == oth.iter; }
-        bool operator!=(const iterator_type& oth) const noexcept { return iter != oth.iter; }
-        reference operator*() const { return iter->second; }
-        pointer operator->() const { return &iter->second; }
-        pointer ptr() const { return &iter->second; }
+        bool operator==(const iterator_type& oth) const noexcept { return index == oth.index && container == oth.container; }
+        bool operator!=(const iterator_type& oth) const noexcept { return !(*this == oth); }
+        reference operator*() const { return *container->values[index]; }
+        pointer operator->() const { return container->values[index].get(); }
+
+        /**
+         * \brief Pointer to the keyframe or \b nullptr for end()
+         */
+        pointer ptr() const
+        {
+            if ( index < 0 || index >= container->size() )
+                return nullptr;
+            return container->values[index].get();
+        }
 
-        FrameTime key() const { return iter->first; }
+        FrameTime key() const { return container->times[index]; }
 
         // Allow conversion from non-const to const iterator
         template<typename U = CVT, std::enable_if_t<std::is_const_v<U>, int> = 0>
         iterator_type(
-            const iterator_type<typename container::iterator, value_type>& mutable_iterator
-        ) noexcept : iter(mutable_iterator.iter) {}
+            const iterator_type<value_type>& mutable_iterator
+        ) noexcept : container(mutable_iterator.container), index(mutable_iterator.index) {}
 
     private:
         friend KeyframeContainer;
-        InnerIter iter;
-        // friend detail::TypeErasedKeyframeIterator::TemplateIter<T>;
+        template<class> friend class iterator_type;
+        container_pointer container;
+        int index;
     };
 
 public:
     using value_type = T;
     using reference = T&;
     using const_reference = const T&;
-    using iterator = iterator_type<typename container::iterator, T>;
-    // TODO use std::basic_const_iterator?
-    using const_iterator = iterator_type<typename container::const_iterator, const T>;
+    using iterator = iterator_type<T>;
+    using const_iterator = iterator_type<const T>;
     using size_type = int;
 
+    KeyframeContainer() = default;
+
+    // The cursor is only a lookup hint, copies and moves start over from the first segment
+    KeyframeContainer(const KeyframeContainer& other)
+        : times(other.times)
+    {
+        values.reserve(other.values.size());
+        for ( const auto& value : other.values )
+            values.push_back(std::make_unique<T>(*value));
+    }
+
+    KeyframeContainer(KeyframeContainer&& other) noexcept
+        : times(std::move(other.times)),
+        values(std::move(other.values))
+    {
+        other.times.clear();
+        other.values.clear();
+        other.cursor.store(0, std::memory_order_relaxed);
+    }
+
+    KeyframeContainer& operator=(const KeyframeContainer& other)
+    {
+        if ( this != &other )
+            *this = KeyframeContainer(other);
+        return *this;
+    }
+
+    KeyframeContainer& operator=(KeyframeContainer&& other) noexcept
+    {
+        if ( this != &other )
+        {
+            times = std::move(other.times);
+            values = std::move(other.values);
+            other.times.clear();
+            other.values.clear();
+            cursor.store(0, std::memory_order_relaxed);
+            other.cursor.store(0, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
     /**
      * \brief Returns iterator to the value before or equal to the given time
      * If all items are after \p time, it will return an iterator to the first item
      */
     iterator find_best(FrameTime time)
     {
-        auto it = map.lower_bound(time);
-        if ( it != map.begin() && (it == map.end() || it->first > time) )
-            --it;
-        return it;
+        return {this, find_segment(time, false)};
     }
 
+    /**
+     * \brief Returns iterator to the value strictly before the given time
+     * If all items are at or after \p time, it will return an iterator to the first item
+     */
     const_iterator find_best(FrameTime time) const
     {
-        auto it = map.lower_bound(time);
-        if ( it != map.begin() )
-            --it;
-        return it;
+        return {this, find_segment(time, true)};
     }
 
     /**
@@ -178,7 +240,7 @@ public:
      */
     iterator find(FrameTime time)
     {
-        return map.find(time);
+        return {this, find_index(time)};
     }
 
     /**
@@ -186,7 +248,7 @@ public:
      */
     const_iterator find(FrameTime time) const
     {
-        return map.find(time);
+        return {this, find_index(time)};
     }
 
     /**
@@ -194,7 +256,7 @@ public:
      */
     iterator lower_bound(FrameTime time)
     {
-        return map.lower_bound(time);
+        return {this, lower_index(time)};
     }
 
     /**
@@ -202,7 +264,7 @@ public:
      */
     const_iterator lower_bound(FrameTime time) const
     {
-        return map.lower_bound(time);
+        return {this, lower_index(time)};
     }
 
     /**
@@ -210,7 +272,7 @@ public:
      */
     iterator upper_bound(FrameTime time)
     {
-        return map.upper_bound(time);
+        return {this, upper_index(time)};
     }
 
     /**
@@ -218,37 +280,48 @@ public:
      */
     const_iterator upper_bound(FrameTime time) const
     {
-        return map.upper_bound(time);
+        return {this, upper_index(time)};
     }
 
-    bool empty() const { return map.empty(); }
-    size_type size() const { return map.size(); }
+    bool empty() const { return times.empty(); }
+    size_type size() const { return times.size(); }
 
+    /**
+     * \brief Inserts a keyframe at \p time
+     * \returns Iterator to the keyframe at \p time, if it was already present it's left unchanged
+     */
     iterator insert(FrameTime time, value_type t)
     {
-        return map.emplace(time, std::move(t)).first;
+        int index = lower_index(time);
+        if ( index < size() && times[index] == time )
+            return {this, index};
+        return do_insert(index, time, std::move(t));
     }
 
     iterator insert(iterator hint, FrameTime time, value_type t)
     {
-        return map.emplace_hint(hint.iter, time, std::move(t));
+        // Cheap check so appending past the hint skips the search
+        int index = hint.index + 1;
+        if ( index < 0 || index > size() || (index > 0 && times[index - 1] >= time) || (index < size() && times[index] <= time) )
+            return insert(time, std::move(t));
+        return do_insert(index, time, std::move(t));
     }
 
-    iterator begin() { return map.begin(); }
-    iterator end() { return map.end(); }
-    const_iterator begin() const { return map.begin(); }
-    const_iterator end() const { return map.end(); }
-    const_iterator cbegin() const { return map.begin(); }
-    const_iterator cend() const { return map.end(); }
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size()}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+    const_iterator cbegin() const { return {this, 0}; }
+    const_iterator cend() const { return {this, size()}; }
 
     detail::TypeErasedKeyframeRange type_erased() const { return {
-        detail::TypeErasedKeyframeIterator(map.begin(), false),
-        detail::TypeErasedKeyframeIterator(map.end(), true)
+        detail::TypeErasedKeyframeIterator(begin(), false),
+        detail::TypeErasedKeyframeIterator(end(), true)
     }; }
 
     detail::TypeErasedKeyframeIterator type_erased(const const_iterator& iter) const
     {
-        return detail::TypeErasedKeyframeIterator(iter.iter, iter.iter == map.end());
+        return detail::TypeErasedKeyframeIterator(iter, iter == end());
     }
 
     /**
@@ -257,13 +330,27 @@ public:
      */
     iterator move(iterator it, FrameTime dest)
     {
-        auto node = map.extract(it.iter);
-        node.key() = dest;
-        return map.insert(std::move(node)).position;
+        auto value = std::move(values[it.index]);
+        times.erase(times.begin() + it.index);
+        values.erase(values.begin() + it.index);
+        int index = lower_index(dest);
+        times.insert(times.begin() + index, dest);
+        values.insert(values.begin() + index, std::move(value));
+        return {this, index};
     }
 
-    iterator erase(iterator it) { return map.erase(it.iter); }
-    void clear() { map.clear(); }
+    iterator erase(iterator it)
+    {
+        times.erase(times.begin() + it.index);
+        values.erase(values.begin() + it.index);
+        return it;
+    }
+
+    void clear()
+    {
+        times.clear();
+        values.clear();
+    }
 
     /**
      * \brief Whether the iterator points to a segment that contains the given time
@@ -271,12 +358,12 @@ public:
      */
     bool contains_time(const_iterator it, FrameTime time) const
     {
-        if ( it.iter == map.end() )
+        if ( it == end() )
             return false;
         if ( it.key() > time )
-            return it.iter == map.begin();
+            return it == begin();
         ++it;
-        if ( it.iter == map.end() )
+        if ( it == end() )
             return true;
         return it.key() >= time;
     }
@@ -291,7 +378,7 @@ public:
         if ( contains_time(it, time) )
             return true;
 
-        if ( it.key() > time && it.iter != map.begin() )
+        if ( it.key() > time && it != begin() )
         {
             --it;
             return contains_time(it, time);
@@ -301,7 +388,81 @@ public:
     }
 
 private:
-    std::map<FrameTime, T> map;
+    iterator do_insert(int index, FrameTime time, value_type&& t)
+    {
+        times.insert(times.begin() + index, time);
+        values.insert(values.begin() + index, std::make_unique<T>(std::move(t)));
+        return {this, index};
+    }
+
+    int lower_index(FrameTime time) const
+    {
+        return std::lower_bound(times.begin(), times.end(), time) - times.begin();
+    }
+
+    int upper_index(FrameTime time) const
+    {
+        return std::upper_bound(times.begin(), times.end(), time) - times.begin();
+    }
+
+    int find_index(FrameTime time) const
+    {
+        int index = lower_index(time);
+        if ( index < size() && times[index] == time )
+            return index;
+        return size();
+    }
+
+    /**
+     * \brief Whether \p index is the segment find_segment() would return for \p time
+     */
+    bool is_segment(int index, FrameTime time, bool strict) const
+    {
+        if ( index < 0 || index >= size() )
+            return false;
+
+        if ( index > 0 && (strict ? times[index] >= time : times[index] > time) )
+            return false;
+
+        if ( index + 1 < size() && (strict ? times[index + 1] < time : times[index + 1] <= time) )
+            return false;
+
+        return true;
+    }
+
+    /**
+     * \brief Index of the last keyframe before \p time (or at \p time if not \p strict),
+     * 0 if there isn't one
+     */
+    int find_segment(FrameTime time, bool strict) const
+    {
+        if ( times.empty() )
+            return 0;
+
+        // Sequential evaluation hits the same segment or the one after
+        int index = cursor.load(std::memory_order_relaxed);
+        if ( is_segment(index, time, strict) )
+            return index;
+
+        if ( is_segment(index + 1, time, strict) )
+        {
+            index += 1;
+        }
+        else
+        {
+            index = strict ? lower_index(time) : upper_index(time);
+            if ( index > 0 )
+                --index;
+        }
+
+        cursor.store(index, std::memory_order_relaxed);
+        return index;
+    }
+
+    std::vector<FrameTime> times;
+    std::vector<std::unique_ptr<T>> values;
+    /// Last segment found by find_segment(), it might be evaluated from multiple threads
+    mutable std::atomic<int> cursor{0};
 };
 
 } // namespace glaxnimate::model
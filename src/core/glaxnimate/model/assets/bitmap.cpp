@@ -10,7 +10,9 @@
 #include <QImageReader>
 #include <QFileInfo>
 #include <QBuffer>
+#include <QFile>
 #include <QUrl>
+#include <QtMath>
 
 #include "glaxnimate/model/document.hpp"
 #include "glaxnimate/model/assets/assets.hpp"
@@ -20,16 +22,70 @@ GLAXNIMATE_OBJECT_IMPL(glaxnimate::model::Bitmap)
 
 void glaxnimate::model::Bitmap::paint(renderer::Renderer* painter) const
 {
-    painter->draw_image(image);
+    qreal detail = painter->image_detail();
+    if ( detail < 1 && width.get() > 0 && height.get() > 0 )
+    {
+        QImage preview = preview_image(QSize(qCeil(width.get() * detail), qCeil(height.get() * detail)));
+        if ( !preview.isNull() && preview.size() != size() )
+        {
+            // Stretch the preview over the area covered by the full image
+            painter->layer_start();
+            painter->transform(QTransform::fromScale(
+                qreal(width.get()) / preview.width(),
+                qreal(height.get()) / preview.height()
+            ));
+            painter->draw_image(preview);
+            painter->layer_end();
+            return;
+        }
+    }
+
+    painter->draw_image(get_image());
 }
 
-void glaxnimate::model::Bitmap::refresh(bool rebuild_embedded)
+QImage glaxnimate::model::Bitmap::get_image() const
+{
+    return BitmapCache::instance().image(cache_key, encoded);
+}
+
+QImage glaxnimate::model::Bitmap::preview_image(const QSize& max_size) const
+{
+    return BitmapCache::instance().image(cache_key, encoded, max_size);
+}
+
+QPixmap glaxnimate::model::Bitmap::pixmap() const
+{
+    return QPixmap::fromImage(get_image());
+}
+
+void glaxnimate::model::Bitmap::load_encoded(const QByteArray& bytes)
 {
-    QImageReader reader;
-    QImage qimage;
+    encoded = bytes;
+    cache_key = BitmapCache::key(encoded);
+
+    // Only read the header here, pixels are decoded when first needed
+    QBuffer buf(&encoded);
+    buf.open(QIODevice::ReadOnly);
+    QImageReader reader(&buf);
+    format.set(reader.format());
+    QSize image_size = reader.size();
+    // Some formats don't report the size without decoding
+    if ( !image_size.isValid() )
+        image_size = get_image().size();
+
+    if ( image_size.isEmpty() )
+    {
+        encoded.clear();
+        cache_key.clear();
+        image_size = QSize(0, 0);
+    }
 
-    bool load_data = true;
+    width.set(image_size.width());
+    height.set(image_size.height());
+}
 
+void glaxnimate::model::Bitmap::refresh(bool rebuild_embedded)
+{
     if ( rebuild_embedded || data.get().isEmpty() )
     {
         if ( !filename.get().isEmpty() )
@@ -37,30 +93,23 @@ void glaxnimate::model::Bitmap::refresh(bool rebuild_embedded)
             QFileInfo finfo = file_info();
             if ( !finfo.isFile() )
                 return;
-            reader.setFileName(finfo.absoluteFilePath());
-            format.set(reader.format());
-            qimage = reader.read();
+            QFile file(finfo.absoluteFilePath());
+            if ( !file.open(QIODevice::ReadOnly) )
+                return;
+            load_encoded(file.readAll());
+            // The file contents are already encoded in `format`
             if ( rebuild_embedded && embedded() )
-                data.set(build_embedded(qimage));
-            load_data = false;
+                data.set(encoded);
+            Q_EMIT loaded();
+            return;
         }
         else if ( !url.get().isEmpty() )
         {
             document()->assets()->network_downloader.get(QUrl(url.get()), [this, rebuild_embedded](QByteArray response){
-                QImageReader reader;
-                QImage qimage;
-                QBuffer buf(&response);
-                buf.open(QIODevice::ReadOnly);
-                reader.setDevice(&buf);
-                format.set(reader.format());
-                qimage = reader.read();
-                image = qimage.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+                load_encoded(response);
 
                 if ( rebuild_embedded && embedded() )
-                    data.set(build_embedded(image));
-
-                width.set(image.width());
-                height.set(image.height());
+                    data.set(encoded);
 
                 document()->graphics_invalidated();
                 Q_EMIT loaded();
@@ -69,19 +118,7 @@ void glaxnimate::model::Bitmap::refresh(bool rebuild_embedded)
         }
     }
 
-    if ( load_data )
-    {
-        QBuffer buf(const_cast<QByteArray*>(&data.get()));
-        buf.open(QIODevice::ReadOnly);
-        reader.setDevice(&buf);
-        format.set(reader.format());
-        qimage = reader.read();
-    }
-    image = qimage.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-
-    width.set(image.width());
-    height.set(image.height());
-
+    load_encoded(data.get());
     Q_EMIT loaded();
 }
 
@@ -108,7 +145,7 @@ void glaxnimate::model::Bitmap::embed(bool embedded)
     if ( !embedded )
         data.set_undoable({});
     else
-        data.set_undoable(build_embedded(image));
+        data.set_undoable(encoded);
 }
 
 void glaxnimate::model::Bitmap::on_refresh()
@@ -118,7 +155,7 @@ void glaxnimate::model::Bitmap::on_refresh()
 
 QIcon glaxnimate::model::Bitmap::instance_icon() const
 {
-    return pixmap();
+    return QPixmap::fromImage(preview_image(QSize(256, 256)));
 }
 
 bool glaxnimate::model::Bitmap::from_url(const QUrl& url)
@@ -137,7 +174,7 @@ bool glaxnimate::model::Bitmap::from_url(const QUrl& url)
 bool glaxnimate::model::Bitmap::from_file(const QString& file)
 {
     filename.set(file);
-    return !image.isNull();
+    return !size().isEmpty();
 }
 
 bool glaxnimate::model::Bitmap::from_base64(const QString& data)
@@ -156,7 +193,7 @@ bool glaxnimate::model::Bitmap::from_base64(const QString& data)
     auto decoded = QByteArray::fromBase64(chunks[1].toLatin1());
     format.set(formats[0]);
     this->data.set(decoded);
-    return !image.isNull();
+    return !size().isEmpty();
 }
 
 
@@ -170,7 +207,7 @@ bool glaxnimate::model::Bitmap::from_raw_data(const QByteArray& data)
 
     this->format.set(format);
     this->data.set(data);
-    return !image.isNull();
+    return !size().isEmpty();
 
 }
 
@@ -238,10 +275,8 @@ QByteArray glaxnimate::model::Bitmap::image_data() const
     if ( !data.get().isEmpty() )
         return data.get();
 
-    if ( image.isNull() )
-        return {};
-
-    return build_embedded(image);
+    // Data loaded from file or url is already encoded in `format`
+    return encoded;
 }
 
 QSize glaxnimate::model::Bitmap::size() const
@@ -12,6 +12,7 @@
 #include <QUrl>
 
 #include "glaxnimate/model/assets/asset.hpp"
+#include "glaxnimate/model/assets/bitmap_cache.hpp"
 
 namespace glaxnimate::model {
 
@@ -21,9 +22,9 @@ class Bitmap : public Asset
     GLAXNIMATE_PROPERTY(QByteArray, data, {}, &Bitmap::on_refresh)
     GLAXNIMATE_PROPERTY(QString, filename, {}, &Bitmap::on_refresh)
     GLAXNIMATE_PROPERTY(QString, url, {}, &Bitmap::on_refresh)
-    GLAXNIMATE_PROPERTY_RO(QString, format, {})
-    GLAXNIMATE_PROPERTY_RO(int, width, -1)
-    GLAXNIMATE_PROPERTY_RO(int, height, -1)
+    GLAXNIMATE_PROPERTY_RO(QString, format, {}, {})
+    GLAXNIMATE_PROPERTY_RO(int, width, -1, {})
+    GLAXNIMATE_PROPERTY_RO(int, height, -1, {})
     Q_PROPERTY(bool embedded READ embedded WRITE embed)
     Q_PROPERTY(QImage image READ get_image)
 
@@ -52,15 +53,22 @@ public:
 
     QFileInfo file_info() const;
 
-    QPixmap pixmap() const { return QPixmap::fromImage(image); }
+    QPixmap pixmap() const;
     void set_pixmap(const QImage& qimage, const QString& format);
 
     bool remove_if_unused(bool clean_lists) override;
 
-    const QImage& get_image() const
-    {
-        return image;
-    }
+    /**
+     * \brief Decoded image, shared through BitmapCache
+     *
+     * The pixels are decoded on first use rather than when the image is loaded.
+     */
+    QImage get_image() const;
+
+    /**
+     * \brief Reduced-resolution variant of the image fitting within \p max_size
+     */
+    QImage preview_image(const QSize& max_size) const;
 
     /**
      * \brief If `embedded()` returns `data`, otherwise tries to load the data based on filename
@@ -76,6 +84,7 @@ public Q_SLOTS:
 
 private:
     QByteArray build_embedded(const QImage& img) const;
+    void load_encoded(const QByteArray& bytes);
 
 private Q_SLOTS:
     void on_refresh();
@@ -84,7 +93,9 @@ Q_SIGNALS:
     void loaded();
 
 private:
-    QImage image;
+    /// Encoded image contents, either from `data` or from the external source
+    QByteArray encoded;
+    BitmapCache::Key cache_key;
 
 };
 
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "glaxnimate/model/assets/bitmap_cache.hpp"
+
+#include <QHash>
+#include <QBuffer>
+#include <QImageReader>
+#include <QCryptographicHash>
+
+#include "glaxnimate/utils/lru_cache.hpp"
+
+class glaxnimate::model::BitmapCache::Private
+{
+public:
+    struct Variant
+    {
+        Key key;
+        // Both 0 for the full resolution image
+        int width;
+        int height;
+
+        bool operator==(const Variant& oth) const
+        {
+            return width == oth.width && height == oth.height && key == oth.key;
+        }
+
+        std::size_t hash() const
+        {
+            return qHashMulti(0, key, width, height);
+        }
+    };
+
+    QMutex mutex;
+    utils::LruCache<Variant, QImage> images{256 * 1024 * 1024};
+};
+
+glaxnimate::model::BitmapCache::BitmapCache()
+    : d(std::make_unique<Private>())
+{
+}
+
+glaxnimate::model::BitmapCache::~BitmapCache() = default;
+
+glaxnimate::model::BitmapCache& glaxnimate::model::BitmapCache::instance()
+{
+    static BitmapCache instance;
+    return instance;
+}
+
+glaxnimate::model::BitmapCache::Key glaxnimate::model::BitmapCache::key(const QByteArray& encoded)
+{
+    if ( encoded.isEmpty() )
+        return {};
+    return QCryptographicHash::hash(encoded, QCryptographicHash::Sha1);
+}
+
+QImage glaxnimate::model::BitmapCache::decode(const QByteArray& encoded, const QSize& max_size)
+{
+    QBuffer buf(const_cast<QByteArray*>(&encoded));
+    buf.open(QIODevice::ReadOnly);
+    QImageReader reader(&buf);
+
+    if ( max_size.isValid() )
+    {
+        QSize size = reader.size();
+        // Let the decoder skip pixels when it can (eg: JPEG)
+        if ( size.isValid() && (size.width() > max_size.width() || size.height() > max_size.height()) )
+            reader.setScaledSize(size.scaled(max_size, Qt::KeepAspectRatio));
+    }
+
+    QImage image = reader.read();
+    if ( image.isNull() )
+        return {};
+
+    if ( max_size.isValid() && (image.width() > max_size.width() || image.height() > max_size.height()) )
+        image = image.scaled(max_size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+QImage glaxnimate::model::BitmapCache::image(const Key& key, const QByteArray& encoded, const QSize& max_size)
+{
+    if ( encoded.isEmpty() )
+        return {};
+
+    Private::Variant variant{key, 0, 0};
+    if ( max_size.isValid() )
+        variant = {key, max_size.width(), max_size.height()};
+
+    // Failed decodes are kept as null images, the same data would fail again
+    return d->images.get(
+        d->mutex, variant,
+        [&encoded, &max_size]{ return decode(encoded, max_size); },
+        [](const QImage& image){ return qint64(image.sizeInBytes()); }
+    );
+}
+
+qint64 glaxnimate::model::BitmapCache::memory_budget() const
+{
+    QMutexLocker lock(&d->mutex);
+    return d->images.memory_budget();
+}
+
+void glaxnimate::model::BitmapCache::set_memory_budget(qint64 bytes)
+{
+    QMutexLocker lock(&d->mutex);
+    d->images.set_memory_budget(bytes);
+}
+
+qint64 glaxnimate::model::BitmapCache::memory_usage() const
+{
+    QMutexLocker lock(&d->mutex);
+    return d->images.memory_usage();
+}
+
+void glaxnimate::model::BitmapCache::clear()
+{
+    QMutexLocker lock(&d->mutex);
+    d->images.clear();
+}
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <QImage>
+#include <QByteArray>
+
+namespace glaxnimate::model {
+
+/**
+ * \brief Process-wide cache of decoded bitmap pixels
+ *
+ * Images are keyed by a hash of their encoded data so bitmaps with the same
+ * contents are decoded only once, even across documents.
+ * The least recently used images are dropped when the decoded pixels exceed
+ * the memory budget, they will be decoded again the next time they are needed.
+ *
+ * All functions are thread-safe.
+ */
+class BitmapCache
+{
+public:
+    using Key = QByteArray;
+
+    static BitmapCache& instance();
+
+    /**
+     * \brief Cache key for the given encoded image data
+     */
+    static Key key(const QByteArray& encoded);
+
+    /**
+     * \brief Decodes \p encoded as premultiplied ARGB32
+     * \param max_size If valid, the image is scaled down to fit within it
+     */
+    static QImage decode(const QByteArray& encoded, const QSize& max_size = {});
+
+    /**
+     * \brief Returns the decoded image for \p encoded, decoding it on a cache miss
+     * \param key       Value of key() for \p encoded
+     * \param encoded   Encoded image data
+     * \param max_size  If valid, returns a reduced-resolution variant fitting within it
+     */
+    QImage image(const Key& key, const QByteArray& encoded, const QSize& max_size = {});
+
+    /**
+     * \brief Maximum number of bytes of decoded pixels to keep around
+     */
+    qint64 memory_budget() const;
+    void set_memory_budget(qint64 bytes);
+
+    /**
+     * \brief Number of bytes used by the cached images
+     */
+    qint64 memory_usage() const;
+
+    /**
+     * \brief Drops all the decoded images
+     */
+    void clear();
+
+private:
+    BitmapCache();
+    ~BitmapCache();
+    BitmapCache(const BitmapCache&) = delete;
+    BitmapCache& operator=(const BitmapCache&) = delete;
+
+    class Private;
+    std::unique_ptr<Private> d;
+};
+
+} // namespace glaxnimate::model
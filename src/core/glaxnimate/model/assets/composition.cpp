@@ -61,28 +61,39 @@ QRectF glaxnimate::model::Composition::local_bounding_rect(FrameTime) const
     return rect();
 }
 
+void glaxnimate::model::Composition::on_property_changed(const BaseProperty* prop, const QVariant&)
+{
+    // Empty groups use the composition rect as their bounding rect
+    if ( prop == &width || prop == &height )
+        clear_bounding_rect_cache(true);
+}
+
 QImage glaxnimate::model::Composition::render_image(float time, QSize image_size, const QColor& background) const
 {
-    QSizeF real_size = size();
     if ( !image_size.isValid() )
-        image_size = real_size.toSize();
+        image_size = size().toSize();
     QImage image(image_size, QImage::Format_ARGB32);
+    auto renderer = renderer::RendererRegistry::instance().default_renderer(10);
+    render_image(time, image, renderer.get(), background);
+    return image;
+}
+
+void glaxnimate::model::Composition::render_image(float time, QImage& image, renderer::Renderer* renderer, const QColor& background) const
+{
     if ( !background.isValid() )
         image.fill(Qt::transparent);
     else
         image.fill(background);
 
-    auto renderer = renderer::RendererRegistry::instance().default_renderer(10);
+    QSizeF real_size = size();
     renderer->set_image_surface(&image);
     renderer->render_start();
     renderer->scale(
-        image_size.width() / real_size.width(),
-        image_size.height() / real_size.height()
+        image.width() / real_size.width(),
+        image.height() / real_size.height()
     );
-    paint(renderer.get(), time, VisualNode::Render);
+    paint(renderer, time, VisualNode::Render);
     renderer->render_end();
-
-    return image;
 }
 
 QImage glaxnimate::model::Composition::render_image() const
@@ -67,6 +67,18 @@ public:
     Q_INVOKABLE QImage render_image(float time, QSize size = {}, const QColor& background = {}) const;
     Q_INVOKABLE QImage render_image() const;
 
+    /**
+     * \brief Renders the frame at \p time into an existing image
+     *
+     * The contents of \p image are replaced and scaled to its size.
+     * Use this with the same \p image and \p renderer to render multiple
+     * frames without allocating a new image and renderer every time.
+     */
+    void render_image(float time, QImage& image, renderer::Renderer* renderer, const QColor& background = {}) const;
+
+protected:
+    void on_property_changed(const BaseProperty* prop, const QVariant& value) override;
+
 Q_SIGNALS:
     void fps_changed(float fps);
     void width_changed(float);
@@ -12,6 +12,7 @@
 #include <QCryptographicHash>
 
 #include "glaxnimate/utils/qbytearray_hash.hpp"
+#include "glaxnimate/model/shapes/shapes/text_cache.hpp"
 
 
 glaxnimate::model::FontFileFormat glaxnimate::model::CustomFontDatabase::font_data_format(const QByteArray& data)
@@ -69,7 +70,11 @@ public:
     void tag_alias(const DataPtr& data, const QString& name)
     {
         if ( !name.isEmpty() && name != data->family_name() && data->name_aliases.insert(name).second )
+        {
             name_aliases[name].push_back(data->database_index);
+            // Text cached under this name might have been laid out with a fallback font
+            TextCache::instance().clear();
+        }
     }
 
     void uninstall(std::unordered_map<int, DataPtr>::iterator iterator)
@@ -89,6 +94,7 @@ public:
         hashes.erase(iterator->second->data_hash);
         QFontDatabase::removeApplicationFont(iterator->first);
         fonts.erase(iterator);
+        TextCache::instance().clear();
     }
 
     void remove_reference(int font)
@@ -126,6 +132,8 @@ public:
         auto ptr = std::make_shared<CustomFontData>(raw, index, hash, data);
         fonts.emplace(index, ptr);
         tag_alias(ptr, name_alias);
+        // The cache is keyed by font names, which might now resolve to the new font
+        TextCache::instance().clear();
         return ptr;
     }
 };
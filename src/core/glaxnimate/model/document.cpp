@@ -7,6 +7,8 @@
 #include "glaxnimate/model/document.hpp"
 
 #include <QRegularExpression>
+#include <QPointer>
+#include <QHash>
 
 #include "glaxnimate/io/glaxnimate/glaxnimate_format.hpp"
 #include "glaxnimate/model/assets/assets.hpp"
@@ -75,6 +77,80 @@ public:
         return QString("%1 %2").arg(iter->first).arg(iter->second + 1);
     }
 
+    /**
+     * \brief Whether \p node is part of the tree rooted in the document assets
+     */
+    bool in_tree(const DocumentNode* node) const
+    {
+        for ( ; node; node = node->docnode_parent() )
+        {
+            if ( node == &assets )
+                return true;
+        }
+        return false;
+    }
+
+    void index_tree(DocumentNode* node)
+    {
+        nodes_by_uuid[node->uuid.get()] = node;
+        if ( !node->name.get().isEmpty() )
+            nodes_by_name.insert(node->name.get(), node);
+
+        for ( auto child : node->docnode_children() )
+            index_tree(child);
+    }
+
+    void unindex_tree(DocumentNode* node)
+    {
+        auto it = nodes_by_uuid.find(node->uuid.get());
+        if ( it != nodes_by_uuid.end() && it.value() == node )
+            nodes_by_uuid.erase(it);
+        nodes_by_name.remove(node->name.get(), node);
+
+        for ( auto child : node->docnode_children() )
+            unindex_tree(child);
+    }
+
+    DocumentNode* find_by_uuid(const QUuid& uuid)
+    {
+        auto it = nodes_by_uuid.find(uuid);
+        if ( it == nodes_by_uuid.end() )
+            return nullptr;
+
+        DocumentNode* node = it.value();
+        // Safety net, nodes are removed from the index as they leave the tree
+        if ( !node || node->uuid.get() != uuid || !in_tree(node) )
+        {
+            nodes_by_uuid.erase(it);
+            return nullptr;
+        }
+
+        return node;
+    }
+
+    DocumentNode* find_by_name(const QString& name)
+    {
+        DocumentNode* found = nullptr;
+        for ( auto it = nodes_by_name.find(name); it != nodes_by_name.end() && it.key() == name; )
+        {
+            DocumentNode* node = it.value();
+            if ( !node || node->name.get() != name || !in_tree(node) )
+            {
+                it = nodes_by_name.erase(it);
+                continue;
+            }
+
+            // Multiple matches: the tree walk returns the first in tree order
+            if ( found )
+                return assets.docnode_find_by_name(name);
+
+            found = node;
+            ++it;
+        }
+
+        return found;
+    }
+
     int add_pending_asset(QUrl url, QByteArray data, const QString& name_alias)
     {
         int id = max_pending_id;
@@ -95,6 +171,8 @@ public:
     int max_pending_id = 0;
     DocumentInfo info;
     QUuid uuid;
+    QHash<QUuid, QPointer<DocumentNode>> nodes_by_uuid;
+    QMultiHash<QString, QPointer<DocumentNode>> nodes_by_name;
 };
 
 
@@ -103,6 +181,7 @@ glaxnimate::model::Document::Document(const QString& filename)
 {
     d->io_options.filename = filename;
     d->uuid = QUuid::createUuid();
+    d->index_tree(&d->assets);
 }
 
 glaxnimate::model::Document::~Document() = default;
@@ -142,12 +221,12 @@ void glaxnimate::model::Document::set_io_options(const io::Options& opt)
 
 glaxnimate::model::DocumentNode * glaxnimate::model::Document::find_by_uuid(const QUuid& n) const
 {
-    return d->assets.docnode_find_by_uuid(n);
+    return d->find_by_uuid(n);
 }
 
 glaxnimate::model::DocumentNode * glaxnimate::model::Document::find_by_name(const QString& name) const
 {
-    return d->assets.docnode_find_by_name(name);
+    return d->find_by_name(name);
 }
 
 QVariantList glaxnimate::model::Document::find_by_type_name(const QString& type_name) const
@@ -249,6 +328,33 @@ void glaxnimate::model::Document::increase_node_name(const QString& new_name)
         d->increase(d->name_index(new_name));
 }
 
+void glaxnimate::model::Document::index_node(DocumentNode* node)
+{
+    if ( d->in_tree(node) )
+        d->index_tree(node);
+}
+
+void glaxnimate::model::Document::unindex_node(DocumentNode* node)
+{
+    d->unindex_tree(node);
+}
+
+void glaxnimate::model::Document::node_name_changed(DocumentNode* node, const QString& old_name)
+{
+    d->nodes_by_name.remove(old_name, node);
+    if ( !node->name.get().isEmpty() && d->in_tree(node) )
+        d->nodes_by_name.insert(node->name.get(), node);
+}
+
+void glaxnimate::model::Document::node_uuid_changed(DocumentNode* node, const QUuid& old_uuid)
+{
+    auto it = d->nodes_by_uuid.find(old_uuid);
+    if ( it != d->nodes_by_uuid.end() && it.value() == node )
+        d->nodes_by_uuid.erase(it);
+    if ( d->in_tree(node) )
+        d->nodes_by_uuid[node->uuid.get()] = node;
+}
+
 
 void glaxnimate::model::Document::stretch_time(qreal multiplier)
 {
@@ -64,6 +64,12 @@ public:
     void set_io_options(const io::Options& opt);
 
     Q_INVOKABLE glaxnimate::model::DocumentNode* find_by_uuid(const QUuid& n) const;
+    /**
+     * \brief Returns the first node in tree order with the given name
+     *
+     * Lookups go through an index, but when more than one node has the
+     * name this falls back to walking the tree to find the first one.
+     */
     Q_INVOKABLE glaxnimate::model::DocumentNode* find_by_name(const QString& name) const;
     Q_INVOKABLE QVariantList find_by_type_name(const QString& type_name) const;
 
@@ -103,13 +109,36 @@ Q_SIGNALS:
     void current_time_changing(FrameTime t);
     void current_time_changed(FrameTime t);
     void record_to_keyframe_changed(bool r);
+    /**
+     * \brief Emitted when the rendered output might have changed
+     *
+     * For property changes this is emitted before the signals of the object owning the property
+     */
     void graphics_invalidated();
+    /**
+     * \brief Emitted when keyframes change
+     *
+     * Unlike graphics_invalidated() this covers changes that don't affect
+     * the current time but do affect other frames
+     */
+    void keyframes_changed();
 
 private:
     Object* assets_obj() const;
     void decrease_node_name(const QString& old_name);
     void increase_node_name(const QString& new_name);
 
+    /**
+     * \brief Adds \p node and its descendants to the lookup index if they are in the document tree
+     */
+    void index_node(DocumentNode* node);
+    /**
+     * \brief Removes \p node and its descendants from the lookup index
+     */
+    void unindex_node(DocumentNode* node);
+    void node_name_changed(DocumentNode* node, const QString& old_name);
+    void node_uuid_changed(DocumentNode* node, const QUuid& old_uuid);
+
 private:
     class Private;
     friend DocumentNode;
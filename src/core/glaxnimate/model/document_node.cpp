@@ -39,6 +39,7 @@ void glaxnimate::model::DocumentNode::removed_from_list()
     auto old = d->list_parent;
     d->list_parent = nullptr;
     document()->decrease_node_name(name.get());
+    document()->unindex_node(this);
     on_parent_changed(old, d->list_parent);
     Q_EMIT removed();
 }
@@ -48,6 +49,7 @@ void glaxnimate::model::DocumentNode::added_to_list ( glaxnimate::model::Documen
     auto old = d->list_parent;
     d->list_parent = new_parent;
     document()->increase_node_name(name.get());
+    document()->index_node(this);
     on_parent_changed(old, d->list_parent);
 }
 
@@ -57,10 +59,18 @@ void glaxnimate::model::DocumentNode::on_name_changed(const QString& name, const
     {
         document()->decrease_node_name(old_name);
         document()->increase_node_name(name);
+        document()->node_name_changed(this, old_name);
         Q_EMIT name_changed(name);
     }
 }
 
+void glaxnimate::model::DocumentNode::on_uuid_changed(const QUuid&, const QUuid& old_uuid)
+{
+    // The first uuid is assigned by the constructor, before the node can be in a document tree
+    if ( !old_uuid.isNull() )
+        document()->node_uuid_changed(this, old_uuid);
+}
+
 glaxnimate::model::DocumentNode * glaxnimate::model::DocumentNode::docnode_parent() const
 {
     return d->list_parent;
@@ -180,6 +190,7 @@ class glaxnimate::model::VisualNode::Private : public DocumentNode::Private
 {
 public:
     std::unique_ptr<QPixmap> group_icon;
+    PathCache<QRectF, std::pair<FrameTime, BoundingRectMode>> bounding_rects;
 };
 
 glaxnimate::model::VisualNode::VisualNode(model::Document* document)
@@ -394,9 +405,38 @@ void glaxnimate::model::VisualNode::propagate_transform_matrix_changed(const QTr
 
 void glaxnimate::model::VisualNode::propagate_bounding_rect_changed()
 {
-    on_graphics_changed();
-    Q_EMIT bounding_rect_changed();
-    if ( auto parent = docnode_visual_parent() )
-        parent->propagate_bounding_rect_changed();
+    // Everything is invalidated before emitting as the signal is forwarded
+    // to the parents, whose listeners might query their bounding rect
+    for ( auto node = this; node; node = node->docnode_visual_parent() )
+    {
+        node->dd()->bounding_rects.mark_dirty();
+        node->on_graphics_changed();
+    }
+
+    for ( auto node = this; node; node = node->docnode_visual_parent() )
+        Q_EMIT node->bounding_rect_changed();
+}
+
+QRectF glaxnimate::model::VisualNode::cached_local_bounding_rect(FrameTime t, BoundingRectMode mode) const
+{
+    return dd()->bounding_rects.get({t, mode}, [this, t, mode]{
+        return mode == Conservative ? local_conservative_bounding_rect(t) : local_bounding_rect(t);
+    });
+}
+
+QRectF glaxnimate::model::VisualNode::cached_bounding_rect(FrameTime t, BoundingRectMode mode) const
+{
+    // Not cached itself: the transform of the ancestors isn't always notified
+    // (eg: reparenting) and mapping the rect costs about as much as a lookup
+    return transform_matrix(t).map(cached_local_bounding_rect(t, mode)).boundingRect();
+}
 
+void glaxnimate::model::VisualNode::clear_bounding_rect_cache(bool recursive)
+{
+    dd()->bounding_rects.mark_dirty();
+    if ( recursive )
+    {
+        for ( auto ch : docnode_visual_children() )
+            ch->clear_bounding_rect_cache(true);
+    }
 }
@@ -33,7 +33,7 @@ public:
     /**
      * @brief Unique identifier for the node
      */
-    GLAXNIMATE_PROPERTY_RO(QUuid, uuid, {})
+    GLAXNIMATE_PROPERTY_RO(QUuid, uuid, {}, &DocumentNode::on_uuid_changed)
     /**
      * @brief Name of the node, used to display it in the UI
      */
@@ -233,6 +233,7 @@ private:
     void added_to_list(DocumentNode* new_parent);
 
     void on_name_changed(const QString& name, const QString& old_name);
+    void on_uuid_changed(const QUuid& uuid, const QUuid& old_uuid);
 
 Q_SIGNALS:
     void docnode_child_add_begin(int row);
@@ -292,6 +293,12 @@ public:
         Render          ///< Recursive, but hide objects marked with render == false
     };
 
+    enum BoundingRectMode
+    {
+        Tight,          ///< Smallest rect containing the node
+        Conservative,   ///< Might be larger than needed but it's cheaper to compute, good enough for culling
+    };
+
     explicit VisualNode(model::Document* document);
 
     QColor docnode_group_color() const;
@@ -318,6 +325,19 @@ public:
      */
     virtual QRectF local_bounding_rect(FrameTime t) const = 0;
 
+    /**
+     * \brief Bounding rect in local coordinates, cached per frame
+     *
+     * The cache is cleared by propagate_bounding_rect_changed() so this
+     * should be preferred to local_bounding_rect() for repeated queries.
+     */
+    QRectF cached_local_bounding_rect(FrameTime t, BoundingRectMode mode = Tight) const;
+
+    /**
+     * \brief Bounding rect in document coordinates, from the cached local one
+     */
+    QRectF cached_bounding_rect(FrameTime t, BoundingRectMode mode = Tight) const;
+
     /**
      * \brief \b true iff this node and all of its ancestors are visible and unlocked
      */
@@ -341,7 +361,13 @@ public:
      */
     virtual QTransform local_transform_matrix(FrameTime) const { return QTransform(); }
 
-
+    /**
+     * \brief Renders the node as it appears at \p time
+     *
+     * This only reads from the model (internal caches are keyed by time and guarded)
+     * so different frames can be painted from multiple threads at once,
+     * as long as the document isn't modified in the meantime.
+     */
     virtual void paint(renderer::Renderer* painter, FrameTime time, PaintMode mode, model::Modifier* modifier = nullptr) const;
 
     QIcon instance_icon() const override;
@@ -369,6 +395,14 @@ protected:
     bool docnode_valid_color() const;
     void propagate_transform_matrix_changed(const QTransform& t_global, const QTransform& t_group);
     void propagate_bounding_rect_changed();
+    /**
+     * \brief Clears the bounding rects cached for this node, and its descendants if \p recursive
+     */
+    void clear_bounding_rect_cache(bool recursive = false);
+    /**
+     * \brief Bounding rect for BoundingRectMode::Conservative, defaults to local_bounding_rect()
+     */
+    virtual QRectF local_conservative_bounding_rect(FrameTime t) const { return local_bounding_rect(t); }
     virtual void on_paint(renderer::Renderer*, FrameTime, PaintMode, model::Modifier*) const {}
 
 private:
@@ -0,0 +1,314 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "glaxnimate/model/frame_cache.hpp"
+
+#include <list>
+#include <map>
+#include <deque>
+#include <unordered_set>
+#include <cmath>
+#include <tuple>
+#include <algorithm>
+
+#include <QTimer>
+
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/assets/composition.hpp"
+
+using namespace glaxnimate;
+
+class glaxnimate::model::FrameCache::Private
+{
+public:
+    struct Key
+    {
+        Composition* comp;
+        FrameTime time;
+        int width;
+        int height;
+        QRgb background;
+
+        bool operator<(const Key& oth) const
+        {
+            return std::tie(comp, time, width, height, background) <
+                   std::tie(oth.comp, oth.time, oth.width, oth.height, oth.background);
+        }
+
+        qint64 bytes() const
+        {
+            return qint64(width) * height * 4;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        Document* document;
+        QImage image;
+    };
+
+    Private(FrameCache* parent, qint64 memory_budget)
+        : parent(parent), memory_budget(memory_budget)
+    {
+        prefetch_timer.setInterval(0);
+        QObject::connect(&prefetch_timer, &QTimer::timeout, parent, [this]{ prefetch_next(); });
+    }
+
+    Key key(Composition* comp, FrameTime time, QSize size, const QColor& background) const
+    {
+        if ( !size.isValid() )
+            size = comp->size().toSize();
+        // Invalid backgrounds are filled with transparent
+        return {comp, time, size.width(), size.height(), background.isValid() ? background.rgba() : 0};
+    }
+
+    const QImage* find(const Key& key)
+    {
+        auto it = index.find(key);
+        if ( it == index.end() )
+            return nullptr;
+
+        // Most recently used at the front
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->image;
+    }
+
+    const QImage& render(const Key& key)
+    {
+        track(key.comp);
+        if ( !renderer )
+            renderer = renderer::RendererRegistry::instance().default_renderer(10);
+        QImage image(key.width, key.height, QImage::Format_ARGB32);
+        key.comp->render_image(key.time, image, renderer.get(), QColor::fromRgba(key.background));
+        qint64 bytes = image.sizeInBytes();
+        if ( bytes > memory_budget )
+        {
+            uncached = std::move(image);
+            return uncached;
+        }
+
+        entries.push_front({key, key.comp->document(), std::move(image)});
+        index[key] = entries.begin();
+        memory_usage += bytes;
+        evict();
+        return entries.front().image;
+    }
+
+    void evict()
+    {
+        while ( memory_usage > memory_budget && !entries.empty() )
+            erase(std::prev(entries.end()));
+    }
+
+    void erase(std::list<Entry>::iterator it)
+    {
+        memory_usage -= it->image.sizeInBytes();
+        index.erase(it->key);
+        entries.erase(it);
+    }
+
+    template<class Func>
+    void erase_if(const Func& predicate)
+    {
+        for ( auto it = entries.begin(); it != entries.end(); )
+        {
+            auto next = std::next(it);
+            if ( predicate(*it) )
+                erase(it);
+            it = next;
+        }
+    }
+
+    void invalidate(Document* document)
+    {
+        erase_if([document](const Entry& entry){ return entry.document == document; });
+        drop_pending([document](const Key& key){ return key.comp->document() == document; });
+    }
+
+    void invalidate(Composition* comp)
+    {
+        erase_if([comp](const Entry& entry){ return entry.key.comp == comp; });
+        drop_pending([comp](const Key& key){ return key.comp == comp; });
+    }
+
+    template<class Func>
+    void drop_pending(const Func& predicate)
+    {
+        pending.erase(std::remove_if(pending.begin(), pending.end(), predicate), pending.end());
+        if ( pending.empty() )
+            prefetch_timer.stop();
+    }
+
+    void track(Composition* comp)
+    {
+        if ( !tracked_comps.insert(comp).second )
+            return;
+
+        QObject::connect(comp, &QObject::destroyed, parent, [this, comp]{
+            invalidate(comp);
+            tracked_comps.erase(comp);
+        });
+
+        Document* document = comp->document();
+        if ( !tracked_documents.insert(document).second )
+            return;
+
+        // Changing the current time updates property values, which
+        // emits graphics_invalidated() without the graphics actually changing
+        QObject::connect(document, &Document::current_time_changing, parent, [this, document]{
+            changing_time.insert(document);
+        });
+        QObject::connect(document, &Document::current_time_changed, parent, [this, document]{
+            changing_time.erase(document);
+        });
+        QObject::connect(document, &Document::graphics_invalidated, parent, [this, document]{
+            if ( !changing_time.count(document) )
+                invalidate(document);
+        });
+        // Editing keyframes away from the current time doesn't invalidate the graphics
+        QObject::connect(document, &Document::keyframes_changed, parent, [this, document]{
+            invalidate(document);
+        });
+        QObject::connect(document, &QObject::destroyed, parent, [this, document]{
+            invalidate(document);
+            tracked_documents.erase(document);
+            changing_time.erase(document);
+        });
+    }
+
+    void prefetch_next()
+    {
+        while ( !pending.empty() )
+        {
+            Key key = pending.front();
+            pending.pop_front();
+
+            // Stop before prefetched frames start evicting each other
+            qint64 bytes = key.bytes();
+            if ( prefetched_bytes + bytes > memory_budget )
+                break;
+            prefetched_bytes += bytes;
+
+            if ( find(key) )
+                continue;
+
+            // Render a single frame per event loop iteration
+            render(key);
+            if ( !pending.empty() )
+                return;
+        }
+
+        pending.clear();
+        prefetch_timer.stop();
+    }
+
+    FrameCache* parent;
+    qint64 memory_budget;
+    qint64 memory_usage = 0;
+    std::list<Entry> entries;
+    std::map<Key, std::list<Entry>::iterator> index;
+    QImage uncached;
+    std::unique_ptr<renderer::Renderer> renderer;
+
+    QTimer prefetch_timer;
+    std::deque<Key> pending;
+    qint64 prefetched_bytes = 0;
+
+    std::unordered_set<Composition*> tracked_comps;
+    std::unordered_set<Document*> tracked_documents;
+    std::unordered_set<Document*> changing_time;
+};
+
+glaxnimate::model::FrameCache::FrameCache(qint64 memory_budget, QObject* parent)
+    : QObject(parent), d(std::make_unique<Private>(this, memory_budget))
+{
+}
+
+glaxnimate::model::FrameCache::~FrameCache() = default;
+
+QImage glaxnimate::model::FrameCache::frame(Composition* comp, FrameTime time, QSize size, const QColor& background)
+{
+    auto key = d->key(comp, time, size, background);
+    if ( auto image = d->find(key) )
+        return *image;
+    return d->render(key);
+}
+
+bool glaxnimate::model::FrameCache::contains(Composition* comp, FrameTime time, QSize size, const QColor& background) const
+{
+    return d->index.count(d->key(comp, time, size, background));
+}
+
+void glaxnimate::model::FrameCache::prefetch(Composition* comp, FrameTime time, int count, QSize size, const QColor& background)
+{
+    d->pending.clear();
+    d->prefetched_bytes = 0;
+
+    FrameTime first = comp->animation->first_frame.get();
+    FrameTime last = comp->animation->last_frame.get();
+    bool wrap = last >= first;
+    if ( wrap )
+        count = qMin(count, int(last - first + 1));
+
+    for ( int i = 0; i < count; i++ )
+    {
+        FrameTime frame = time + i;
+        if ( wrap && (frame > last || frame < first) )
+            frame = first + std::fmod(frame - first, last - first + 1);
+        d->pending.push_back(d->key(comp, frame, size, background));
+    }
+
+    if ( d->pending.empty() )
+        d->prefetch_timer.stop();
+    else
+        d->prefetch_timer.start();
+}
+
+void glaxnimate::model::FrameCache::stop_prefetch()
+{
+    d->pending.clear();
+    d->prefetch_timer.stop();
+}
+
+qint64 glaxnimate::model::FrameCache::memory_budget() const
+{
+    return d->memory_budget;
+}
+
+void glaxnimate::model::FrameCache::set_memory_budget(qint64 bytes)
+{
+    d->memory_budget = bytes;
+    d->evict();
+}
+
+qint64 glaxnimate::model::FrameCache::memory_usage() const
+{
+    return d->memory_usage;
+}
+
+int glaxnimate::model::FrameCache::size() const
+{
+    return d->entries.size();
+}
+
+void glaxnimate::model::FrameCache::invalidate(Document* document)
+{
+    d->invalidate(document);
+}
+
+void glaxnimate::model::FrameCache::invalidate(Composition* comp)
+{
+    d->invalidate(comp);
+}
+
+void glaxnimate::model::FrameCache::clear()
+{
+    d->entries.clear();
+    d->index.clear();
+    d->memory_usage = 0;
+    stop_prefetch();
+}
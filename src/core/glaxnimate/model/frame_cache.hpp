@@ -0,0 +1,108 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QImage>
+#include <QColor>
+
+#include "glaxnimate/model/animation/frame_time.hpp"
+
+namespace glaxnimate::model {
+
+class Composition;
+class Document;
+
+/**
+ * \brief Least recently used cache of rendered composition frames
+ *
+ * Frames are keyed by composition, time, size and background and the cache
+ * holds at most memory_budget() bytes of image data.
+ *
+ * Cached frames of a document are dropped when its graphics or keyframes change,
+ * moving the current time of the document doesn't invalidate anything.
+ *
+ * Prefetching renders frames one at a time from the event loop so the cache
+ * fills up while the application is idle without ever rendering while
+ * the document is being modified.
+ *
+ * Frames are rendered with VisualNode::Render at composition coordinates,
+ * so this is meant for players and previews. The editor canvas paints
+ * hidden-from-render nodes and works in view coordinates so it doesn't use it.
+ */
+class FrameCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameCache(qint64 memory_budget = 512 * 1024 * 1024, QObject* parent = nullptr);
+    ~FrameCache();
+
+    /**
+     * \brief Returns the rendered frame, rendering it if not cached
+     * \see Composition::render_image()
+     */
+    QImage frame(Composition* comp, FrameTime time, QSize size = {}, const QColor& background = {});
+
+    /**
+     * \brief Whether the given frame can be returned without rendering
+     */
+    bool contains(Composition* comp, FrameTime time, QSize size = {}, const QColor& background = {}) const;
+
+    /**
+     * \brief Starts rendering \p count frames starting from \p time in the background
+     *
+     * Frames wrap around the animation range of \p comp.
+     * Replaces any previous prefetch request.
+     */
+    void prefetch(Composition* comp, FrameTime time, int count, QSize size = {}, const QColor& background = {});
+
+    /**
+     * \brief Stops any pending prefetch
+     */
+    void stop_prefetch();
+
+    qint64 memory_budget() const;
+
+    /**
+     * \brief Changes the memory budget, evicting frames if needed
+     */
+    void set_memory_budget(qint64 bytes);
+
+    /**
+     * \brief Bytes of image data currently in the cache
+     */
+    qint64 memory_usage() const;
+
+    /**
+     * \brief Number of frames in the cache
+     */
+    int size() const;
+
+    /**
+     * \brief Drops all the frames of \p document
+     */
+    void invalidate(Document* document);
+
+    /**
+     * \brief Drops all the frames of \p comp
+     */
+    void invalidate(Composition* comp);
+
+    /**
+     * \brief Drops all the frames
+     */
+    void clear();
+
+private:
+    class Private;
+    std::unique_ptr<Private> d;
+};
+
+} // namespace glaxnimate::model
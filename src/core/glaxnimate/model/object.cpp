@@ -71,13 +71,17 @@ void glaxnimate::model::Object::clone_into(glaxnimate::model::Object* dest) cons
 
 void glaxnimate::model::Object::property_value_changed(const BaseProperty* prop, const QVariant& value)
 {
+    bool visual = prop->traits().flags & PropertyTraits::Visual;
+
+    // Invalidated before any other notification so the nodes reacting to the
+    // change are known to be the ones it affects
+    if ( visual )
+        d->document->graphics_invalidated();
+
     on_property_changed(prop, value);
     Q_EMIT property_changed(prop, value);
-    if ( prop->traits().flags & PropertyTraits::Visual )
-    {
-        d->document->graphics_invalidated();
+    if ( visual )
         Q_EMIT visual_property_changed(prop, value);
-    }
 }
 
 void glaxnimate::model::Object::add_property(glaxnimate::model::BaseProperty* prop)
@@ -156,9 +156,9 @@ public:                                                     \
     GLAXNIMATE_PROPERTY_IMPL(type, name)                    \
     // macro end
 
-#define GLAXNIMATE_PROPERTY_RO(type, name, default_value)   \
+#define GLAXNIMATE_PROPERTY_RO(type, name, default_value, emitter) \
 public:                                                     \
-    Property<type> name{this, kli18n(#name), default_value, {}, {}, PropertyTraits::ReadOnly}; \
+    Property<type> name{this, kli18n(#name), default_value, emitter, {}, PropertyTraits::ReadOnly}; \
     type get_##name() const { return name.get(); }          \
 private:                                                    \
     Q_PROPERTY(type name READ get_##name)                   \
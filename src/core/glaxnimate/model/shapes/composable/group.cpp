@@ -30,6 +30,13 @@ QRectF glaxnimate::model::Group::local_bounding_rect(FrameTime t) const
     return shapes.bounding_rect(t);
 }
 
+QRectF glaxnimate::model::Group::local_conservative_bounding_rect(FrameTime t) const
+{
+    if ( shapes.empty() )
+        return owner_composition()->rect();
+    return shapes.bounding_rect(t, Conservative);
+}
+
 QTransform glaxnimate::model::Group::local_transform_matrix(glaxnimate::model::FrameTime t) const
 {
     return transform.get()->transform_matrix(t);
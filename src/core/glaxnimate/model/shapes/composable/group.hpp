@@ -48,6 +48,7 @@ public:
 
 protected:
     glaxnimate::math::bezier::MultiBezier to_painter_path_impl(model::FrameTime t) const override;
+    QRectF local_conservative_bounding_rect(FrameTime t) const override;
     void on_graphics_changed() override;
     void on_composition_changed(model::Composition* old_comp, model::Composition* new_comp) override;
 };
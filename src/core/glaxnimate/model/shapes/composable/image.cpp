@@ -52,6 +52,7 @@ void glaxnimate::model::Image::on_image_changed(glaxnimate::model::Bitmap* new_u
 
 void glaxnimate::model::Image::on_update_image()
 {
+    propagate_bounding_rect_changed();
     Q_EMIT property_changed(&image, {});
 }
 
@@ -78,6 +79,6 @@ glaxnimate::math::bezier::MultiBezier glaxnimate::model::Image::to_painter_path_
 {
     auto trans = transform.get()->transform_matrix(time);
     glaxnimate::math::bezier::MultiBezier p;
-    p.append(trans.map(QRectF(QPointF(0, 0), image.get() ? image->pixmap().size() : QSize(0, 0))));
+    p.append(trans.map(QRectF(QPointF(0, 0), image.get() ? image->size() : QSize(0, 0))));
     return p;
 }
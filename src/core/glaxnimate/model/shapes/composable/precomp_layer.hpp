@@ -20,7 +20,7 @@ class PreCompLayer : public Composable
 
     GLAXNIMATE_SUBOBJECT(StretchableTime, timing)
     GLAXNIMATE_PROPERTY_REFERENCE(Composition, composition, &PreCompLayer::valid_precomps, &PreCompLayer::is_valid_precomp, &PreCompLayer::composition_changed)
-    GLAXNIMATE_PROPERTY(QSizeF, size, {})
+    GLAXNIMATE_PROPERTY(QSizeF, size, {}, {}, {}, PropertyTraits::Visual)
     GLAXNIMATE_PROPERTY(bool, unbounded, false, {}, {}, PropertyTraits::Visual)
 
 public:
@@ -5,6 +5,13 @@
  */
 
 #include "glaxnimate/model/shapes/modifiers/offset_path.hpp"
+
+#include <QCoreApplication>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QHash>
+
 #include "glaxnimate/math/geom.hpp"
 #include "glaxnimate/math/vector.hpp"
 
@@ -132,10 +139,34 @@ static QPointF join_lines(
 }
 
 
+/*
+    Whether the boxes around the control points overlap,
+    the curves are within them so they can't intersect otherwise
+*/
+static bool control_boxes_overlap(const CubicBezierSolver<QPointF>& a, const CubicBezierSolver<QPointF>& b)
+{
+    auto box = [](const CubicBezierSolver<QPointF>& seg){
+        const auto& p = seg.points();
+        return std::make_pair(
+            QPointF(std::min({p[0].x(), p[1].x(), p[2].x(), p[3].x()}), std::min({p[0].y(), p[1].y(), p[2].y(), p[3].y()})),
+            QPointF(std::max({p[0].x(), p[1].x(), p[2].x(), p[3].x()}), std::max({p[0].y(), p[1].y(), p[2].y(), p[3].y()}))
+        );
+    };
+
+    auto box_a = box(a);
+    auto box_b = box(b);
+    return box_a.first.x() <= box_b.second.x() && box_b.first.x() <= box_a.second.x() &&
+           box_a.first.y() <= box_b.second.y() && box_b.first.y() <= box_a.second.y();
+}
+
 static std::optional<std::pair<float, float>> get_intersection(
     const CubicBezierSolver<QPointF>&a,
     const CubicBezierSolver<QPointF>& b)
 {
+    // Finding intersections needs the exact bounds of each subdivision, this skips most segments cheaply
+    if ( !control_boxes_overlap(a, b) )
+        return {};
+
     auto intersect = a.intersections(b, 2, 3, 7);
 
     std::size_t i = 0;
@@ -267,71 +298,153 @@ static std::vector<math::bezier::CubicBezierSolver<QPointF>> offset_segment_spli
     return offset;
 }
 
-static MultiBezier offset_path(
-    // Beziers as collected from the other shapes
-    const MultiBezier& collected_shapes,
+static Bezier offset_bezier(
+    const Bezier& input_bezier,
     float amount,
     model::Stroke::Join line_join,
     float miter_limit
 )
 {
-    MultiBezier result;
+    int count = input_bezier.segment_count();
+    Bezier output_bezier;
 
-    for ( const auto& input_bezier : collected_shapes.beziers() )
-    {
-        int count = input_bezier.segment_count();
-        Bezier output_bezier;
+    output_bezier.set_closed(input_bezier.closed());
 
-        output_bezier.set_closed(input_bezier.closed());
+    std::vector<std::vector<math::bezier::CubicBezierSolver<QPointF>>> multi_segments;
+    for ( int i = 0; i < count; i++ )
+        multi_segments.push_back(offset_segment_split(input_bezier.segment(i), amount));
 
-        std::vector<std::vector<math::bezier::CubicBezierSolver<QPointF>>> multi_segments;
-        for ( int i = 0; i < count; i++ )
-            multi_segments.push_back(offset_segment_split(input_bezier.segment(i), amount));
+    // Open paths are stroked rather than being simply offset
+    if ( !input_bezier.closed() )
+    {
+        for ( int i = count - 1; i >= 0; i-- )
+            multi_segments.push_back(offset_segment_split(input_bezier.inverted_segment(i), amount));
+    }
 
-        // Open paths are stroked rather than being simply offset
-        if ( !input_bezier.closed() )
-        {
-            for ( int i = count - 1; i >= 0; i-- )
-                multi_segments.push_back(offset_segment_split(input_bezier.inverted_segment(i), amount));
-        }
+    prune_intersections(multi_segments);
+
+    // Add bezier segments to the output and apply line joints
+    QPointF last_point;
+    const math::bezier::CubicBezierSolver<QPointF>* last_seg = nullptr;
 
-        prune_intersections(multi_segments);
+    for ( const auto& multi_segment : multi_segments )
+    {
+        if ( last_seg )
+            last_point = join_lines(output_bezier, *last_seg, multi_segment[0], line_join, miter_limit * amount);
 
-        // Add bezier segments to the output and apply line joints
-        QPointF last_point;
-        const math::bezier::CubicBezierSolver<QPointF>* last_seg = nullptr;
+        last_seg = &multi_segment.back();
 
-        for ( const auto& multi_segment : multi_segments )
+        for ( const auto& segment : multi_segment )
         {
-            if ( last_seg )
-                last_point = join_lines(output_bezier, *last_seg, multi_segment[0], line_join, miter_limit * amount);
+            if ( !point_fuzzy_compare(segment.points()[0], last_point) || output_bezier.empty() )
+                output_bezier.add_point(segment.points()[0]);
 
-            last_seg = &multi_segment.back();
+            output_bezier.back().tan_out = segment.points()[1];
 
-            for ( const auto& segment : multi_segment )
-            {
-                if ( !point_fuzzy_compare(segment.points()[0], last_point) || output_bezier.empty() )
-                    output_bezier.add_point(segment.points()[0]);
 
-                output_bezier.back().tan_out = segment.points()[1];
+            output_bezier.add_point(segment.points()[3]);
+            output_bezier.back().tan_in = segment.points()[2];
 
+            last_point = segment.points()[3];
+        }
+    }
 
-                output_bezier.add_point(segment.points()[3]);
-                output_bezier.back().tan_in = segment.points()[2];
+    if ( !multi_segments.empty() )
+        join_lines(output_bezier, *last_seg, multi_segments[0][0], line_join, miter_limit * amount);
 
-                last_point = segment.points()[3];
-            }
-        }
+    return output_bezier;
+}
+
+static MultiBezier offset_path(
+    // Beziers as collected from the other shapes
+    const MultiBezier& collected_shapes,
+    float amount,
+    model::Stroke::Join line_join,
+    float miter_limit
+)
+{
+    const auto& input = collected_shapes.beziers();
+    MultiBezier result;
+    result.beziers().resize(input.size());
+
+    int segments = 0;
+    for ( const auto& input_bezier : input )
+        segments += input_bezier.segment_count();
+
+    // Starting threads only pays off for detailed paths (eg: traced images),
+    // off the main thread frames are already being rendered in parallel
+    constexpr int min_parallel_segments = 256;
+    auto app = QCoreApplication::instance();
+    auto pool = QThreadPool::globalInstance();
+    int threads = std::min<int>(input.size(), pool->maxThreadCount() + 1);
+    if ( threads <= 1 || segments < min_parallel_segments || !app || QThread::currentThread() != app->thread() )
+    {
+        for ( std::size_t i = 0; i < input.size(); i++ )
+            result.beziers()[i] = offset_bezier(input[i], amount, line_join, miter_limit);
+        return result;
+    }
 
-        if ( !multi_segments.empty() )
-            join_lines(output_bezier, *last_seg, multi_segments[0][0], line_join, miter_limit * amount);
+    // Each chunk writes its own beziers so the output doesn't depend on scheduling
+    auto process_chunk = [&input, &result, threads, amount, line_join, miter_limit](int chunk){
+        for ( std::size_t i = chunk; i < input.size(); i += threads )
+            result.beziers()[i] = offset_bezier(input[i], amount, line_join, miter_limit);
+    };
 
-        result.beziers().push_back(output_bezier);
+    // The global pool is shared so we wait for our own chunks only
+    QSemaphore done;
+    for ( int chunk = 1; chunk < threads; chunk++ )
+    {
+        pool->start([&process_chunk, &done, chunk]{
+            process_chunk(chunk);
+            done.release();
+        });
     }
+    process_chunk(0);
+    done.acquire(threads - 1);
 
     return result;
 }
 
+static std::size_t path_hash(const MultiBezier& bez)
+{
+    std::size_t hash = bez.beziers().size();
+    for ( const auto& sub : bez.beziers() )
+    {
+        hash = qHashMulti(hash, sub.closed(), sub.size());
+        for ( const auto& point : sub.points() )
+            hash = qHashMulti(hash, point.pos.x(), point.pos.y(), point.tan_in.x(), point.tan_in.y(), point.tan_out.x(), point.tan_out.y());
+    }
+    return hash;
+}
+
+static bool same_path(const MultiBezier& a, const MultiBezier& b)
+{
+    if ( a.beziers().size() != b.beziers().size() )
+        return false;
+
+    for ( std::size_t i = 0; i < a.beziers().size(); i++ )
+    {
+        const auto& sub_a = a.beziers()[i];
+        const auto& sub_b = b.beziers()[i];
+        if ( sub_a.closed() != sub_b.closed() || sub_a.size() != sub_b.size() )
+            return false;
+
+        for ( int j = 0; j < sub_a.size(); j++ )
+        {
+            if ( sub_a[j].pos != sub_b[j].pos || sub_a[j].tan_in != sub_b[j].tan_in || sub_a[j].tan_out != sub_b[j].tan_out )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool glaxnimate::model::OffsetPath::CacheKey::operator==(const CacheKey& other) const
+{
+    return hash == other.hash && amount == other.amount && miter_limit == other.miter_limit &&
+           join == other.join && same_path(input, other.input);
+}
+
 QIcon glaxnimate::model::OffsetPath::static_tree_icon()
 {
     return QIcon::fromTheme("path-offset-dynamic");
@@ -360,5 +473,8 @@ glaxnimate::math::bezier::MultiBezier glaxnimate::model::OffsetPath::process(
     if ( qFuzzyIsNull(amount) )
         return mbez;
 
-    return offset_path(mbez, amount, join.get(), miter_limit.get_at(t));
+    CacheKey key{mbez, path_hash(mbez), amount, miter_limit.get_at(t), join.get()};
+    return cache.get(key, [&key]{
+        return offset_path(key.input, key.amount, key.join, key.miter_limit);
+    });
 }
@@ -26,9 +26,28 @@ public:
 
     math::bezier::MultiBezier process(FrameTime t, const math::bezier::MultiBezier& mbez) const override;
 
+    /**
+     * \brief Number of times the offset has been computed rather than reused from the cache
+     */
+    quint64 computed_count() const { return cache.misses(); }
+
 protected:
     bool process_collected() const override;
 
+private:
+    struct CacheKey
+    {
+        math::bezier::MultiBezier input;
+        std::size_t hash;
+        float amount;
+        float miter_limit;
+        Stroke::Join join;
+
+        bool operator==(const CacheKey& other) const;
+    };
+
+    /// Keyed by the input rather than the time so frames where nothing changes reuse the result
+    mutable PathCache<math::bezier::MultiBezier, CacheKey> cache;
 };
 
 } // namespace glaxnimate::model
@@ -7,6 +7,7 @@
 #include "glaxnimate/model/shapes/shape.hpp"
 #include "glaxnimate/utils/range.hpp"
 #include "glaxnimate/model/shapes/style/styler.hpp"
+#include "glaxnimate/model/shapes/composable/composable.hpp"
 #include "glaxnimate/model/shapes/shapes/path.hpp"
 #include "glaxnimate/model/animation/join_animatables.hpp"
 
@@ -76,6 +77,46 @@ glaxnimate::model::ObjectListProperty<glaxnimate::model::ShapeElement>::iterator
     return it;
 }
 
+bool glaxnimate::model::ShapeElement::affected_by_operator() const
+{
+    if ( !d->property )
+        return false;
+
+    for ( const auto& sibling : *d->property )
+    {
+        if ( auto op = sibling->cast<ShapeOperator>() )
+        {
+            const auto& affected = op->affected();
+            if ( std::find(affected.begin(), affected.end(), this) != affected.end() )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+glaxnimate::model::VisualNode* glaxnimate::model::ShapeElement::drawing_root()
+{
+    VisualNode* node = this;
+    while ( !node->is_instance<Composable>() )
+    {
+        auto parent = node->docnode_visual_parent();
+        if ( !parent )
+            return node;
+        node = parent;
+    }
+
+    while ( auto shape = node->cast<ShapeElement>() )
+    {
+        auto parent = shape->docnode_visual_parent();
+        if ( !parent || !shape->affected_by_operator() )
+            break;
+        node = parent;
+    }
+
+    return node;
+}
+
 void glaxnimate::model::ShapeElement::refresh_owner_composition(glaxnimate::model::Composition* comp)
 {
     d->update_comp(comp, this);
@@ -131,14 +172,13 @@ glaxnimate::math::bezier::MultiBezier glaxnimate::model::ShapeElement::to_clip(F
 
 glaxnimate::math::bezier::MultiBezier glaxnimate::model::ShapeElement::to_painter_path(FrameTime t) const
 {
-    if ( d->cached_path.is_dirty(t) )
-        d->cached_path.set_path(t, to_painter_path_impl(t));
-    return d->cached_path.path();
+    return d->cached_path.get(t, [this, t]{ return to_painter_path_impl(t); });
 }
 
 void glaxnimate::model::ShapeElement::on_graphics_changed()
 {
     d->cached_path.mark_dirty();
+    clear_bounding_rect_cache();
 }
 
 std::unique_ptr<glaxnimate::model::ShapeElement> glaxnimate::model::ShapeElement::to_path() const
@@ -146,12 +186,12 @@ std::unique_ptr<glaxnimate::model::ShapeElement> glaxnimate::model::ShapeElement
     return std::unique_ptr<glaxnimate::model::ShapeElement>(static_cast<glaxnimate::model::ShapeElement*>(clone().release()));
 }
 
-QRectF glaxnimate::model::ShapeListProperty::bounding_rect(FrameTime t) const
+QRectF glaxnimate::model::ShapeListProperty::bounding_rect(FrameTime t, VisualNode::BoundingRectMode mode) const
 {
     QRectF rect;
     for ( const auto& ch : utils::Range(begin(), past_first_modifier()) )
     {
-        QRectF local_rect = ch->local_bounding_rect(t);
+        QRectF local_rect = ch->cached_local_bounding_rect(t, mode);
         if ( local_rect.isNull() )
             continue;
 
@@ -249,9 +289,9 @@ math::bezier::MultiBezier glaxnimate::model::ShapeOperator::collect_shapes_from(
 
 math::bezier::MultiBezier glaxnimate::model::ShapeOperator::collect_shapes(FrameTime t, const QTransform& transform) const
 {
-    if ( bezier_cache.is_dirty(t) )
-        bezier_cache.set_path(t, collect_shapes_from(affected_elements, t, transform));
-    return bezier_cache.path();
+    return bezier_cache.get({t, transform}, [this, t, &transform]{
+        return collect_shapes_from(affected_elements, t, transform);
+    });
 }
 
 void glaxnimate::model::ShapeOperator::update_affected()
@@ -329,4 +369,9 @@ QRectF glaxnimate::model::Modifier::local_bounding_rect(glaxnimate::model::Frame
     return to_painter_path(t).bounding_box();
 }
 
+QRectF glaxnimate::model::Modifier::local_conservative_bounding_rect(glaxnimate::model::FrameTime t) const
+{
+    return to_painter_path(t).control_box();
+}
+
 
@@ -6,6 +6,11 @@
 
 #pragma once
 
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
 #include "glaxnimate/model/document_node.hpp"
 #include "glaxnimate/math/bezier/bezier.hpp"
 #include "glaxnimate/model/property/object_list_property.hpp"
@@ -15,30 +20,83 @@ namespace glaxnimate::model {
 using ShapeListProperty = ObjectListProperty<class ShapeElement>;
 class Composition;
 
-template<class T>
+/**
+ * \brief Cache for paths evaluated at a given time
+ *
+ * It keeps the most recently used entries so frames evaluated concurrently
+ * don't keep evicting each other.
+ * Access is guarded so multiple threads can render the same node at once.
+ */
+template<class T, class Key = FrameTime>
 class PathCache
 {
 public:
-    bool is_dirty(FrameTime time) const
+    explicit PathCache(int capacity = 4) : capacity(capacity) {}
+
+    void mark_dirty()
     {
-        return time != cached_time || dirty;
+        std::lock_guard lock(mutex);
+        entries.clear();
+        ++generation;
     }
 
-    void mark_dirty() { dirty = true; }
-
-    const T& path() const { return cached_path; }
+    /**
+     * \brief Returns the cached path for \p key, calling \p compute if it isn't available
+     */
+    template<class Func>
+    T get(const Key& key, const Func& compute)
+    {
+        quint64 compute_generation;
+        {
+            std::lock_guard lock(mutex);
+            if ( auto found = find(key) )
+                return *found;
+            compute_generation = generation;
+        }
+
+        // Computed without holding the lock as it might recurse into other caches
+        T path = compute();
+        ++miss_count;
+
+        std::lock_guard lock(mutex);
+        // Results from before mark_dirty() are discarded
+        if ( compute_generation == generation && !find(key) )
+        {
+            if ( int(entries.size()) >= capacity )
+                entries.pop_back();
+            entries.emplace(entries.begin(), key, path);
+        }
+        return path;
+    }
 
-    void set_path(FrameTime time, const T& path)
+    /**
+     * \brief Number of times get() had to compute the path
+     */
+    quint64 misses() const
     {
-        cached_time = time;
-        dirty = false;
-        cached_path = path;
+        return miss_count;
     }
 
 private:
-    bool dirty = true;
-    T cached_path = {};
-    FrameTime cached_time = 0;
+    const T* find(const Key& key)
+    {
+        for ( auto it = entries.begin(); it != entries.end(); ++it )
+        {
+            if ( it->first == key )
+            {
+                // Most recently used goes first
+                std::rotate(entries.begin(), it, it + 1);
+                return &entries.front().second;
+            }
+        }
+        return nullptr;
+    }
+
+    std::mutex mutex;
+    std::vector<std::pair<Key, T>> entries;
+    quint64 generation = 0;
+    std::atomic<quint64> miss_count{0};
+    int capacity;
 };
 
 /**
@@ -72,6 +130,19 @@ public:
     glaxnimate::math::bezier::MultiBezier to_painter_path(FrameTime t) const;
     virtual std::unique_ptr<ShapeElement> to_path() const;
 
+    /**
+     * \brief Whether an operator in the same list uses this as part of its geometry
+     */
+    bool affected_by_operator() const;
+
+    /**
+     * \brief Closest ancestor whose bounding rect covers everything drawn from this shape
+     *
+     * Shapes are drawn by the styles in their group and groups can be drawn
+     * by operators (eg: Repeater, Stroke) in the enclosing group.
+     */
+    VisualNode* drawing_root();
+
 Q_SIGNALS:
     void position_updated();
     void siblings_changed();
@@ -110,7 +181,10 @@ public:
      */
     iterator past_first_modifier() const;
 
-    QRectF bounding_rect(FrameTime t) const;
+    /**
+     * \brief Union of the children bounding rects in the parent coordinates
+     */
+    QRectF bounding_rect(FrameTime t, VisualNode::BoundingRectMode mode = VisualNode::Tight) const;
 
 protected:
     void update_pos(int index)
@@ -197,7 +271,7 @@ Q_SIGNALS:
 
 private:
     std::vector<ShapeElement*> affected_elements;
-    mutable PathCache<math::bezier::MultiBezier> bezier_cache;
+    mutable PathCache<math::bezier::MultiBezier, std::pair<FrameTime, QTransform>> bezier_cache;
 };
 
 /**
@@ -219,6 +293,7 @@ public:
 
 protected:
     glaxnimate::math::bezier::MultiBezier to_painter_path_impl(FrameTime t) const override;
+    QRectF local_conservative_bounding_rect(FrameTime t) const override;
 
     /**
      * \brief Whether to process on the whole thing (or individual objects)
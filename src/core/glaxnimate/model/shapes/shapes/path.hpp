@@ -53,6 +53,12 @@ public:
         return shape.get_at(t).bounding_box();
     }
 
+protected:
+    QRectF local_conservative_bounding_rect(FrameTime t) const override
+    {
+        return shape.get_at(t).control_box();
+    }
+
 private:
     void closed_changed(bool closed)
     {
@@ -6,6 +6,8 @@
 
 #include "glaxnimate/model/shapes/shapes/text.hpp"
 
+#include <mutex>
+
 #include <QTextLayout>
 #include <QFontInfo>
 #include <QMetaEnum>
@@ -16,6 +18,7 @@
 #include "glaxnimate/model/assets/assets.hpp"
 #include "glaxnimate/model/custom_font.hpp"
 #include "glaxnimate/math/bezier/bezier_length.hpp"
+#include "glaxnimate/model/shapes/shapes/text_cache.hpp"
 
 GLAXNIMATE_OBJECT_IMPL(glaxnimate::model::Font)
 GLAXNIMATE_OBJECT_IMPL(glaxnimate::model::TextShape)
@@ -39,6 +42,7 @@ public:
 #endif
 //         query.setKerning(false);
         upscaled_raw();
+        update_cache_key();
     }
 
     void update_data()
@@ -63,6 +67,7 @@ public:
 
         metrics = QFontMetricsF(query);
         upscaled_raw();
+        update_cache_key();
     }
 
     static const QStringList& default_styles()
@@ -108,18 +113,39 @@ public:
         raw_scaled = QRawFont::fromFont(font);
     }
 
-    glaxnimate::math::bezier::MultiBezier path_for_glyph(quint32  glyph, bool fix_paint)
+    /**
+     * \brief Font data for a given cache key
+     *
+     * Copied so glyphs and layouts can be built without holding the mutex
+     * during cache lookups and still match the key if the font changes meanwhile
+     */
+    struct Snapshot
+    {
+        QString cache_key;
+        QFont query;
+        QRawFont raw;
+        QRawFont raw_scaled;
+        QFontMetricsF metrics;
+    };
+
+    Snapshot snapshot()
+    {
+        std::lock_guard lock(mutex);
+        return {cache_key, query, raw, raw_scaled, metrics};
+    }
+
+    static glaxnimate::math::bezier::MultiBezier path_for_glyph(const Snapshot& font, quint32  glyph, bool fix_paint)
     {
-        QPainterPath path = raw_scaled.pathForGlyph(glyph);
+        QPainterPath path = font.raw_scaled.pathForGlyph(glyph);
 
         if ( fix_paint )
             path = path.simplified();
 
-        if ( raw_scaled.pixelSize() == 0 )
+        if ( font.raw_scaled.pixelSize() == 0 )
             return path;
 
         glaxnimate::math::bezier::MultiBezier dest;
-        qreal mult = raw.pixelSize() / raw_scaled.pixelSize();
+        qreal mult = font.raw.pixelSize() / font.raw_scaled.pixelSize();
 
         std::array<QPointF, 3> data;
         int data_i = 0;
@@ -153,6 +179,97 @@ public:
 
         return dest;
     }
+
+    static ParagraphData layout(const Snapshot& font, const QString& text, qreal line_spacing)
+    {
+        ParagraphData para_data;
+
+        auto lines = text.split('\n');
+        QTextLayout layout(text, font.query, nullptr);
+
+        QTextOption option;
+        option.setUseDesignMetrics(true);
+        layout.setTextOption(option);
+        layout.beginLayout();
+        for ( const auto& line_size : lines )
+        {
+            QTextLine line = layout.createLine();
+            if ( !line.isValid() )
+                break;
+            line.setNumColumns(line_size.size());
+            line.setLeadingIncluded(true);
+        }
+        layout.endLayout();
+
+        qreal line_y = 0;
+        qreal yoff = -font.metrics.ascent();
+
+        for ( int ln = 0; ln < layout.lineCount(); ln++ )
+        {
+            QTextLine line = layout.lineAt(ln);
+
+            auto& line_data = para_data.emplace_back();
+            line_data.baseline = QPointF(0, line_y);
+            line_data.bounds = line.rect();
+            line_data.text = lines[ln];
+
+            QPointF baseline(0, line_y + yoff);
+            for ( const auto& run : line.glyphRuns() )
+            {
+                auto glyphs = run.glyphIndexes();
+                line_data.glyphs.reserve(line_data.glyphs.size() + glyphs.size());
+                auto positions = run.positions();
+                for ( int i = 0; i < glyphs.size(); i++ )
+                {
+                    line_data.glyphs.push_back({
+                        glyphs[i],
+                        positions[i] + baseline
+                    });
+                }
+            }
+
+            line_data.advance = QPointF(line.cursorToX(lines[ln].size()), 0);
+
+            line_y += line_spacing;
+        }
+
+        // QRawFont way: for some reason it ignores KernedAdvances
+        /*
+        qreal line_y = 0;
+        for ( const auto& line : text.split('\n') )
+        {
+            auto glyphs = raw.glyphIndexesForString(line);
+            auto advances = raw.advancesForGlyphIndexes(glyphs, QRawFont::UseDesignMetrics|QRawFont::KernedAdvances);
+
+            auto& line_data = para_data.emplace_back();
+            line_data.glyphs.reserve(glyphs.size());
+            line_data.text = line;
+
+            line_data.baseline = line_data.advance = QPointF(0, line_y);
+            for ( int i = 0; i < glyphs.size(); i++ )
+            {
+                line_data.glyphs.push_back({
+                    glyphs[i],
+                    line_data.advance,
+                });
+                line_data.advance += advances[i];
+            }
+
+            line_y += line_spacing;
+        }
+        */
+        return para_data;
+    }
+
+    void update_cache_key()
+    {
+        cache_key = query.key() + '\n' + raw.familyName() + '\n' + raw.styleName() + '\n' + QString::number(raw.pixelSize());
+    }
+
+    /// Guards the font data, shapes might be evaluated from multiple threads.
+    /// Also held while building glyphs and layouts as copies of a font share its engine
+    std::mutex mutex;
+    QString cache_key;
 };
 
 glaxnimate::model::Font::Font(glaxnimate::model::Document* doc)
@@ -169,8 +286,11 @@ glaxnimate::model::Font::~Font() = default;
 
 void glaxnimate::model::Font::refresh_data ( bool update_styles )
 {
-    d->query = CustomFontDatabase::instance().font(family.get(), style.get(), size.get());
-    d->update_data();
+    {
+        std::lock_guard lock(d->mutex);
+        d->query = CustomFontDatabase::instance().font(family.get(), style.get(), size.get());
+        d->update_data();
+    }
     if ( update_styles )
         d->refresh_styles(this);
     Q_EMIT font_changed();
@@ -231,16 +351,19 @@ QString glaxnimate::model::Font::type_name_human() const
     return i18n("Font");
 }
 
-glaxnimate::math::bezier::MultiBezier glaxnimate::model::Font::path_for_glyph(quint32 glyph, glaxnimate::model::Font::CharDataCache& cache, bool fix_paint) const
+glaxnimate::math::bezier::MultiBezier glaxnimate::model::Font::path_for_glyph(quint32 glyph, bool fix_paint) const
 {
-    auto it = cache.find(glyph);
-
-    if ( it != cache.end() )
-        return it->second;
+    auto font = d->snapshot();
+    return TextCache::instance().glyph(font.cache_key, glyph, fix_paint, [this, &font, glyph, fix_paint]{
+        std::lock_guard lock(d->mutex);
+        return Private::path_for_glyph(font, glyph, fix_paint);
+    });
+}
 
-    glaxnimate::math::bezier::MultiBezier path = d->path_for_glyph(glyph, fix_paint);
-    cache.emplace(glyph, path);
-    return path;
+QString glaxnimate::model::Font::cache_key() const
+{
+    std::lock_guard lock(d->mutex);
+    return d->cache_key;
 }
 
 void glaxnimate::model::Font::from_qfont(const QFont& f)
@@ -256,83 +379,13 @@ void glaxnimate::model::Font::from_qfont(const QFont& f)
 
 glaxnimate::model::Font::ParagraphData glaxnimate::model::Font::layout(const QString& text) const
 {
-    glaxnimate::model::Font::ParagraphData para_data;
-
-    auto lines = text.split('\n');
-    QTextLayout layout(text, d->query, nullptr);
-
-    QTextOption option;
-    option.setUseDesignMetrics(true);
-    layout.setTextOption(option);
-    layout.beginLayout();
-    for ( const auto& line_size : lines )
-    {
-        QTextLine line = layout.createLine();
-        if ( !line.isValid() )
-            break;
-        line.setNumColumns(line_size.size());
-        line.setLeadingIncluded(true);
-    }
-    layout.endLayout();
-
-    qreal line_y = 0;
-    qreal yoff = -d->metrics.ascent();
-
-    for ( int ln = 0; ln < layout.lineCount(); ln++ )
-    {
-        QTextLine line = layout.lineAt(ln);
-
-        auto& line_data = para_data.emplace_back();
-        line_data.baseline = QPointF(0, line_y);
-        line_data.bounds = line.rect();
-        line_data.text = lines[ln];
-
-        QPointF baseline(0, line_y + yoff);
-        for ( const auto& run : line.glyphRuns() )
-        {
-            auto glyphs = run.glyphIndexes();
-            line_data.glyphs.reserve(line_data.glyphs.size() + glyphs.size());
-            auto positions = run.positions();
-            for ( int i = 0; i < glyphs.size(); i++ )
-            {
-                line_data.glyphs.push_back({
-                    glyphs[i],
-                    positions[i] + baseline
-                });
-            }
-        }
-
-        line_data.advance = QPointF(line.cursorToX(lines[ln].size()), 0);
-
-        line_y += line_spacing();
-    }
-
-    // QRawFont way: for some reason it ignores KernedAdvances
-    /*
-    qreal line_y = 0;
-    for ( const auto& line : text.split('\n') )
-    {
-        auto glyphs = d->raw.glyphIndexesForString(line);
-        auto advances = d->raw.advancesForGlyphIndexes(glyphs, QRawFont::UseDesignMetrics|QRawFont::KernedAdvances);
-
-        auto& line_data = para_data.emplace_back();
-        line_data.glyphs.reserve(glyphs.size());
-        line_data.text = line;
-
-        line_data.baseline = line_data.advance = QPointF(0, line_y);
-        for ( int i = 0; i < glyphs.size(); i++ )
-        {
-            line_data.glyphs.push_back({
-                glyphs[i],
-                line_data.advance,
-            });
-            line_data.advance += advances[i];
-        }
-
-        line_y += line_spacing();
-    }
-    */
-    return para_data;
+    auto font = d->snapshot();
+    // Same as line_spacing() but using the metrics matching the cache key
+    qreal spacing = (font.metrics.ascent() + font.metrics.descent()) * line_height.get();
+    return TextCache::instance().layout(font.cache_key, line_height.get(), text, [this, &font, &text, spacing]{
+        std::lock_guard lock(d->mutex);
+        return Private::layout(font, text, spacing);
+    });
 }
 
 qreal glaxnimate::model::Font::line_spacing() const
@@ -371,63 +424,69 @@ glaxnimate::model::TextShape::TextShape(glaxnimate::model::Document* document)
 
 void glaxnimate::model::TextShape::on_text_changed()
 {
-    shape_cache.clear();
+    shape_cache.mark_dirty();
     propagate_bounding_rect_changed();
 }
 
 void glaxnimate::model::TextShape::on_font_changed()
 {
-    cache.clear();
     on_text_changed();
 }
 
-const glaxnimate::math::bezier::MultiBezier & glaxnimate::model::TextShape::untranslated_path(FrameTime t) const
+glaxnimate::math::bezier::MultiBezier glaxnimate::model::TextShape::untranslated_path(FrameTime t) const
+{
+    // Only text following a path changes over time
+    if ( !path.get() )
+        t = 0;
+    return shape_cache.get(t, [this, t]{ return build_untranslated_path(t); });
+}
+
+glaxnimate::math::bezier::MultiBezier glaxnimate::model::TextShape::build_untranslated_path(FrameTime t) const
 {
-    if ( shape_cache.empty() )
+    glaxnimate::math::bezier::MultiBezier shape;
+
+    if ( path.get() )
     {
-        if ( path.get() )
-        {
-            QString txt = text.get();
-            txt.replace('\n', ' ');
-            auto bezier = path->shapes(t);
-            const int length_steps = 5;
+        QString txt = text.get();
+        txt.replace('\n', ' ');
+        auto bezier = path->shapes(t);
+        const int length_steps = 5;
 
-            math::bezier::LengthData length_data(bezier, length_steps);
-            for ( const auto& line : font->layout(txt) )
+        math::bezier::LengthData length_data(bezier, length_steps);
+        for ( const auto& line : font->layout(txt) )
+        {
+            for ( const auto& glyph : line.glyphs )
             {
-                for ( const auto& glyph : line.glyphs )
-                {
-                    qreal x = path_offset.get_at(t) + glyph.position.x();
-                    if ( x > length_data.length() || x < 0 )
-                        continue;
+                qreal x = path_offset.get_at(t) + glyph.position.x();
+                if ( x > length_data.length() || x < 0 )
+                    continue;
 
-                    auto glyph_shape = font->path_for_glyph(glyph.glyph, cache, true);
-                    auto glyph_rect = glyph_shape.bounding_box();
+                auto glyph_shape = font->path_for_glyph(glyph.glyph, true);
+                auto glyph_rect = glyph_shape.bounding_box();
 
-                    auto start1 = length_data.at_length(x);
-                    auto start2 = start1.descend();
-                    auto start_p = bezier.beziers()[start1.index].split_segment_point(start2.index, start2.ratio);
+                auto start1 = length_data.at_length(x);
+                auto start2 = start1.descend();
+                auto start_p = bezier.beziers()[start1.index].split_segment_point(start2.index, start2.ratio);
 
-                    auto end1 = length_data.at_length(x + glyph_rect.width());
-                    auto end2 = end1.descend();
-                    auto end_p = bezier.beziers()[end1.index].split_segment_point(end2.index, end2.ratio);
+                auto end1 = length_data.at_length(x + glyph_rect.width());
+                auto end2 = end1.descend();
+                auto end_p = bezier.beziers()[end1.index].split_segment_point(end2.index, end2.ratio);
 
-                    QTransform mat;
-                    mat.translate(start_p.pos.x(), start_p.pos.y());
-                    mat.rotate(qRadiansToDegrees(math::atan2(end_p.pos.y() - start_p.pos.y(), end_p.pos.x() - start_p.pos.x())));
-                    shape_cache += glyph_shape.transformed(mat);
-                }
+                QTransform mat;
+                mat.translate(start_p.pos.x(), start_p.pos.y());
+                mat.rotate(qRadiansToDegrees(math::atan2(end_p.pos.y() - start_p.pos.y(), end_p.pos.x() - start_p.pos.x())));
+                shape += glyph_shape.transformed(mat);
             }
         }
-        else
-        {
-            for ( const auto& line : font->layout(text.get()) )
-                for ( const auto& glyph : line.glyphs )
-                    shape_cache += font->path_for_glyph(glyph.glyph, cache, true).translated(glyph.position);
-        }
+    }
+    else
+    {
+        for ( const auto& line : font->layout(text.get()) )
+            for ( const auto& glyph : line.glyphs )
+                shape += font->path_for_glyph(glyph.glyph, true).translated(glyph.position);
     }
 
-    return shape_cache;
+    return shape;
 }
 
 
@@ -469,6 +528,11 @@ QRectF glaxnimate::model::TextShape::local_bounding_rect(glaxnimate::model::Fram
     return shape_data(t).bounding_box();
 }
 
+QRectF glaxnimate::model::TextShape::local_conservative_bounding_rect(glaxnimate::model::FrameTime t) const
+{
+    return shape_data(t).control_box();
+}
+
 QString glaxnimate::model::TextShape::type_name_human() const
 {
     return i18n("Text");
@@ -481,8 +545,6 @@ std::unique_ptr<glaxnimate::model::ShapeElement> glaxnimate::model::TextShape::t
     group->group_color.set(group_color.get());
     group->visible.set(visible.get());
 
-    Font::CharDataCache local_cache;
-
     for ( const auto& line : font->layout(text.get()) )
     {
         auto line_group = std::make_unique<glaxnimate::model::Group>(document());
@@ -490,7 +552,7 @@ std::unique_ptr<glaxnimate::model::ShapeElement> glaxnimate::model::TextShape::t
 
         for ( const auto& glyph : line.glyphs )
         {
-            math::bezier::MultiBezier bez = font->path_for_glyph(glyph.glyph, local_cache, false).translated(glyph.position);
+            math::bezier::MultiBezier bez = font->path_for_glyph(glyph.glyph, false).translated(glyph.position);
 
             if ( bez.beziers().size() == 1 )
             {
@@ -45,8 +45,6 @@ public:
 
     using ParagraphData = std::vector<LineData>;
 
-    using CharDataCache = std::unordered_map<quint32, glaxnimate::math::bezier::MultiBezier>;
-
     explicit Font(Document* doc);
     ~Font();
 
@@ -62,6 +60,9 @@ public:
 
     QString type_name_human() const override;
 
+    /**
+     * \brief Lays out \p string, results are shared through TextCache
+     */
     ParagraphData layout(const QString& string) const;
 
     /**
@@ -74,7 +75,19 @@ public:
      */
     qreal line_spacing_unscaled() const;
 
-    glaxnimate::math::bezier::MultiBezier path_for_glyph(quint32 glyph, CharDataCache& cache, bool fix_paint) const;
+    /**
+     * \brief Outline of \p glyph, results are shared through TextCache
+     * \param fix_paint Whether to simplify the outline to fix overlapping contours
+     */
+    glaxnimate::math::bezier::MultiBezier path_for_glyph(quint32 glyph, bool fix_paint) const;
+
+    /**
+     * \brief Identifies the resolved font for caching glyphs and layouts
+     *
+     * It's made of font names, so TextCache is cleared whenever
+     * CustomFontDatabase changes what they can resolve to.
+     */
+    QString cache_key() const;
 
 Q_SIGNALS:
     void font_changed();
@@ -122,18 +135,20 @@ public:
 
 protected:
     glaxnimate::math::bezier::MultiBezier to_painter_path_impl(FrameTime t) const override;
+    QRectF local_conservative_bounding_rect(FrameTime t) const override;
 
 private:
     void on_font_changed();
     void on_text_changed();
-    const glaxnimate::math::bezier::MultiBezier& untranslated_path(FrameTime t) const;
+    glaxnimate::math::bezier::MultiBezier untranslated_path(FrameTime t) const;
 
     std::vector<DocumentNode*> valid_paths() const;
     bool is_valid_path(DocumentNode* node) const;
     void path_changed(model::ShapeElement* new_path, model::ShapeElement* old_path);
 
-    mutable Font::CharDataCache cache;
-    mutable glaxnimate::math::bezier::MultiBezier shape_cache;
+    glaxnimate::math::bezier::MultiBezier build_untranslated_path(FrameTime t) const;
+
+    mutable PathCache<glaxnimate::math::bezier::MultiBezier> shape_cache;
 };
 
 } // namespace glaxnimate::model
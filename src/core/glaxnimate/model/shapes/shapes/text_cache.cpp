@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "glaxnimate/model/shapes/shapes/text_cache.hpp"
+
+#include "glaxnimate/utils/lru_cache.hpp"
+
+using namespace glaxnimate;
+
+namespace {
+
+struct GlyphKey
+{
+    QString font;
+    quint32 glyph;
+    bool fix_paint;
+
+    bool operator==(const GlyphKey& oth) const
+    {
+        return glyph == oth.glyph && fix_paint == oth.fix_paint && font == oth.font;
+    }
+
+    std::size_t hash() const
+    {
+        return qHashMulti(0, font, glyph, fix_paint);
+    }
+};
+
+struct LayoutKey
+{
+    QString font;
+    qreal line_height;
+    QString text;
+
+    bool operator==(const LayoutKey& oth) const
+    {
+        return line_height == oth.line_height && text == oth.text && font == oth.font;
+    }
+
+    std::size_t hash() const
+    {
+        return qHashMulti(0, font, line_height, text);
+    }
+};
+
+qint64 memory_size(const GlyphKey& key, const math::bezier::MultiBezier& value)
+{
+    qint64 size = sizeof(key) + key.font.size() * sizeof(QChar) + sizeof(value);
+    for ( const auto& bez : value.beziers() )
+        size += sizeof(bez) + bez.size() * sizeof(math::bezier::Point);
+    return size;
+}
+
+qint64 memory_size(const LayoutKey& key, const model::Font::ParagraphData& value)
+{
+    qint64 size = sizeof(key) + (key.font.size() + key.text.size()) * sizeof(QChar);
+    for ( const auto& line : value )
+        size += sizeof(line) + line.glyphs.size() * sizeof(model::Font::CharData) + line.text.size() * sizeof(QChar);
+    return size;
+}
+
+} // namespace
+
+class glaxnimate::model::TextCache::Private
+{
+public:
+    template<class Key, class Value, class Func>
+    Value get(utils::LruCache<Key, Value>& store, const Key& key, const Func& build)
+    {
+        return store.get(mutex, key, build, [&key](const Value& value){ return memory_size(key, value); });
+    }
+
+    template<class Store>
+    static Stats stats(const Store& store)
+    {
+        return {store.hits(), store.misses(), store.size(), store.memory_usage()};
+    }
+
+    QMutex mutex;
+    utils::LruCache<GlyphKey, math::bezier::MultiBezier> glyphs{32 * 1024 * 1024};
+    utils::LruCache<LayoutKey, Font::ParagraphData> layouts{16 * 1024 * 1024};
+};
+
+glaxnimate::model::TextCache::TextCache()
+    : d(std::make_unique<Private>())
+{
+}
+
+glaxnimate::model::TextCache::~TextCache() = default;
+
+glaxnimate::model::TextCache& glaxnimate::model::TextCache::instance()
+{
+    static TextCache instance;
+    return instance;
+}
+
+glaxnimate::math::bezier::MultiBezier glaxnimate::model::TextCache::glyph(
+    const QString& font_key, quint32 glyph, bool fix_paint,
+    const std::function<math::bezier::MultiBezier()>& build
+)
+{
+    return d->get(d->glyphs, GlyphKey{font_key, glyph, fix_paint}, build);
+}
+
+glaxnimate::model::Font::ParagraphData glaxnimate::model::TextCache::layout(
+    const QString& font_key, qreal line_height, const QString& text,
+    const std::function<Font::ParagraphData()>& build
+)
+{
+    return d->get(d->layouts, LayoutKey{font_key, line_height, text}, build);
+}
+
+qint64 glaxnimate::model::TextCache::memory_budget(Kind kind) const
+{
+    QMutexLocker lock(&d->mutex);
+    return kind == Glyphs ? d->glyphs.memory_budget() : d->layouts.memory_budget();
+}
+
+void glaxnimate::model::TextCache::set_memory_budget(Kind kind, qint64 bytes)
+{
+    QMutexLocker lock(&d->mutex);
+    if ( kind == Glyphs )
+        d->glyphs.set_memory_budget(bytes);
+    else
+        d->layouts.set_memory_budget(bytes);
+}
+
+glaxnimate::model::TextCache::Stats glaxnimate::model::TextCache::stats(Kind kind) const
+{
+    QMutexLocker lock(&d->mutex);
+    return kind == Glyphs ? Private::stats(d->glyphs) : Private::stats(d->layouts);
+}
+
+void glaxnimate::model::TextCache::reset_stats()
+{
+    QMutexLocker lock(&d->mutex);
+    d->glyphs.reset_stats();
+    d->layouts.reset_stats();
+}
+
+void glaxnimate::model::TextCache::clear()
+{
+    QMutexLocker lock(&d->mutex);
+    d->glyphs.clear();
+    d->layouts.clear();
+}
@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <memory>
+#include <functional>
+
+#include "glaxnimate/model/shapes/shapes/text.hpp"
+
+namespace glaxnimate::model {
+
+/**
+ * \brief Process-wide cache of glyph outlines and paragraph layouts
+ *
+ * Entries are keyed by Font::cache_key() so text shapes using the same font
+ * share them, even across documents.
+ * Each kind of entry has its own memory budget, the least recently used ones
+ * are dropped when it's exceeded and will be built again the next time they are needed.
+ *
+ * All functions are thread-safe.
+ */
+class TextCache
+{
+public:
+    enum Kind
+    {
+        Glyphs,
+        Layouts,
+    };
+
+    struct Stats
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 entries = 0;
+        qint64 memory_usage = 0;
+
+        qreal hit_rate() const
+        {
+            return hits + misses == 0 ? 0 : qreal(hits) / (hits + misses);
+        }
+    };
+
+    static TextCache& instance();
+
+    /**
+     * \brief Returns the outline for \p glyph, calling \p build on a cache miss
+     */
+    math::bezier::MultiBezier glyph(
+        const QString& font_key, quint32 glyph, bool fix_paint,
+        const std::function<math::bezier::MultiBezier()>& build
+    );
+
+    /**
+     * \brief Returns the layout of \p text, calling \p build on a cache miss
+     */
+    Font::ParagraphData layout(
+        const QString& font_key, qreal line_height, const QString& text,
+        const std::function<Font::ParagraphData()>& build
+    );
+
+    /**
+     * \brief Maximum number of bytes to use for entries of the given kind
+     */
+    qint64 memory_budget(Kind kind) const;
+    void set_memory_budget(Kind kind, qint64 bytes);
+
+    /**
+     * \brief Lookup counters and memory usage for entries of the given kind
+     */
+    Stats stats(Kind kind) const;
+
+    /**
+     * \brief Resets the hit and miss counters
+     */
+    void reset_stats();
+
+    /**
+     * \brief Drops all the entries
+     */
+    void clear();
+
+private:
+    TextCache();
+    ~TextCache();
+    TextCache(const TextCache&) = delete;
+    TextCache& operator=(const TextCache&) = delete;
+
+    class Private;
+    std::unique_ptr<Private> d;
+};
+
+} // namespace glaxnimate::model
@@ -52,6 +52,11 @@ protected:
     glaxnimate::math::bezier::MultiBezier to_painter_path_impl(FrameTime t) const override;
 
     void on_paint(renderer::Renderer* p, FrameTime t, PaintMode, model::Modifier* modifier) const override;
+
+    QRectF local_conservative_bounding_rect(FrameTime t) const override
+    {
+        return collect_shapes(t, {}).control_box();
+    }
 };
 
 
@@ -49,12 +49,7 @@ public:
 
     QRectF local_bounding_rect(FrameTime t) const override
     {
-        if ( !visible.get() )
-            return {};
-        qreal half_width = width.get_at(t) / 2;
-        return collect_shapes(t, {}).bounding_box().adjusted(
-            -half_width, -half_width, half_width, half_width
-        );
+        return grow_by_width(t, collect_shapes(t, {}).bounding_box());
     }
 
 
@@ -75,6 +70,20 @@ public:
 protected:
     glaxnimate::math::bezier::MultiBezier to_painter_path_impl(FrameTime t) const override;
     void on_paint(renderer::Renderer* p, FrameTime t, PaintMode, model::Modifier* modifier) const override;
+
+    QRectF local_conservative_bounding_rect(FrameTime t) const override
+    {
+        return grow_by_width(t, collect_shapes(t, {}).control_box());
+    }
+
+private:
+    QRectF grow_by_width(FrameTime t, const QRectF& rect) const
+    {
+        if ( !visible.get() )
+            return {};
+        qreal half_width = width.get_at(t) / 2;
+        return rect.adjusted(-half_width, -half_width, half_width, half_width);
+    }
 };
 
 } // namespace glaxnimate::model
@@ -68,7 +68,7 @@ private:
     {
         FolderItem* current_item = nullptr;
 
-        for ( const auto& child : chunk->children )
+        for ( const auto& child : chunk->children() )
         {
             if ( *child == "fiac" )
             {
@@ -184,7 +184,7 @@ private:
         comp.samples_limit = data.read_uint32();
         comp.samples_per_frame = data.read_uint32();
 
-        for ( const auto& child : chunk->children )
+        for ( const auto& child : chunk->children() )
         {
             if ( *child == "Layr" )
                 comp.layers.push_back(parse_layer(child.get(), comp));
@@ -341,7 +341,7 @@ private:
     void parse_property_group(Chunk chunk, PropertyGroup& group, const PropertyContext& context)
     {
         QString match_name;
-        for ( auto it = chunk->children.begin(); it != chunk->children.end(); ++it )
+        for ( auto it = chunk->children().begin(); it != chunk->children().end(); ++it )
         {
             auto child = it->get();
 
@@ -367,7 +367,7 @@ private:
                 data.skip(4);
                 mask->mode = MaskMode(data.read_uint16());
                 ++it;
-                if ( it == chunk->children.end() )
+                if ( it == chunk->children().end() )
                 {
                     warning(i18n("Missing mask properties"));
                     return;
@@ -562,7 +562,6 @@ private:
 
     Keyframe load_keyframe(int index, BinaryReader& reader, Property& prop, const PropertyContext& context, std::vector<PropertyValue>& values, qreal time_den)
     {
-        reader.prepare();
         Keyframe kf;
 
         kf.time = context.time_to_frames(reader.read_sint32() / time_den);
@@ -671,7 +670,6 @@ private:
         values.reserve(count);
         for ( std::uint32_t i = 0; i < count; i++ )
             values.push_back(vals->reader.sub_reader(size, i * size));
-        vals->reader.prepare();
         return values;
     }
 
@@ -823,7 +821,7 @@ private:
                 effect.name = to_string(fnam->child("Utf8"));
 
             QString param_mn;
-            for ( const auto& param_chunk : part->children )
+            for ( const auto& param_chunk : part->children() )
             {
                 if ( *param_chunk == "tdmn" )
                 {
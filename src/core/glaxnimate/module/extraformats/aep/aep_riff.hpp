@@ -22,19 +22,13 @@ protected:
     {
         if ( is_fake_list(chunk.header) )
         {
-            chunk.children = read_chunks(chunk.reader);
+            lazy_children(chunk);
         }
         else if ( chunk.header == "LIST" )
         {
-            chunk.subheader = chunk.reader.read(4);
+            chunk.subheader = chunk.reader.read_view(4);
             if ( chunk.subheader != "btdk" )
-                chunk.children = read_chunks(chunk.reader);
-            else
-                chunk.reader.defer();
-        }
-        else
-        {
-            chunk.reader.defer();
+                lazy_children(chunk);
         }
     }
 };
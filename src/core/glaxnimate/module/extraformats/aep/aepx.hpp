@@ -30,14 +30,12 @@ public:
         else if ( header == "numS" )
         {
             std::uint32_t val = element.firstChildElement().text().toUInt();
-            auto data = buffer(Endianness::Big().write_uint(val));
-            return chunk(header, data);
+            return chunk(header, Endianness::Big().write_uint(val));
         }
         else if ( header == "ppSn" )
         {
             std::uint32_t val = element.firstChildElement().text().toDouble();
-            auto data = buffer(Endianness::Big().write_float64(val));
-            return chunk(header, data);
+            return chunk(header, Endianness::Big().write_float64(val));
         }
         else if ( element.hasAttribute("bdata") )
         {
@@ -69,42 +67,24 @@ public:
     }
 
 private:
-    struct BinaryData
-    {
-        QByteArray data;
-        QBuffer file;
-        std::uint32_t length;
-    };
-
-    RiffChunk chunk(const QString& header, BinaryData* data, const QString& subheader = {})
+    RiffChunk chunk(const QString& header, QByteArray data, const QString& subheader = {})
     {
+        std::uint32_t length = data.size();
         return {
-            header.toLatin1(), data->length, subheader.toLatin1(),
-            {Endianness::Big(), &data->file, data->length, 0}
+            header.toLatin1(), length, subheader.toLatin1(),
+            {Endianness::Big(), std::move(data)}
         };
     }
 
-    BinaryData* buffer(QByteArray&& content)
-    {
-        data.push_back(std::make_unique<BinaryData>());
-        data.back()->length = content.size();
-        data.back()->data = std::move(content);
-        data.back()->file.setBuffer(&data.back()->data);
-        data.back()->file.open(QIODevice::ReadOnly);
-        return data.back().get();
-    }
-
-    BinaryData* hex(const QString& hex)
+    QByteArray hex(const QString& hex)
     {
-        return buffer(QByteArray::fromHex(hex.toLatin1()));
+        return QByteArray::fromHex(hex.toLatin1());
     }
 
-    BinaryData* text(const QString& string)
+    QByteArray text(const QString& string)
     {
-        return buffer(string.toUtf8());
+        return string.toUtf8();
     }
-
-    std::vector<std::unique_ptr<BinaryData>> data;
 };
 
 } // namespace glaxnimate::io::aep
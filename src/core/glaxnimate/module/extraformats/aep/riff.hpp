@@ -6,6 +6,7 @@
 #pragma once
 
 #include <variant>
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 #include <cstring>
@@ -13,8 +14,10 @@
 #include <stdexcept>
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QSysInfo>
-#include <QBuffer>
+#include <QFileDevice>
+#include <QPointer>
 
 #include "glaxnimate/utils/i18n.hpp"
 
@@ -31,7 +34,7 @@ class Endianness
 {
 public:
     template<class T>
-    constexpr T read_uint(const QByteArray& arr) const noexcept
+    constexpr T read_uint(QByteArrayView arr) const noexcept
     {
         if constexpr ( sizeof(T) == 1 )
         {
@@ -53,13 +56,13 @@ public:
     }
 
     template<int size>
-    constexpr typename IntSize<size>::uint read_uint(const QByteArray& arr) const noexcept
+    constexpr typename IntSize<size>::uint read_uint(QByteArrayView arr) const noexcept
     {
         return read_uint<typename IntSize<size>::uint>(arr);
     }
 
     template<int size>
-    constexpr typename IntSize<size>::sint read_sint(const QByteArray& arr) const noexcept
+    constexpr typename IntSize<size>::sint read_sint(QByteArrayView arr) const noexcept
     {
         using uint_t = typename IntSize<size>::uint;
         using sint_t = typename IntSize<size>::uint;
@@ -73,7 +76,7 @@ public:
     }
 
     template<class T>
-    constexpr T read_sint(const QByteArray& arr) const noexcept
+    constexpr T read_sint(QByteArrayView arr) const noexcept
     {
         return read_uint<sizeof(T)>(arr);
     }
@@ -81,7 +84,7 @@ public:
     /**
      * \note Expects IEEE 754 floats
      */
-    constexpr float read_float32(const QByteArray& arr) const noexcept
+    constexpr float read_float32(QByteArrayView arr) const noexcept
     {
         union {
             std::uint32_t vali;
@@ -93,7 +96,7 @@ public:
     /**
      * \note Expects IEEE 754 floats
      */
-    constexpr double read_float64(const QByteArray& arr) const noexcept
+    constexpr double read_float64(QByteArrayView arr) const noexcept
     {
         union {
             std::uint64_t vali;
@@ -187,40 +190,93 @@ private:
 };
 
 
+/**
+ * \brief Contiguous data of a RIFF file, readers hold views into it
+ *
+ * Files are memory-mapped so only the pages that are actually read get loaded,
+ * other devices are read into a single buffer.
+ */
+class RiffBuffer
+{
+public:
+    explicit RiffBuffer(QIODevice* device)
+    {
+        auto file = qobject_cast<QFileDevice*>(device);
+        if ( file && !file->isSequential() )
+        {
+            qint64 pos = file->pos();
+            qint64 size = file->size() - pos;
+            if ( size > 0 )
+            {
+                if ( uchar* mapped = file->map(pos, size) )
+                {
+                    this->file = file;
+                    map = mapped;
+                    data = QByteArrayView(mapped, size);
+                    return;
+                }
+            }
+        }
+
+        buffer = device->readAll();
+        data = buffer;
+    }
+
+    explicit RiffBuffer(QByteArray buffer)
+        : buffer(std::move(buffer)), data(this->buffer)
+    {}
+
+    RiffBuffer(const RiffBuffer&) = delete;
+    RiffBuffer& operator=(const RiffBuffer&) = delete;
+
+    ~RiffBuffer()
+    {
+        if ( map && file )
+            file->unmap(map);
+    }
+
+    QByteArrayView bytes() const
+    {
+        return data;
+    }
+
+private:
+    QPointer<QFileDevice> file;
+    uchar* map = nullptr;
+    QByteArray buffer;
+    QByteArrayView data;
+};
+
 class BinaryReader
 {
 public:
     BinaryReader()
         : endian(Endianness::Big()),
-        file(nullptr),
         file_pos(0),
         length_left(0)
     {}
 
-    BinaryReader(Endianness endian, QIODevice* file, std::uint32_t length, qint64 pos)
+    BinaryReader(Endianness endian, std::shared_ptr<const RiffBuffer> source, qint64 pos, std::int64_t length)
         : endian(endian),
-        file(file),
+        source(std::move(source)),
         file_pos(pos),
         length_left(length)
     {}
 
-    BinaryReader(Endianness endian, QIODevice* file, std::uint32_t length)
-        : endian(endian),
-        file(file),
-        file_pos(file->pos()),
-        length_left(length)
+    BinaryReader(Endianness endian, std::shared_ptr<const RiffBuffer> source)
+        : BinaryReader(endian, source, 0, source->bytes().size())
     {}
-/*
-    BinaryReader(Endianness endian, QByteArray& data, std::uint32_t length)
-        : endian(endian), buffer(std::make_unique<QBuffer>(&data)), file(buffer.get()), length_left(length)
+
+    BinaryReader(Endianness endian, QByteArray data)
+        : BinaryReader(endian, std::make_shared<const RiffBuffer>(std::move(data)))
     {}
-*/
+
     BinaryReader sub_reader(std::uint32_t length)
     {
         if ( length > length_left )
             throw RiffError(i18n("Not enough data"));
         length_left -= length;
-        BinaryReader reader{endian, file, length, file_pos};
+        BinaryReader reader{endian, source, file_pos, length};
         file_pos += length;
         return reader;
     }
@@ -233,7 +289,7 @@ public:
         if ( length + offset > length_left )
             throw RiffError(i18n("Not enough data"));
 
-        return {endian, file, length, file_pos + offset};
+        return {endian, source, file_pos + offset, length};
     }
 
     void set_endianness(const Endianness& endian)
@@ -248,24 +304,30 @@ public:
 
     QByteArray read(std::uint32_t length)
     {
+        return read_view(length).toByteArray();
+    }
+
+    /**
+     * \brief Reads without copying, the view is valid as long as the reader data
+     */
+    QByteArrayView read_view(std::uint32_t length)
+    {
+        auto view = peek(length);
         length_left -= length;
         file_pos += length;
-        auto data = file->read(length);
-        if ( std::uint32_t(data.size()) < length )
-            throw RiffError(i18n("Not enough data"));
-        return data;
+        return view;
     }
 
     template<int size>
     typename IntSize<size>::uint read_uint()
     {
-        return endian.read_uint<size>(read(size));
+        return endian.read_uint<size>(read_view(size));
     }
 
     template<int size>
     typename IntSize<size>::sint read_sint()
     {
-        return endian.read_sint<size>(read(size));
+        return endian.read_sint<size>(read_view(size));
     }
 
     std::uint8_t read_uint8() { return read_uint<1>(); }
@@ -287,20 +349,19 @@ public:
 
     float read_float32()
     {
-        return endian.read_float32(read(4));
+        return endian.read_float32(read_view(4));
     }
 
     double read_float64()
     {
-        return endian.read_float64(read(8));
+        return endian.read_float64(read_view(8));
     }
 
     void skip(std::uint32_t length)
     {
+        peek(length);
         length_left -= length;
         file_pos += length;
-        if ( file->skip(length) < length )
-            throw RiffError(i18n("Not enough data"));
     }
 
     std::int64_t available() const
@@ -310,7 +371,7 @@ public:
 
     QString read_utf8(std::uint32_t length)
     {
-        return QString::fromUtf8(read(length));
+        return QString::fromUtf8(read_view(length));
     }
 
     /**
@@ -318,9 +379,9 @@ public:
      */
     QString read_utf8_nul(std::uint32_t length)
     {
-        auto data = read(length);
-        int str_len = data.indexOf('\0');
-        return QString::fromUtf8(data.data(), str_len == -1 ? length : str_len);
+        auto data = read_view(length);
+        auto end = static_cast<const char*>(std::memchr(data.data(), '\0', data.size()));
+        return QString::fromUtf8(data.data(), end ? end - data.data() : data.size());
     }
 
     QString read_utf8_nul()
@@ -333,19 +394,6 @@ public:
         return length_left;
     }
 
-    void prepare() const
-    {
-        file->seek(file_pos);
-    }
-
-    /**
-     * \brief Defer data reading to a later point
-     */
-    void defer()
-    {
-        file->skip(length_left);
-    }
-
     template<class T>
     std::vector<T> read_array(T (BinaryReader::*read_fn)(), int count)
     {
@@ -356,15 +404,16 @@ public:
         return out;
     }
 
-    QIODevice* device() const
+private:
+    QByteArrayView peek(std::uint32_t length) const
     {
-        return file;
+        if ( !source || file_pos + length > source->bytes().size() )
+            throw RiffError(i18n("Not enough data"));
+        return source->bytes().sliced(file_pos, length);
     }
 
-private:
     Endianness endian;
-//     std::unique_ptr<QBuffer> buffer;
-    QIODevice* file;
+    std::shared_ptr<const RiffBuffer> source;
     qint64 file_pos;
     std::int64_t length_left;
 };
@@ -373,11 +422,15 @@ struct ChunkId
 {
     char name[4] = "";
 
-    ChunkId(const QByteArray& arr)
+    ChunkId(QByteArrayView arr)
     {
         std::memcpy(name, (void*)arr.data(), std::min<std::size_t>(4, arr.size()));
     }
 
+    ChunkId(const QByteArray& arr) : ChunkId(QByteArrayView(arr)) {}
+
+    ChunkId(const char* arr) : ChunkId(QByteArrayView(arr)) {}
+
     bool operator==(const char* ch) const {
         return std::strncmp(name, ch, 4) == 0;
     }
@@ -392,13 +445,18 @@ struct ChunkId
     }
 };
 
+class RiffReader;
+
 struct RiffChunk
 {
     ChunkId header;
     std::uint32_t length = 0;
     ChunkId subheader = {""};
     BinaryReader reader = {};
-    std::vector<std::unique_ptr<RiffChunk>> children = {};
+    /// Child chunks, use children() to access them
+    mutable std::vector<std::unique_ptr<RiffChunk>> child_chunks = {};
+    /// When not null, the children haven't been read yet and will be read by this
+    mutable RiffReader* lazy_reader = nullptr;
 
     using iterator = std::vector<std::unique_ptr<RiffChunk>>::const_iterator;
 
@@ -466,32 +524,35 @@ struct RiffChunk
 
     BinaryReader data() const
     {
-        BinaryReader data = reader;
-        data.prepare();
-        return data;
+        return reader;
     }
 
+    /**
+     * \brief Child chunks, read the first time they are needed
+     */
+    const std::vector<std::unique_ptr<RiffChunk>>& children() const;
+
     iterator find(const char* name) const
     {
-        return find(name, children.begin());
+        return find(name, children().begin());
     }
 
     iterator find(const char* name, iterator from) const
     {
-        return std::find_if(from, children.end(), [name](const std::unique_ptr<RiffChunk>& c){ return *c == name; });
+        return std::find_if(from, children().end(), [name](const std::unique_ptr<RiffChunk>& c){ return *c == name; });
     }
 
     const RiffChunk* child(const char* name) const
     {
         auto it = find(name);
-        if ( it == children.end() )
+        if ( it == children().end() )
             return nullptr;
         return it->get();
     }
 
     FindRange find_all(const char* name) const
     {
-        return {{find(name), name, this}, {children.end(), name, this}};
+        return {{find(name), name, this}, {children().end(), name, this}};
     }
 
     void find_multiple(
@@ -500,7 +561,7 @@ struct RiffChunk
     ) const
     {
         std::size_t found = 0;
-        for ( const auto& child: children )
+        for ( const auto& child: children() )
         {
             for ( std::size_t i = 0; i < names.size(); i++ )
             {
@@ -523,6 +584,13 @@ struct RiffChunk
     }
 };
 
+/**
+ * \brief Reads the chunk structure of a RIFF file
+ *
+ * Only the top-level chunks are read by parse(), the children of a list are read
+ * the first time they're accessed so the reader must outlive the returned chunks.
+ * Chunk data isn't copied, readers point into the mapped file.
+ */
 class RiffReader
 {
 public:
@@ -530,7 +598,8 @@ public:
 
     RiffChunk parse(QIODevice* file)
     {
-        auto headerraw = file->read(4);
+        BinaryReader file_reader(Endianness::Big(), std::make_shared<const RiffBuffer>(file));
+        auto headerraw = file_reader.read(4);
         ChunkId header = headerraw;
         Endianness endian = Endianness::Big();
         if ( header == "RIFF" )
@@ -538,10 +607,11 @@ public:
         else if ( header != "RIFX" )
             throw RiffError(i18n("Unknown format %1", QString(headerraw)));
 
-        auto length = endian.read_uint<4>(file->read(4));
+        file_reader.set_endianness(endian);
+        auto length = file_reader.read_uint32();
 
-        BinaryReader reader = BinaryReader(endian, file, length);
-        ChunkId format = reader.read(4);
+        BinaryReader reader = file_reader.sub_reader(std::min<std::int64_t>(length, file_reader.available()));
+        ChunkId format = reader.read_view(4);
         RiffChunk chunk{header, length, format};
         chunk.reader = reader;
         on_root(chunk);
@@ -551,7 +621,7 @@ public:
 protected:
     RiffChunk read_chunk(BinaryReader& reader)
     {
-        ChunkId header = reader.read(4);
+        ChunkId header = reader.read_view(4);
         auto length = reader.read_uint<4>();
         RiffChunk chunk{header, length};
 
@@ -565,31 +635,48 @@ protected:
         return chunk;
     }
 
-    std::vector<std::unique_ptr<RiffChunk>> read_chunks(BinaryReader& reader)
+    std::vector<std::unique_ptr<RiffChunk>> read_chunks(BinaryReader reader)
     {
         std::vector<std::unique_ptr<RiffChunk>> chunks;
-        while ( reader.available() )
+        while ( reader.available() > 0 )
             chunks.push_back(std::make_unique<RiffChunk>(read_chunk(reader)));
         return chunks;
     }
 
+    /**
+     * \brief Marks the data of \p chunk as a list of chunks, to be read on demand
+     */
+    void lazy_children(RiffChunk& chunk)
+    {
+        chunk.lazy_reader = this;
+    }
+
     virtual void on_root(RiffChunk& chunk)
     {
-        chunk.children = read_chunks(chunk.reader);
+        lazy_children(chunk);
     }
 
     virtual void on_chunk(RiffChunk& chunk)
     {
         if ( chunk.header == "LIST" )
         {
-            chunk.subheader = chunk.reader.read(4);
-            chunk.children = read_chunks(chunk.reader);
-        }
-        else
-        {
-            chunk.reader.defer();
+            chunk.subheader = chunk.reader.read_view(4);
+            lazy_children(chunk);
         }
     }
+
+    friend struct RiffChunk;
 };
 
+inline const std::vector<std::unique_ptr<RiffChunk>>& RiffChunk::children() const
+{
+    if ( lazy_reader )
+    {
+        // Only cleared on success so malformed data throws every time
+        child_chunks = lazy_reader->read_chunks(reader);
+        lazy_reader = nullptr;
+    }
+    return child_chunks;
+}
+
 } // namespace glaxnimate::io::aep
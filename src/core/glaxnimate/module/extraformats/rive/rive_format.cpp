@@ -124,27 +124,28 @@ QJsonDocument glaxnimate::io::rive::RiveFormat::to_json(const QByteArray& binary
         obj["class"] = types;
 
         QJsonArray props;
-        for ( const auto& p : rive_obj.type().properties )
+        for ( int i = 0; i < int(rive_obj.type().properties.size()); i++ )
         {
+            auto p = rive_obj.type().properties[i];
             QJsonObject prop;
             prop["id"] = int(p->id);
             prop["name"] = p->name;
             prop["type"] = property_type_to_string(p->type);
-            auto iter = rive_obj.properties().find(p);
+            QVariant value = rive_obj.get_variant(i);
             QJsonValue val;
 
-            if ( iter != rive_obj.properties().end() && iter->second.isValid() )
+            if ( value.isValid() )
             {
-                if ( iter->second.userType() == QMetaType::QColor )
-                    val = iter->second.value<QColor>().name();
-                else if ( iter->second.userType() == QMetaType::ULongLong || iter->second.userType() == QMetaType::ULong )
-                    val = iter->second.toInt();
-                else if ( iter->second.userType() == QMetaType::QByteArray )
-                    val = QString::fromLatin1(iter->second.toByteArray().toBase64());
+                if ( value.userType() == QMetaType::QColor )
+                    val = value.value<QColor>().name();
+                else if ( value.userType() == QMetaType::ULongLong || value.userType() == QMetaType::ULong )
+                    val = value.toInt();
+                else if ( value.userType() == QMetaType::QByteArray )
+                    val = QString::fromLatin1(value.toByteArray().toBase64());
                 else
-                    val = QJsonValue::fromVariant(iter->second);
+                    val = QJsonValue::fromVariant(value);
 
-                summary_obj[iter->first->name] = val;
+                summary_obj[p->name] = val;
             }
             prop["value"] = val;
 
@@ -813,8 +813,8 @@ Object RiveLoader::read_object()
         if ( prop_id == 0 )
             break;
 
-        auto prop_def = obj.type().property(prop_id);
-        if ( !prop_def )
+        int index = obj.type().property_index(prop_id);
+        if ( index == -1 )
         {
             auto unknown_it = extra_props.find(prop_id);
             if ( unknown_it == extra_props.end() )
@@ -839,13 +839,13 @@ Object RiveLoader::read_object()
         }
         else
         {
-            obj.set(prop_def, read_property_value(prop_def->type));
+            read_property_value(obj, index);
             if ( stream.has_error() )
             {
                 format->error(i18n(
                     "Error loading property %1 (%2) of %3 (%4)",
                     prop_id,
-                    prop_def->name,
+                    obj.type().properties[index]->name,
                     int(type_id),
                     obj.definition()->name
                 ));
@@ -858,25 +858,27 @@ Object RiveLoader::read_object()
 }
 
 
-QVariant RiveLoader::read_property_value(PropertyType type)
+void RiveLoader::read_property_value(Object& object, int index)
 {
-    switch ( type )
+    switch ( object.type().properties[index]->type )
     {
         case PropertyType::Bool:
-            return bool(stream.next());
+            object.set_uint(index, stream.next() ? 1 : 0);
+            return;
         case PropertyType::Bytes:
-            return read_raw_string();
         case PropertyType::String:
-            return read_string_utf8();
+            object.set_bytes(index, read_raw_string());
+            return;
         case PropertyType::VarUint:
-            return QVariant::fromValue(stream.read_uint_leb128());
+            object.set_uint(index, stream.read_uint_leb128());
+            return;
         case PropertyType::Float:
-            return stream.read_float32_le();
+            object.set_float(index, stream.read_float32_le());
+            return;
         case PropertyType::Color:
-            return QColor::fromRgba(stream.read_uint32_le());
+            object.set_uint(index, stream.read_uint32_le());
+            return;
     }
-
-    return {};
 }
 
 
@@ -960,8 +962,3 @@ QByteArray RiveLoader::read_raw_string()
 
     return stream.read(size);
 }
-
-QString RiveLoader::read_string_utf8()
-{
-    return QString::fromUtf8(read_raw_string());
-}
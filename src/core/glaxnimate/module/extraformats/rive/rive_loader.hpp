@@ -28,12 +28,11 @@ public:
 private:
     Object read_object();
 
-    QVariant read_property_value(PropertyType type);
+    void read_property_value(Object& object, int index);
     PropertyTable read_property_table();
     void skip_value(PropertyType type);
 
     QByteArray read_raw_string();
-    QString read_string_utf8();
 
     BinaryInputStream& stream;
     RiveFormat* format;
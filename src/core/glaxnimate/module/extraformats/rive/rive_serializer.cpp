@@ -5,7 +5,6 @@
  */
 
 #include "glaxnimate/module/extraformats/rive/rive_serializer.hpp"
-#include <QColor>
 
 glaxnimate::io::rive::RiveSerializer::RiveSerializer(QIODevice* file)
     : stream(file)
@@ -66,45 +65,41 @@ void glaxnimate::io::rive::RiveSerializer::write_property_table(const glaxnimate
 
 void glaxnimate::io::rive::RiveSerializer::write_object(const glaxnimate::io::rive::Object& output)
 {
-    stream.write_uint_leb128(VarUint(output.type().id));
-    for ( const auto& p : output.properties() )
+    const auto& type = output.type();
+    stream.write_uint_leb128(VarUint(type.id));
+    for ( int i = 0; i < int(type.properties.size()); i++ )
     {
-        if ( !p.second.isValid() || (p.second.userType() == QMetaType::QString && p.second.toString().isEmpty()) )
+        auto prop = type.properties[i];
+        if ( !output.has(i) || (prop->type == PropertyType::String && output.bytes_value(i).isEmpty()) )
             continue;
-        stream.write_uint_leb128(p.first->id);
-        write_property_value(p.first->type, p.second);
+        stream.write_uint_leb128(prop->id);
+        write_property_value(output, i);
     }
     stream.write_byte(0);
 }
 
-void glaxnimate::io::rive::RiveSerializer::write_property_value(glaxnimate::io::rive::PropertyType id, const QVariant& value)
+void glaxnimate::io::rive::RiveSerializer::write_property_value(const glaxnimate::io::rive::Object& object, int index)
 {
-    switch ( id )
+    switch ( object.type().properties[index]->type )
     {
         case PropertyType::Bool:
-            stream.write_byte(value.toBool());
+            stream.write_byte(object.uint_value(index) ? 1 : 0);
             return;
         case PropertyType::VarUint:
-            stream.write_uint_leb128(value.value<VarUint>());
+            stream.write_uint_leb128(object.uint_value(index));
             return;
         case PropertyType::Color:
-            stream.write_uint32_le(value.value<QColor>().rgba());
+            stream.write_uint32_le(object.uint_value(index));
             return;
         case PropertyType::Bytes:
-        {
-            auto data = value.toByteArray();
-            stream.write_uint_leb128(data.size());
-            stream.write(data);
-            return;
-        }
         case PropertyType::String:
         {
-            auto data = value.toString().toUtf8();
+            const auto& data = object.bytes_value(index);
             stream.write_uint_leb128(data.size());
             stream.write(data);
             return;
         }
         case PropertyType::Float:
-            stream.write_float32_le(value.toFloat());
+            stream.write_float32_le(object.float_value(index));
     }
 }
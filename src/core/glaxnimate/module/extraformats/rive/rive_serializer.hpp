@@ -25,7 +25,7 @@ public:
 
     void write_object(const Object& output);
 
-    void write_property_value(PropertyType id, const QVariant& value);
+    void write_property_value(const Object& object, int index);
 
 private:
     BinaryOutputStream stream;
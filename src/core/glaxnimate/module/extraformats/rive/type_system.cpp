@@ -6,6 +6,8 @@
 
 #include "glaxnimate/module/extraformats/rive/type_system.hpp"
 
+#include <algorithm>
+
 
 const glaxnimate::io::rive::ObjectDefinition * glaxnimate::io::rive::TypeSystem::get_definition(glaxnimate::io::rive::TypeId type_id)
 {
@@ -36,13 +38,29 @@ bool glaxnimate::io::rive::TypeSystem::gather_definitions(glaxnimate::io::rive::
     for ( const auto& prop : def->properties )
     {
         type.property_from_name[prop.name] = &prop;
-        type.property_from_id[prop.id] = &prop;
         type.properties.push_back(&prop);
     }
 
     return true;
 }
 
+void glaxnimate::io::rive::TypeSystem::build_layout(glaxnimate::io::rive::ObjectType& type)
+{
+    Identifier max_id = 0;
+    for ( const auto& prop : type.properties )
+        max_id = std::max(max_id, prop->id);
+
+    type.index_from_id.assign(max_id + 1, -1);
+    type.bytes_index.assign(type.properties.size(), -1);
+    for ( int i = 0; i < int(type.properties.size()); i++ )
+    {
+        auto prop = type.properties[i];
+        type.index_from_id[prop->id] = i;
+        if ( prop->type == PropertyType::String || prop->type == PropertyType::Bytes )
+            type.bytes_index[i] = type.bytes_count++;
+    }
+}
+
 const glaxnimate::io::rive::ObjectType * glaxnimate::io::rive::TypeSystem::get_type(glaxnimate::io::rive::TypeId type_id)
 {
     auto it = types.find(type_id);
@@ -53,6 +71,8 @@ const glaxnimate::io::rive::ObjectType * glaxnimate::io::rive::TypeSystem::get_t
     if ( !gather_definitions(type, type_id) )
         return nullptr;
 
+    build_layout(type);
+
     return &types.emplace(type_id, std::move(type)).first->second;
 }
 
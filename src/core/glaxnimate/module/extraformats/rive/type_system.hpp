@@ -5,6 +5,9 @@
  */
 
 #pragma once
+
+#include <QColor>
+
 #include "glaxnimate/module/extraformats/rive/type_def.hpp"
 #include "glaxnimate/utils/qstring_hash.hpp"
 
@@ -18,6 +21,12 @@ struct PropertyAnimation
     std::vector<Object*> keyframes = {};
 };
 
+/**
+ * \brief All the properties of an object type, including inherited ones
+ *
+ * Properties are identified by their index in \p properties,
+ * which is also where Object stores their values.
+ */
 class ObjectType
 {
 public:
@@ -26,8 +35,12 @@ public:
     TypeId id = TypeId::NoType;
     std::vector<const Property*> properties;
     std::vector<const ObjectDefinition*> definitions;
-    std::unordered_map<Identifier, const Property*> property_from_id;
     std::unordered_map<QString, const Property*> property_from_name;
+    /// Index in \p properties for each property id, -1 for ids not in this type
+    std::vector<int> index_from_id;
+    /// Index of String and Bytes properties in the object byte array storage, -1 for scalars
+    std::vector<int> bytes_index;
+    int bytes_count = 0;
 
     const Property* property(const QString& name) const
     {
@@ -39,87 +52,276 @@ public:
 
     const Property* property(Identifier id) const
     {
-        auto it = property_from_id.find(id);
-        if ( it == property_from_id.end() )
+        int index = property_index(id);
+        if ( index == -1 )
             return nullptr;
-        return it->second;
+        return properties[index];
+    }
+
+    int property_index(Identifier id) const
+    {
+        if ( id >= index_from_id.size() )
+            return -1;
+        return index_from_id[id];
+    }
+
+    int property_index(const Property* prop) const
+    {
+        if ( !prop )
+            return -1;
+        int index = property_index(prop->id);
+        if ( index == -1 || properties[index] != prop )
+            return -1;
+        return index;
     }
 };
 
+/**
+ * \brief Rive object with its property values
+ *
+ * Values are stored unboxed in a flat array following the layout of the object type,
+ * VarUint, Bool and Color properties as integers, strings as UTF-8.
+ */
 class Object
 {
 public:
     Object(const ObjectType* type = nullptr)
     : type_(type)
-    {}
+    {
+        if ( type_ )
+        {
+            slots_.resize(type_->properties.size());
+            bytes_.resize(type_->bytes_count);
+        }
+    }
 
     const ObjectType& type() const
     {
         return *type_;
     }
 
-    const std::unordered_map<const Property*, QVariant>& properties() const
+    template<class T>
+    bool set(const QString& name, const T& value)
+    {
+        return set(type_->property(name), value);
+    }
+
+    bool set(const QString& name, const QVariant& value)
     {
-        return properties_;
+        return set(type_->property(name), value);
     }
 
     template<class T>
-    bool set(const QString& name, T value)
+    bool set(const Property* prop, const T& value)
     {
-        if ( auto prop = type_->property(name) )
+        int index = type_->property_index(prop);
+        if ( index == -1 )
+            return false;
+
+        auto type = prop->type;
+        if constexpr ( std::is_integral_v<T> )
         {
-            properties_[prop].setValue(value);
-            return true;
+            if ( type == PropertyType::VarUint || type == PropertyType::Bool )
+            {
+                set_uint(index, type == PropertyType::Bool ? VarUint(value != 0) : VarUint(value));
+                return true;
+            }
         }
-        return false;
+
+        if constexpr ( std::is_arithmetic_v<T> )
+        {
+            if ( type == PropertyType::Float )
+            {
+                set_float(index, Float32(value));
+                return true;
+            }
+        }
+        else if constexpr ( std::is_same_v<T, QString> )
+        {
+            if ( type == PropertyType::String )
+            {
+                set_bytes(index, value.toUtf8());
+                return true;
+            }
+        }
+        else if constexpr ( std::is_same_v<T, QByteArray> )
+        {
+            if ( type == PropertyType::Bytes )
+            {
+                set_bytes(index, value);
+                return true;
+            }
+        }
+        else if constexpr ( std::is_same_v<T, QColor> )
+        {
+            if ( type == PropertyType::Color )
+            {
+                set_uint(index, value.rgba());
+                return true;
+            }
+        }
+
+        return set(prop, QVariant::fromValue(value));
     }
 
-    bool set(const QString& name, const QVariant& value)
+    /**
+     * \brief Converts \p value to the type of \p prop, invalid values unset the property
+     */
+    bool set(const Property* prop, const QVariant& value)
     {
-        if ( auto prop = type_->property(name) )
+        int index = type_->property_index(prop);
+        if ( index == -1 )
+            return false;
+
+        if ( !value.isValid() )
         {
-            properties_[prop] = value;
+            slots_[index].set = false;
             return true;
         }
-        return false;
+
+        switch ( prop->type )
+        {
+            case PropertyType::Bool:
+                set_uint(index, value.toBool());
+                break;
+            case PropertyType::VarUint:
+                set_uint(index, value.value<VarUint>());
+                break;
+            case PropertyType::Color:
+                set_uint(index, value.value<QColor>().rgba());
+                break;
+            case PropertyType::Bytes:
+                set_bytes(index, value.toByteArray());
+                break;
+            case PropertyType::String:
+                set_bytes(index, value.toString().toUtf8());
+                break;
+            case PropertyType::Float:
+                set_float(index, value.toFloat());
+                break;
+        }
+        return true;
     }
 
+    /**
+     * \brief Sets a VarUint, Bool, or Color property by index
+     */
+    void set_uint(int index, VarUint value)
+    {
+        slots_[index].uint_value = value;
+        slots_[index].set = true;
+    }
+
+    /**
+     * \brief Sets a Float property by index
+     */
+    void set_float(int index, Float32 value)
+    {
+        slots_[index].float_value = value;
+        slots_[index].set = true;
+    }
+
+    /**
+     * \brief Sets a String (as UTF-8) or Bytes property by index
+     */
+    void set_bytes(int index, QByteArray value)
+    {
+        bytes_[type_->bytes_index[index]] = std::move(value);
+        slots_[index].set = true;
+    }
+
+    VarUint uint_value(int index) const
+    {
+        return slots_[index].uint_value;
+    }
 
-    void set(const Property* prop, const QVariant& value)
+    Float32 float_value(int index) const
     {
-        properties_[prop] = value;
+        return slots_[index].float_value;
     }
 
+    const QByteArray& bytes_value(int index) const
+    {
+        return bytes_[type_->bytes_index[index]];
+    }
 
     template<class T>
     T get(const QString& name, T value = {}) const
     {
-        if ( auto prop = type_->property(name) )
+        int index = type_->property_index(type_->property(name));
+        if ( index == -1 || !slots_[index].set )
+            return value;
+
+        auto type = type_->properties[index]->type;
+        if constexpr ( std::is_arithmetic_v<T> )
+        {
+            if ( type == PropertyType::Float )
+                return T(slots_[index].float_value);
+            if ( type == PropertyType::VarUint || type == PropertyType::Bool )
+                return T(slots_[index].uint_value);
+        }
+        else if constexpr ( std::is_same_v<T, QString> )
         {
-            auto it = properties_.find(prop);
-            if ( it != properties_.end() )
-                return it->second.value<T>();
+            if ( type == PropertyType::String )
+                return QString::fromUtf8(bytes_value(index));
         }
-        return value;
+        else if constexpr ( std::is_same_v<T, QByteArray> )
+        {
+            if ( type == PropertyType::Bytes || type == PropertyType::String )
+                return bytes_value(index);
+        }
+        else if constexpr ( std::is_same_v<T, QColor> )
+        {
+            if ( type == PropertyType::Color )
+                return QColor::fromRgba(QRgb(slots_[index].uint_value));
+        }
+
+        return get_variant(index).template value<T>();
     }
 
-    QVariant get_variant(const QString& name)
+    QVariant get_variant(const QString& name) const
     {
+        int index = type_->property_index(type_->property(name));
+        if ( index == -1 )
+            return {};
+        return get_variant(index);
+    }
+
+    /**
+     * \brief Boxed value of the property at \p index, invalid if it hasn't been set
+     */
+    QVariant get_variant(int index) const
+    {
+        if ( !slots_[index].set )
+            return {};
 
-        if ( auto prop = type_->property(name) )
+        switch ( type_->properties[index]->type )
         {
-            auto it = properties_.find(prop);
-            if ( it != properties_.end() )
-                return it->second;
+            case PropertyType::Bool:
+                return bool(slots_[index].uint_value);
+            case PropertyType::VarUint:
+                return QVariant::fromValue(slots_[index].uint_value);
+            case PropertyType::Color:
+                return QColor::fromRgba(QRgb(slots_[index].uint_value));
+            case PropertyType::Bytes:
+                return bytes_value(index);
+            case PropertyType::String:
+                return QString::fromUtf8(bytes_value(index));
+            case PropertyType::Float:
+                return slots_[index].float_value;
         }
         return {};
     }
 
     bool has(const QString& name) const
     {
-        if ( auto prop = type_->property(name) )
-            return properties_.count(prop);
-        return false;
+        int index = type_->property_index(type_->property(name));
+        return index != -1 && slots_[index].set;
+    }
+
+    bool has(int index) const
+    {
+        return slots_[index].set;
     }
 
     std::vector<PropertyAnimation>& animations()
@@ -151,8 +353,16 @@ public:
     }
 
 private:
+    struct Slot
+    {
+        VarUint uint_value = 0;
+        Float32 float_value = 0;
+        bool set = false;
+    };
+
     const ObjectType* type_;
-    std::unordered_map<const Property*, QVariant> properties_;
+    std::vector<Slot> slots_;
+    std::vector<QByteArray> bytes_;
     std::vector<PropertyAnimation> animations_;
     std::vector<Object*> children_;
 };
@@ -178,6 +388,7 @@ Q_SIGNALS:
 
 private:
     bool gather_definitions(ObjectType& type, TypeId type_id);
+    void build_layout(ObjectType& type);
 
     std::unordered_map<TypeId, ObjectType> types;
 };
@@ -64,10 +64,12 @@ class gzip::GzipStream::Private
 {
 public:
     Private(QIODevice* target, const ErrorFunc&)
-        : device(target, false, KCompressionDevice::GZip)
+        : device(target, false, KCompressionDevice::GZip), target(target)
     {}
 
     KCompressionDevice device;
+    QIODevice* target;
+    qint64 start = 0;
 };
 
 
@@ -85,9 +87,16 @@ bool gzip::GzipStream::open(QIODevice::OpenMode mode)
         return false;
     }
 
+    d->start = d->target->pos();
     return d->device.open(mode);
 }
 
+void gzip::GzipStream::close()
+{
+    d->device.close();
+    QIODevice::close();
+}
+
 bool gzip::GzipStream::atEnd() const
 {
     return d->device.atEnd();
@@ -103,3 +112,7 @@ qint64 gzip::GzipStream::readData(char* data, qint64 maxlen)
     return d->device.read(data, maxlen);
 }
 
+qint64 gzip::GzipStream::ouput_size() const
+{
+    return d->target->pos() - d->start;
+}
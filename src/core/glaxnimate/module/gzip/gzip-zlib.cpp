@@ -63,11 +63,11 @@ public:
         return zlib_check("inflateInit2", inflateInit2(&zip_stream, 16|MAX_WBITS));
     }
 
-    BufferView process()
+    BufferView process(int flush = Z_FINISH)
     {
         zip_stream.avail_out = chunk_size;
         zip_stream.next_out = buffer.data();
-        zlib_check(op, process_fn(&zip_stream, Z_FINISH));
+        zlib_check(op, process_fn(&zip_stream, flush));
         return {(const char*)buffer.data(), chunk_size - zip_stream.avail_out};
     }
 
@@ -187,6 +187,17 @@ public:
     QIODevice::OpenMode mode = QIODevice::NotOpen;
     qint64 total_size = 0;
     QByteArray buffer;
+    bool write_finished = false;
+
+    void write_compressed(int flush)
+    {
+        while ( !zipper.finished() )
+        {
+            auto bv = zipper.process(flush);
+            target->write(bv.data, bv.size);
+            total_size += bv.size;
+        }
+    }
 
     void _memcpy(char* dest, const char* src, std::size_t size)
     {
@@ -202,7 +213,23 @@ gzip::GzipStream::GzipStream(QIODevice* target, const gzip::ErrorFunc& on_error)
 gzip::GzipStream::~GzipStream()
 {
     if ( d->mode != NotOpen )
+    {
+        close();
         d->zipper.end();
+    }
+}
+
+void gzip::GzipStream::close()
+{
+    // Flush the remaining compressed data and the gzip footer
+    if ( d->mode == WriteOnly && !d->write_finished )
+    {
+        d->zipper.add_data(nullptr, 0);
+        d->write_compressed(Z_FINISH);
+        d->write_finished = true;
+    }
+
+    QIODevice::close();
 }
 
 bool gzip::GzipStream::open(QIODevice::OpenMode mode)
@@ -248,14 +275,9 @@ qint64 gzip::GzipStream::writeData(const char* data, qint64 len)
     }
 
 
+    // The stream is finished in close(), so data can be written in multiple chunks
     d->zipper.add_data(data, len);
-
-    while ( !d->zipper.finished() )
-    {
-        auto bv = d->zipper.process();
-        d->target->write(bv.data, bv.size);
-        d->total_size += bv.size;
-    }
+    d->write_compressed(Z_NO_FLUSH);
 
     return len;
 }
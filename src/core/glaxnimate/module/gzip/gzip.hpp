@@ -35,6 +35,11 @@ public:
     bool isSequential() const override { return true; }
     bool open(QIODevice::OpenMode mode) override;
 
+    /**
+     * \brief Closes the stream, when writing this flushes all the compressed data
+     */
+    void close() override;
+
     qint64 ouput_size() const;
 
 protected:
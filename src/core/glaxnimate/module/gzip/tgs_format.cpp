@@ -93,15 +93,19 @@ bool glaxnimate::io::lottie::TgsFormat::on_save(QIODevice& file, const QString&,
 
     validate(comp->document(), comp);
 
-    QCborMap json = LottieFormat::to_json(comp, true, true, settings);
-    json[QLatin1String("tgs")] = 1;
-    QByteArray data = cbor_write_json(json, true);
+    QCborMap extra;
+    extra[QLatin1String("tgs")] = 1;
 
-    quint32 compressed_size = 0;
-    if ( !gzip::compress(data, file, [this](const QString& s){ error(s); }, 9, &compressed_size) )
+    bool ok = true;
+    gzip::GzipStream compressed(&file, [this, &ok](const QString& s){ ok = false; error(s); });
+    if ( !compressed.open(QIODevice::WriteOnly) )
+        return false;
+    write_json(compressed, comp, true, true, true, settings, extra);
+    compressed.close();
+    if ( !ok )
         return false;
 
-    qreal size_k = compressed_size / 1024.0;
+    qreal size_k = compressed.ouput_size() / 1024.0;
     if ( size_k > 64 )
         error(i18n("File too large: %1k, should be under 64k", size_k));
 
@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include <mutex>
+
 #include <thorvg.h>
 #include <QPainter>
 
@@ -29,6 +31,22 @@ private:
     std::unique_ptr<tvg::Canvas> canvas;
     std::vector<tvg::Scene*> layers;
 
+    struct ImageTarget
+    {
+        uint32_t* buffer = nullptr;
+        QSize size;
+        QImage::Format format = QImage::Format_Invalid;
+
+        bool operator==(const ImageTarget& oth) const
+        {
+            return buffer == oth.buffer && size == oth.size && format == oth.format;
+        }
+    };
+    /// Image the current canvas draws into, if any
+    ImageTarget image_target;
+    /// Images referenced by the scene without copying, kept alive until the scene is dropped
+    std::vector<QImage> frame_images;
+
     tvg::Fill* make_fill(const QBrush& brush, qreal opacity)
     {
         auto gradient = brush.gradient();
@@ -149,6 +167,16 @@ private:
         }
     }
 
+    /**
+     * \brief ThorVG reference counts its engine without synchronization,
+     * renderers can be created from multiple threads
+     */
+    static std::mutex& init_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
     tvg::Picture* convert_image(const QImage & image, bool copy = false)
     {
         auto picture = tvg::Picture::gen();
@@ -172,12 +200,14 @@ private:
 public:
     explicit ThorvgRenderer(int quality): effect_quality(quality * 10)
     {
+        auto lock = std::lock_guard(init_mutex());
         // 4 threads
         tvg::Initializer::init(4);
     }
 
     ~ThorvgRenderer()
     {
+        auto lock = std::lock_guard(init_mutex());
         tvg::Initializer::term();
     }
 
@@ -188,9 +218,15 @@ public:
 
     void set_image_surface(QImage * destination) override
     {
+        ImageTarget target{reinterpret_cast<uint32_t*>(destination->bits()), destination->size(), destination->format()};
+        // Rendering multiple frames into the same image, keep the canvas
+        if ( canvas && target == image_target )
+            return;
+
+        image_target = target;
         auto sw_canvas = tvg::SwCanvas::gen();
         sw_canvas->target(
-            reinterpret_cast<uint32_t*>(destination->bits()),
+            target.buffer,
             // destination->bytesPerLine(),
             destination->width(),
             destination->width(),
@@ -206,6 +242,7 @@ public:
         auto gl_canvas = tvg::GlCanvas::gen();
         if ( !gl_canvas )
             return false;
+        image_target = {};
         canvas.reset(gl_canvas);
         return gl_canvas->target(nullptr, nullptr, context, framebuffer, width, height, tvg::ColorSpace::ABGR8888S) == tvg::Result::Success;
 #else
@@ -224,15 +261,27 @@ public:
 
     void render_start() override
     {
+        // Drop the scene from the previous frame, there is no canvas until a surface is set
+        if ( canvas )
+            canvas->remove();
+        frame_images.clear();
         layer_start();
     }
 
     void render_end() override
     {
-        canvas->add(layers[0]);
+        if ( canvas )
+        {
+            canvas->add(layers[0]);
+            canvas->draw(true);
+            canvas->sync();
+        }
+        else
+        {
+            // Nothing to draw on, the scene isn't owned by a canvas
+            layers[0]->unref();
+        }
         layers.clear();
-        canvas->draw(true);
-        canvas->sync();
         mask_flags = 0;
     }
 
@@ -401,13 +450,17 @@ public:
     void draw_image(const QImage & image) override
     {
         if ( auto picture = convert_image(image) )
+        {
+            frame_images.push_back(image);
             layers.back()->add(picture);
+        }
     }
 
     void fill_pattern(const QRectF& rect, const QImage& pattern) override
     {
         if ( auto picture = convert_image(pattern) )
         {
+            frame_images.push_back(pattern);
             layer_start();
             clip_rect(rect);
             for ( int y = rect.top(); y < rect.bottom(); y += pattern.height() )
@@ -0,0 +1,38 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace glaxnimate::av {
+
+/**
+ * \brief Copies \p rows rows of pixel data between buffers with different strides
+ *
+ * Each row copies \p row_bytes bytes, when both strides match the whole
+ * plane is copied at once.
+ */
+inline void copy_plane(uint8_t* dest, int dest_stride, const uint8_t* src, int src_stride, int row_bytes, int rows)
+{
+    if ( rows <= 0 )
+        return;
+
+    row_bytes = std::min({row_bytes, dest_stride, src_stride});
+
+    if ( dest_stride == src_stride && row_bytes == src_stride )
+    {
+        std::memcpy(dest, src, std::size_t(src_stride) * rows);
+        return;
+    }
+
+    for ( int y = 0; y < rows; y++ )
+        std::memcpy(dest + std::ptrdiff_t(y) * dest_stride, src + std::ptrdiff_t(y) * src_stride, row_bytes);
+}
+
+} // namespace glaxnimate::av
@@ -7,9 +7,15 @@
 #include "glaxnimate/module/video/video_format.hpp"
 
 #include <mutex>
+#include <condition_variable>
 #include <cstring>
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
+
+#include <QThread>
+#include <QThreadPool>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -21,6 +27,7 @@ extern "C" {
 #include "glaxnimate/utils/qstring_exception.hpp"
 #include "glaxnimate/log/log.hpp"
 #include "glaxnimate/model/assets/composition.hpp"
+#include "glaxnimate/module/video/pixel_copy.hpp"
 
 namespace glaxnimate::av {
 
@@ -90,7 +97,6 @@ struct OutputStream
     {
         avcodec_free_context(&codec_context);
         av_frame_free(&frame);
-        av_frame_free(&tmp_frame);
         sws_freeContext(sws_context);
     }
 
@@ -146,7 +152,6 @@ struct OutputStream
     int64_t next_pts = 0;
 
     AVFrame *frame = nullptr;
-    AVFrame *tmp_frame = nullptr;
 
     SwsContext *sws_context = nullptr;
     AVFormatContext *format_context = nullptr;
@@ -466,8 +471,6 @@ public:
         if (!ost.frame)
             throw av::Error(i18n("Could not allocate video frame"));
 
-        ost.tmp_frame = nullptr;
-
         /* copy the stream parameters to the muxer */
         ret = avcodec_parameters_from_context(ost.stream->codecpar, ost.codec_context);
         if (ret < 0)
@@ -476,22 +479,20 @@ public:
 
     static void fill_image(AVFrame *pict, const QImage& image)
     {
-        for ( int y = 0; y < image.height(); y++)
-        {
-            auto line = image.constScanLine(y);
-            for ( int x = 0; x < image.bytesPerLine(); x++ )
-            {
-                pict->data[0][y * pict->linesize[0] + x] = line[x];
-            }
-        }
+        copy_plane(pict->data[0], pict->linesize[0], image.constBits(), image.bytesPerLine(), image.bytesPerLine(), image.height());
     }
 
-    AVFrame *get_video_frame(QImage image)
+    void make_frame_writable()
     {
         // when we pass a frame to the encoder, it may keep a reference to it
         // internally; make sure we do not overwrite it here
         if ( av_frame_make_writable(ost.frame) < 0 )
             throw av::Error(i18n("Error while creating video frame"));
+    }
+
+    AVFrame *get_video_frame(QImage image)
+    {
+        make_frame_writable();
 
         auto format = image_format(image.format());
         if ( format.first == AV_PIX_FMT_NONE )
@@ -517,16 +518,11 @@ public:
                 if (!ost.sws_context)
                     throw av::Error(i18n("Could not initialize the conversion context"));
             }
-            if ( !ost.tmp_frame )
-            {
-                ost.tmp_frame = alloc_picture(format.first, image.width(), image.height());
-                if (!ost.tmp_frame)
-                    throw av::Error(i18n("Could not allocate temporary picture"));
-            }
-            fill_image(ost.tmp_frame, image);
-            sws_scale(ost.sws_context, (const uint8_t * const *) ost.tmp_frame->data,
-                    ost.tmp_frame->linesize, 0, ost.codec_context->height, ost.frame->data,
-                    ost.frame->linesize);
+            // Use the image buffer as source directly, no need to copy it to a temporary frame
+            const uint8_t* source[4] = {image.constBits(), nullptr, nullptr, nullptr};
+            int source_stride[4] = {int(image.bytesPerLine()), 0, 0, 0};
+            sws_scale(ost.sws_context, source, source_stride, 0, image.height(),
+                    ost.frame->data, ost.frame->linesize);
         }
         else
         {
@@ -543,6 +539,39 @@ public:
         ost.write_frame(get_video_frame(image));
     }
 
+    /**
+     * \brief Returns an image sharing the buffer of the next frame to encode
+     *
+     * Rendering into it and calling write_frame_image() avoids any copy.
+     * \returns A null image if the codec needs a conversion from \p size
+     * and Format_ARGB32 pixels
+     */
+    QImage frame_image(const QSize& size)
+    {
+        if ( size.width() != ost.codec_context->width || size.height() != ost.codec_context->height )
+            return {};
+
+        if ( ost.codec_context->pix_fmt != image_format(QImage::Format_ARGB32).first )
+            return {};
+
+        make_frame_writable();
+
+        // Some renderers ignore the stride of the image
+        if ( ost.frame->linesize[0] != size.width() * 4 )
+            return {};
+
+        return QImage(ost.frame->data[0], size.width(), size.height(), ost.frame->linesize[0], QImage::Format_ARGB32);
+    }
+
+    /**
+     * \brief Encodes the frame rendered into the image from frame_image()
+     */
+    void write_frame_image()
+    {
+        ost.frame->pts = ost.next_pts++;
+        ost.write_frame(ost.frame);
+    }
+
     void flush()
     {
         ost.flush_frames();
@@ -707,6 +736,118 @@ private:
 
 } // namespace glaxnimate::av
 
+namespace glaxnimate::video {
+
+/**
+ * \brief Renders frames ahead of the encoder on a pool of worker threads
+ *
+ * Frames are claimed in order by the workers and kept in a bounded reorder
+ * queue until take() hands them to the encoder in presentation order.
+ * Each worker keeps its own renderer and images given back with recycle()
+ * are reused for later frames.
+ */
+class FramePipeline
+{
+public:
+    FramePipeline(model::Composition* comp, int first_frame, int last_frame, const QSize& size, const QColor& background, int threads)
+        : comp(comp),
+          last_frame(last_frame),
+          next_frame(first_frame),
+          consumed(first_frame),
+          max_queued(threads * 2),
+          size(size),
+          background(background)
+    {
+        pool.setMaxThreadCount(threads);
+        for ( int i = 0; i < threads; i++ )
+            pool.start([this]{ work(); });
+    }
+
+    ~FramePipeline()
+    {
+        {
+            auto lock = std::lock_guard(mutex);
+            stopped = true;
+        }
+        condition.notify_all();
+        pool.waitForDone();
+    }
+
+    /**
+     * \brief Blocks until \p frame has been rendered and removes it from the queue
+     * \pre Frames are taken in sequence
+     */
+    QImage take(int frame)
+    {
+        auto lock = std::unique_lock(mutex);
+        condition.wait(lock, [this, frame]{ return rendered.count(frame); });
+        auto node = rendered.extract(frame);
+        consumed = frame + 1;
+        lock.unlock();
+        condition.notify_all();
+        return std::move(node.mapped());
+    }
+
+    /**
+     * \brief Gives back an image returned by take() so its buffer can be reused
+     */
+    void recycle(QImage&& image)
+    {
+        auto lock = std::lock_guard(mutex);
+        free_images.push_back(std::move(image));
+    }
+
+private:
+    void work()
+    {
+        auto renderer = renderer::RendererRegistry::instance().default_renderer(10);
+        while ( true )
+        {
+            int frame;
+            QImage image;
+            {
+                auto lock = std::unique_lock(mutex);
+                // Don't get too far ahead of the encoder
+                condition.wait(lock, [this]{ return stopped || next_frame - consumed < max_queued; });
+                if ( stopped || next_frame >= last_frame )
+                    return;
+                frame = next_frame++;
+                if ( !free_images.empty() )
+                {
+                    image = std::move(free_images.back());
+                    free_images.pop_back();
+                }
+            }
+
+            if ( image.isNull() )
+                image = QImage(size, QImage::Format_ARGB32);
+            comp->render_image(frame, image, renderer.get(), background);
+
+            {
+                auto lock = std::lock_guard(mutex);
+                rendered.emplace(frame, std::move(image));
+            }
+            condition.notify_all();
+        }
+    }
+
+    model::Composition* comp;
+    int last_frame;
+    int next_frame;
+    int consumed;
+    int max_queued;
+    QSize size;
+    QColor background;
+    bool stopped = false;
+    std::map<int, QImage> rendered;
+    std::vector<QImage> free_images;
+    std::mutex mutex;
+    std::condition_variable condition;
+    QThreadPool pool;
+};
+
+} // namespace glaxnimate::video
+
 static QStringList out_ext;
 
 static bool format_skip(const AVOutputFormat* format)
@@ -845,11 +986,43 @@ bool glaxnimate::video::VideoFormat::on_save(QIODevice& dev, const QString& name
         auto first_frame = comp->animation->first_frame.get();
         auto last_frame = comp->animation->last_frame.get();
         QColor background = settings["background"].value<QColor>();
+        int threads = settings["threads"].toInt();
+        if ( threads <= 0 )
+            threads = QThread::idealThreadCount();
         Q_EMIT progress_max_changed(last_frame - first_frame);
-        for ( int i = first_frame; i < last_frame; i++ )
+        if ( threads <= 1 )
+        {
+            QImage image;
+            auto renderer = renderer::RendererRegistry::instance().default_renderer(10);
+            for ( int i = first_frame; i < last_frame; i++ )
+            {
+                // Render straight into the encoder frame when possible
+                QImage frame_image = video.frame_image({width, height});
+                if ( !frame_image.isNull() )
+                {
+                    comp->render_image(i, frame_image, renderer.get(), background);
+                    video.write_frame_image();
+                }
+                else
+                {
+                    if ( image.isNull() )
+                        image = QImage(width, height, QImage::Format_ARGB32);
+                    comp->render_image(i, image, renderer.get(), background);
+                    video.write_video_frame(image);
+                }
+                Q_EMIT progress(i - first_frame);
+            }
+        }
+        else
         {
-            video.write_video_frame(comp->render_image(i, {width, height}, background));
-            Q_EMIT progress(i - first_frame);
+            FramePipeline pipeline(comp, first_frame, last_frame, {width, height}, background, threads);
+            for ( int i = first_frame; i < last_frame; i++ )
+            {
+                QImage image = pipeline.take(i);
+                video.write_video_frame(image);
+                pipeline.recycle(std::move(image));
+                Q_EMIT progress(i - first_frame);
+            }
         }
 
         video.flush();
@@ -877,5 +1050,6 @@ std::unique_ptr<glaxnimate::settings::SettingsGroup> glaxnimate::video::VideoFor
         glaxnimate::settings::Setting{"width",         i18n("Width"),      i18n("If not 0, it will overwrite the size"),       int(comp->width.get()),  0, 99999},
         glaxnimate::settings::Setting{"height",        i18n("Height"),     i18n("If not 0, it will overwrite the size"),       int(comp->height.get()), 0, 99999},
         glaxnimate::settings::Setting{"verbose",       i18n("Verbose"),    i18n("Show verbose information on the conversion"), false},
+        glaxnimate::settings::Setting{"threads",       i18n("Threads"),    i18n("Number of frames rendered in parallel, 0 to use all available cores"), 0, 0, 256},
     });
 }
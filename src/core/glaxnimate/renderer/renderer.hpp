@@ -171,10 +171,22 @@ public:
 
     virtual void set_quality(int quality) = 0;
 
+    /**
+     * \brief Sets the resolution bitmaps should be drawn at, relative to their full size
+     *
+     * Values below 1 allow drawing reduced-resolution variants of large images
+     * where preview quality is enough.
+     */
+    void set_image_detail(qreal detail) { this->detail = detail; }
+    qreal image_detail() const { return detail; }
+
 // Transform
     virtual void scale(qreal x, qreal y) = 0;
     virtual void translate(qreal x, qreal y) = 0;
     virtual void transform(const QTransform& matrix) = 0;
+
+private:
+    qreal detail = 1;
 };
 
 class RendererRegistry
@@ -0,0 +1,176 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include <QMutex>
+
+namespace glaxnimate::utils {
+
+/**
+ * \brief Least recently used values within a memory budget
+ *
+ * Keys need operator== and a hash() member function.
+ *
+ * Other than get(), functions don't lock anything: the owner guards the
+ * cache with its own mutex so it can share it between multiple caches.
+ */
+template<class Key, class Value>
+class LruCache
+{
+public:
+    explicit LruCache(qint64 memory_budget)
+        : budget(memory_budget)
+    {}
+
+    /**
+     * \brief Returns the value for \p key, calling \p build on a cache miss
+     * \param mutex     Mutex guarding the cache
+     * \param size_of   Returns the memory usage in bytes of a built value
+     */
+    template<class Build, class SizeOf>
+    Value get(QMutex& mutex, const Key& key, const Build& build, const SizeOf& size_of)
+    {
+        {
+            QMutexLocker lock(&mutex);
+            if ( auto value = find(key) )
+            {
+                hit_count++;
+                return *value;
+            }
+            miss_count++;
+        }
+
+        // Build without holding the lock so other threads can keep using the cache.
+        // If two threads miss on the same key they both build it, which is wasteful but harmless
+        Value value = build();
+
+        QMutexLocker lock(&mutex);
+        if ( auto cached = find(key) )
+            return *cached;
+        insert(key, value, size_of(value));
+        return value;
+    }
+
+    /**
+     * \brief Returns the value for \p key (marking it as most recently used) or \b nullptr
+     */
+    const Value* find(const Key& key)
+    {
+        auto it = index.find(key);
+        if ( it == index.end() )
+            return nullptr;
+
+        // Most recently used at the front
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->value;
+    }
+
+    /**
+     * \brief Adds a value using \p size bytes, values larger than the budget are not kept
+     */
+    void insert(const Key& key, const Value& value, qint64 size)
+    {
+        if ( size > budget )
+            return;
+
+        entries.push_front({key, value, size});
+        index[key] = entries.begin();
+        usage += size;
+        evict();
+    }
+
+    qint64 memory_budget() const
+    {
+        return budget;
+    }
+
+    /**
+     * \brief Changes the memory budget, evicting values if needed
+     */
+    void set_memory_budget(qint64 bytes)
+    {
+        budget = bytes;
+        evict();
+    }
+
+    qint64 memory_usage() const
+    {
+        return usage;
+    }
+
+    qint64 size() const
+    {
+        return entries.size();
+    }
+
+    /**
+     * \brief Number of lookups in get() that found the value
+     */
+    qint64 hits() const
+    {
+        return hit_count;
+    }
+
+    /**
+     * \brief Number of lookups in get() that had to build the value
+     */
+    qint64 misses() const
+    {
+        return miss_count;
+    }
+
+    void reset_stats()
+    {
+        hit_count = miss_count = 0;
+    }
+
+    void clear()
+    {
+        entries.clear();
+        index.clear();
+        usage = 0;
+    }
+
+private:
+    struct Entry
+    {
+        Key key;
+        Value value;
+        qint64 size;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const
+        {
+            return key.hash();
+        }
+    };
+
+    void evict()
+    {
+        while ( usage > budget && !entries.empty() )
+        {
+            auto it = std::prev(entries.end());
+            usage -= it->size;
+            index.erase(it->key);
+            entries.erase(it);
+        }
+    }
+
+    qint64 budget;
+    qint64 usage = 0;
+    qint64 hit_count = 0;
+    qint64 miss_count = 0;
+    std::list<Entry> entries;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> index;
+};
+
+} // namespace glaxnimate::utils
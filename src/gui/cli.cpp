@@ -7,6 +7,13 @@
 #include "cli.hpp"
 
 #include <QImageWriter>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <algorithm>
 
 #include <KLocalizedString>
 
@@ -19,6 +26,7 @@
 
 #include "plugin/executor.hpp"
 #include "plugin/plugin.hpp"
+#include "plugin/io.hpp"
 
 glaxnimate::cli::ParsedArguments glaxnimate::gui::parse_cli(const QStringList& args)
 {
@@ -106,6 +114,24 @@ glaxnimate::cli::ParsedArguments glaxnimate::gui::parse_cli(const QStringList& a
         glaxnimate::cli::Argument::Flag
     });
 
+    parser.add_group(i18nc("@info:shell", "Batch Options"));
+    parser.add_argument({
+        {"--batch"},
+        i18nc("@info:shell", "Convert or render the files listed in the given manifest, use - to read it from standard input. "
+            "Each line has an input file, an output file, and optionally the frames to render (as for --frame, or FIRST:LAST), separated by tabs. "
+            "The result of each job is printed as a line of JSON"),
+        glaxnimate::cli::Argument::String,
+        {},
+        "MANIFEST"
+    });
+    parser.add_argument({
+        {"--jobs", "-j"},
+        i18nc("@info:shell", "Number of batch jobs to run in parallel, 0 to use all available cores"),
+        glaxnimate::cli::Argument::Int,
+        {0},
+        "JOBS"
+    });
+
     return parser.parse(args);
 }
 
@@ -116,9 +142,14 @@ namespace  {
 class CliPluginExecutor : public glaxnimate::plugin::Executor
 {
 public:
+    /**
+     * \param document Exposed to scripts as \c document, batches don't have one
+     * so scripts accessing it fail on the missing name instead of using a null document
+     */
     CliPluginExecutor(glaxnimate::model::Document* document)
     {
-        globals["document"] = QVariant::fromValue(document);
+        if ( document )
+            globals["document"] = QVariant::fromValue(document);
         globals["window"] = {};
 
         for ( const auto& engine : glaxnimate::plugin::ScriptEngineFactory::instance().engines() )
@@ -214,39 +245,127 @@ void log_message(const QString& message, glaxnimate::log::Severity severity)
 }
 
 
-std::unique_ptr<glaxnimate::model::Document> cli_open(const glaxnimate::cli::ParsedArguments& args)
+glaxnimate::io::ImportExport* find_exporter(const QString& format, const QString& output_filename, QString& error)
+{
+    using namespace glaxnimate;
+
+    io::ImportExport* exporter = nullptr;
+    if ( !format.isEmpty() )
+        exporter = io::IoRegistry::instance().from_slug(format, io::ImportExport::Export);
+    else
+        exporter = io::IoRegistry::instance().from_filename(output_filename, io::ImportExport::Export);
+
+    if ( !exporter || !exporter->can_save() )
+    {
+        error = i18nc("@info:shell", "Unknown exporter. Use --export-format-list for a list of available formats");
+        return nullptr;
+    }
+
+    return exporter;
+}
+
+glaxnimate::io::ImportExport* find_frame_exporter(const QString& format, const QString& output_filename, QString& error)
+{
+    using namespace glaxnimate;
+
+    io::ImportExport* exporter = nullptr;
+    if ( !format.isEmpty() )
+    {
+        exporter = io::IoRegistry::instance().from_slug(format, io::ImportExport::FrameExport);
+        if ( !exporter )
+            exporter = io::IoRegistry::instance().from_extension(format, glaxnimate::io::ImportExport::FrameExport);
+
+        if ( exporter && !exporter->can_save_static() )
+            exporter = nullptr;
+    }
+    else
+    {
+        exporter = io::IoRegistry::instance().from_filename(output_filename, glaxnimate::io::ImportExport::FrameExport);
+    }
+
+    if ( !exporter )
+        error = i18nc("@info:shell", "Unknown render format. Use --render-format-list for a list of available formats");
+
+    return exporter;
+}
+
+/**
+ * \brief Loads \p input_filename into \p document, on failure sets \p error
+ */
+bool load_document(const QString& input_filename, glaxnimate::model::Document* document, bool trace, QString& error)
 {
     using namespace glaxnimate;
 
-    QString input_filename = args.value("file").toString();
     auto importer = io::IoRegistry::instance().from_filename(input_filename, io::ImportExport::Import);
     if ( !importer || !importer->can_open() )
     {
-        glaxnimate::cli::show_message(i18nc("@info:shell", "Unknown importer"), true);
-        return {};
+        error = i18nc("@info:shell", "Unknown importer");
+        return false;
     }
 
     QFile input_file(input_filename);
     if ( !input_file.open(QIODevice::ReadOnly) )
     {
-        glaxnimate::cli::show_message(i18nc("@info:shell", "Could not open input file for reading"), true);
-        return {};
+        error = i18nc("@info:shell", "Could not open input file for reading");
+        return false;
+    }
+
+    auto open_settings = io_settings(importer->open_settings());
+    open_settings["trace"] = trace;
+
+    if ( !importer->open(input_file, input_filename, document, open_settings) )
+    {
+        error = i18nc("@info:shell", "Error loading input file");
+        return false;
     }
 
+    return true;
+}
+
+/**
+ * \brief Saves the main composition of \p document, on failure sets \p error
+ */
+bool save_document(glaxnimate::model::Document* document, glaxnimate::io::ImportExport* exporter, const QString& output_filename, QString& error)
+{
+    using namespace glaxnimate;
+
+    /// \todo fix this (pass argument?)
+    if ( document->assets()->compositions->values.empty() )
+    {
+        error = i18nc("@info:shell", "The input file has no compositions");
+        return false;
+    }
+    auto comp = document->assets()->compositions->values[0];
+
+    QFile output_file(output_filename);
+    if ( !output_file.open(QIODevice::WriteOnly) )
+    {
+        error = i18nc("@info:shell", "Could not open output file for writing");
+        return false;
+    }
+
+    if ( !exporter->save(output_file, output_filename, comp, io_settings(exporter->save_settings(comp))) )
+    {
+        error = i18nc("@info:shell", "Error converting to the output format");
+        return false;
+    }
+
+    return true;
+}
+
+std::unique_ptr<glaxnimate::model::Document> cli_open(const glaxnimate::cli::ParsedArguments& args)
+{
+    QString input_filename = args.value("file").toString();
     auto document = std::make_unique<glaxnimate::model::Document>(input_filename);
 
     CliPluginExecutor script_executor(document.get());
 
-    auto open_settings = io_settings(importer->open_settings());
-    open_settings["trace"] = args.value("trace");
-
-    QObject::connect(importer, &io::ImportExport::message, &log_message);
-    if ( !importer->open(input_file, input_filename, document.get(), open_settings) )
+    QString error;
+    if ( !load_document(input_filename, document.get(), args.value("trace").toBool(), error) )
     {
-        glaxnimate::cli::show_message(i18nc("@info:shell", "Error loading input file"), true);
+        glaxnimate::cli::show_message(error, true);
         return {};
     }
-    input_file.close();
 
     return document;
 }
@@ -261,61 +380,116 @@ bool cli_export(const glaxnimate::cli::ParsedArguments& args)
         return false;
     }
 
-    io::ImportExport* exporter = nullptr;
-    QString format = args.value("export-format").toString();
     QString output_filename = args.value("export").toString();
-
-    if ( !format.isEmpty() )
-        exporter = io::IoRegistry::instance().from_slug(format, io::ImportExport::Export);
-    else
-        exporter = io::IoRegistry::instance().from_filename(output_filename, io::ImportExport::Export);
-
-    if ( !exporter || !exporter->can_save() )
+    QString error;
+    auto exporter = find_exporter(args.value("export-format").toString(), output_filename, error);
+    if ( !exporter )
     {
-        glaxnimate::cli::show_message(i18nc("@info:shell", "Unknown exporter. Use --export-format-list for a list of available formats"), true);
+        glaxnimate::cli::show_message(error, true);
         return false;
     }
 
     auto document = cli_open(args);
-    if ( !document || document->assets()->compositions->values.empty() )
+    if ( !document )
         return false;
 
-    QFile output_file(output_filename);
-    if ( !output_file.open(QIODevice::WriteOnly) )
+    if ( !save_document(document.get(), exporter, output_filename, error) )
     {
-        glaxnimate::cli::show_message(i18nc("@info:shell", "Could not open output file for writing"), true);
+        glaxnimate::cli::show_message(error, true);
         return false;
     }
 
-    QObject::connect(exporter, &io::ImportExport::message, &log_message);
-    /// \todo fix this (pass argument?)
-    auto comp = document->assets()->compositions->values[0];
-    if ( !exporter->save(output_file, output_filename, comp, io_settings(exporter->save_settings(comp))) )
+    return true;
+}
+
+bool render_frame(
+    const QString& filename,
+    glaxnimate::model::Composition* comp,
+    glaxnimate::model::FrameTime time,
+    glaxnimate::io::ImportExport* renderer,
+    QStringList& errors
+)
+{
+    QFile file(filename);
+    if ( !file.open(QFile::WriteOnly) )
+    {
+        errors.push_back(i18nc("@info:shell", "Could not save to %1", filename));
+        return false;
+    }
+
+    if ( !renderer->save_static(file, filename, comp, time, {}) )
     {
-        glaxnimate::cli::show_message(i18nc("@info:shell", "Error converting to the output format"), true);
+        errors.push_back(i18nc("@info:shell", "Could not render frame %1", time));
         return false;
     }
 
     return true;
 }
 
-using render_funcptr = void (*)(glaxnimate::model::Composition* comp, glaxnimate::model::FrameTime time, QFile& file, const char* format);
-
-void render_frame(
-    const QString& filename,
+/**
+ * \brief Renders the frames described by \p frame
+ *
+ * \p frame is either a single frame number, `all`, or a range as `FIRST:LAST`
+ * not including the frame at LAST.
+ * Multiple frames are saved as numbered files based on \p output_filename.
+ * \returns Errors for frames that couldn't be rendered
+ */
+QStringList render_frames(
+    const QString& output_filename,
     glaxnimate::model::Composition* comp,
-    glaxnimate::model::FrameTime time,
+    const QString& frame,
     glaxnimate::io::ImportExport* renderer
 )
 {
-    QFile file(filename);
-    if ( !file.open(QFile::WriteOnly) )
+    QStringList errors;
+    QFileInfo finfo(output_filename);
+
+    auto dir = finfo.dir();
+    if ( !dir.exists() )
     {
-        glaxnimate::cli::show_message(i18nc("@info:shell", "Could not save to %1", filename), true);
-        return;
+        auto name = dir.dirName();
+        dir.cdUp();
+        dir.mkpath(name);
+        dir.cd(name);
     }
 
-    renderer->save_static(file, filename, comp, time, {});
+    float ip = comp->animation->first_frame.get();
+    float op = comp->animation->last_frame.get();
+
+    if ( frame != "all" && frame != "-" && frame != "*" )
+    {
+        auto range = frame.split(':');
+        bool ok = range.size() <= 2;
+        if ( ok )
+            ip = range[0].toDouble(&ok);
+
+        if ( ok && range.size() == 1 )
+        {
+            render_frame(output_filename, comp, ip, renderer, errors);
+            return errors;
+        }
+
+        if ( ok )
+            op = range[1].toDouble(&ok);
+
+        if ( !ok )
+        {
+            errors.push_back(i18nc("@info:shell", "Invalid frame: %1", frame));
+            return errors;
+        }
+    }
+
+    float last = comp->animation->last_frame.get();
+    float pad = last != 0 ? std::ceil(std::log(last) / std::log(10)) : 1;
+
+    for ( int f = ip; f < op; f += 1 )
+    {
+        QString frame_name = QString::number(f).rightJustified(pad, '0');
+        QString file_name = dir.filePath(finfo.baseName() + frame_name + "." + finfo.completeSuffix());
+        render_frame(file_name, comp, f, renderer, errors);
+    }
+
+    return errors;
 }
 
 bool cli_render(const glaxnimate::cli::ParsedArguments& args)
@@ -328,70 +502,240 @@ bool cli_render(const glaxnimate::cli::ParsedArguments& args)
         return false;
     }
 
-    QString format = args.value("render-format").toString();
     QString output_filename = args.value("render").toString();
-    QFileInfo finfo(output_filename);
-
-    io::ImportExport* exporter = nullptr;
-    if ( !format.isEmpty() )
+    QString error;
+    auto exporter = find_frame_exporter(args.value("render-format").toString(), output_filename, error);
+    if ( !exporter )
     {
-        exporter = io::IoRegistry::instance().from_slug(format, io::ImportExport::FrameExport);
-        if ( !exporter )
-            exporter = io::IoRegistry::instance().from_extension(format, glaxnimate::io::ImportExport::FrameExport);
-
-        if ( !exporter || !exporter->can_save_static() )
-            return false;
-    }
-    else
-    {
-        exporter = io::IoRegistry::instance().from_filename(output_filename, glaxnimate::io::ImportExport::FrameExport);
-        if ( !exporter )
-            return false;
+        glaxnimate::cli::show_message(error, true);
+        return false;
     }
 
     auto document = cli_open(args);
-    if ( !document )
+    if ( !document || document->assets()->compositions->values.empty() )
         return false;
 
-    auto dir = finfo.dir();
-    if ( !dir.exists() )
-    {
-        auto name = dir.dirName();
-        dir.cdUp();
-        dir.mkpath(name);
-        dir.cd(name);
-    }
-
     /// \todo fix this (pass argument?)
     auto comp = document->assets()->compositions->values[0];
 
-    QString frame = args.value("frame").toString();
-    if ( frame == "all" || frame == "-" || frame == "*" )
+    for ( const auto& frame_error : render_frames(output_filename, comp, args.value("frame").toString(), exporter) )
+        glaxnimate::cli::show_message(frame_error, true);
+
+    return true;
+}
+
+/**
+ * \brief Single conversion or render in a batch
+ */
+struct BatchJob
+{
+    int index = 0;
+    QString input;
+    QString output;
+    /// Frames to render, empty to convert the whole file
+    QString frames;
+    /// Set for jobs that go through script plugins, which can't run concurrently
+    bool serial = false;
+
+    QString error;
+    double load_ms = 0;
+    double save_ms = 0;
+    double total_ms = 0;
+};
+
+/**
+ * \brief Parses a batch manifest
+ *
+ * Each line has an input file, an output file and optionally the frames to render.
+ * Fields are separated by tabs, or by spaces if the line has no tabs.
+ * Empty lines and lines starting with # are ignored.
+ */
+std::vector<BatchJob> parse_batch(QIODevice& manifest, const glaxnimate::cli::ParsedArguments& args)
+{
+    using namespace glaxnimate;
+
+    std::vector<BatchJob> jobs;
+    int line_number = 0;
+    while ( !manifest.atEnd() )
     {
+        QString line = QString::fromUtf8(manifest.readLine());
+        line_number++;
+        while ( line.endsWith('\n') || line.endsWith('\r') )
+            line.chop(1);
+
+        if ( line.trimmed().isEmpty() || line.trimmed().startsWith('#') )
+            continue;
+
+        QStringList fields;
+        if ( line.contains('\t') )
+            fields = line.split('\t');
+        else
+            fields = line.split(' ', Qt::SkipEmptyParts);
 
-        float ip = comp->animation->first_frame.get();
-        float op = comp->animation->last_frame.get();
-        float pad = op != 0 ? std::ceil(std::log(op) / std::log(10)) : 1;
+        BatchJob& job = jobs.emplace_back();
+        job.index = line_number;
 
-        for ( int f = ip; f < op; f += 1 )
+        if ( fields.size() < 2 || fields.size() > 3 )
         {
-            QString frame_name = QString::number(f).rightJustified(pad, '0');
-            QString file_name = dir.filePath(finfo.baseName() + frame_name + "." + finfo.completeSuffix());
-            render_frame(file_name, comp, f, exporter);
+            job.error = i18nc("@info:shell", "Expected input file, output file and optionally frames");
+            continue;
         }
+
+        job.input = fields[0];
+        job.output = fields[1];
+        if ( fields.size() == 3 )
+            job.frames = fields[2].trimmed();
+
+        // An unknown output format is reported in the job result without running it
+        auto importer = io::IoRegistry::instance().from_filename(job.input, io::ImportExport::Import);
+        auto exporter = job.frames.isEmpty()
+            ? find_exporter(args.value("export-format").toString(), job.output, job.error)
+            : find_frame_exporter(args.value("render-format").toString(), job.output, job.error);
+        job.serial = qobject_cast<plugin::IoFormat*>(importer) || qobject_cast<plugin::IoFormat*>(exporter);
+    }
+
+    return jobs;
+}
+
+void run_batch_job(BatchJob& job, const glaxnimate::cli::ParsedArguments& args)
+{
+    using namespace glaxnimate;
+
+    QElapsedTimer total_timer;
+    total_timer.start();
+
+    auto run = [&job, &args]{
+        io::ImportExport* exporter = job.frames.isEmpty()
+            ? find_exporter(args.value("export-format").toString(), job.output, job.error)
+            : find_frame_exporter(args.value("render-format").toString(), job.output, job.error);
+        if ( !exporter )
+            return;
+
+        QElapsedTimer timer;
+        timer.start();
+        model::Document document(job.input);
+        if ( !load_document(job.input, &document, args.value("trace").toBool(), job.error) )
+            return;
+        job.load_ms = timer.nsecsElapsed() / 1e6;
+
+        timer.restart();
+        if ( job.frames.isEmpty() )
+        {
+            save_document(&document, exporter, job.output, job.error);
+        }
+        else if ( document.assets()->compositions->values.empty() )
+        {
+            job.error = i18nc("@info:shell", "The input file has no compositions");
+        }
+        else
+        {
+            auto comp = document.assets()->compositions->values[0];
+            job.error = render_frames(job.output, comp, job.frames, exporter).join('\n');
+        }
+        job.save_ms = timer.nsecsElapsed() / 1e6;
+    };
+
+    if ( job.error.isEmpty() )
+        run();
+
+    job.total_ms = total_timer.nsecsElapsed() / 1e6;
+}
+
+/**
+ * \brief Prints the result of \p job as a single line of JSON
+ */
+void print_batch_job(const BatchJob& job)
+{
+    static QMutex mutex;
+
+    QJsonObject result;
+    result["line"] = job.index;
+    result["input"] = job.input;
+    result["output"] = job.output;
+    if ( !job.frames.isEmpty() )
+        result["frames"] = job.frames;
+    result["status"] = job.error.isEmpty() ? "ok" : "error";
+    if ( !job.error.isEmpty() )
+        result["error"] = job.error;
+    result["load_ms"] = job.load_ms;
+    result["save_ms"] = job.save_ms;
+    result["total_ms"] = job.total_ms;
+
+    QMutexLocker lock(&mutex);
+    glaxnimate::cli::show_message(QString::fromUtf8(QJsonDocument(result).toJson(QJsonDocument::Compact)), false);
+    std::fflush(stdout);
+}
+
+bool cli_batch(const glaxnimate::cli::ParsedArguments& args)
+{
+    using namespace glaxnimate;
+
+    QString manifest_filename = args.value("batch").toString();
+    QFile manifest;
+    bool opened = false;
+    if ( manifest_filename == "-" )
+    {
+        opened = manifest.open(stdin, QIODevice::ReadOnly);
     }
     else
     {
-        render_frame(output_filename, comp, frame.toDouble(), exporter);
+        manifest.setFileName(manifest_filename);
+        opened = manifest.open(QIODevice::ReadOnly);
     }
 
-    return true;
+    if ( !opened )
+    {
+        glaxnimate::cli::show_message(i18nc("@info:shell", "Could not open the batch manifest"), true);
+        return false;
+    }
+
+    std::vector<BatchJob> jobs = parse_batch(manifest, args);
+
+    // A single script context for the whole batch, rather than one per file.
+    // Scripts only get the documents they are passed, there is no global one
+    CliPluginExecutor script_executor(nullptr);
+
+    int threads = args.value("jobs").toInt();
+    if ( threads <= 0 )
+        threads = QThread::idealThreadCount();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for ( auto& job : jobs )
+    {
+        if ( job.serial )
+            continue;
+
+        pool.start([&job, &args]{
+            run_batch_job(job, args);
+            print_batch_job(job);
+        });
+    }
+    pool.waitForDone();
+
+    for ( auto& job : jobs )
+    {
+        if ( !job.serial )
+            continue;
+
+        run_batch_job(job, args);
+        print_batch_job(job);
+    }
+
+    int failed = std::count_if(jobs.begin(), jobs.end(), [](const BatchJob& job){ return !job.error.isEmpty(); });
+    if ( failed )
+        glaxnimate::cli::show_message(i18nc("@info:shell", "%1 of %2 jobs failed", failed, int(jobs.size())), true);
+
+    return failed == 0;
 }
 
 void initialize_cli(glaxnimate::gui::GlaxnimateApp& app)
 {
     glaxnimate::gui::initialize_core();
     app.initialize();
+
+    for ( const auto& format : glaxnimate::io::IoRegistry::instance().registered() )
+        QObject::connect(format.get(), &glaxnimate::io::ImportExport::message, &log_message);
 }
 
 } // namespace
@@ -447,6 +791,15 @@ void glaxnimate::gui::cli_main(gui::GlaxnimateApp& app, glaxnimate::cli::ParsedA
         else
             args.return_value = 0;
     }
+
+    if ( args.is_defined("batch") )
+    {
+        initialize_cli(app);
+        if ( !cli_batch(args) )
+            args.return_value = 1;
+        else
+            args.return_value = 0;
+    }
 }
 
 bool glaxnimate::gui::cli_no_gui(const glaxnimate::cli::ParsedArguments& args)
@@ -457,6 +810,8 @@ bool glaxnimate::gui::cli_no_gui(const glaxnimate::cli::ParsedArguments& args)
         return true;
     if ( args.is_defined("render") )
         return true;
+    if ( args.is_defined("batch") )
+        return true;
     return false;
 }
 
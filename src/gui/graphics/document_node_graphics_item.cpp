@@ -20,7 +20,7 @@ graphics::DocumentNodeGraphicsItem::DocumentNodeGraphicsItem(model::VisualNode*
 
     setBoundingRegionGranularity(0);
 
-    connect(node, &model::Object::visual_property_changed, this, &DocumentNodeGraphicsItem::shape_changed);
+    connect(node, &model::Object::visual_property_changed, this, &DocumentNodeGraphicsItem::visual_property_changed);
     connect(node, &model::VisualNode::docnode_visible_recursive_changed, this, &DocumentNodeGraphicsItem::set_visible);
     connect(node, &model::VisualNode::bounding_rect_changed, this, &DocumentNodeGraphicsItem::shape_changed);
     set_visible(node->docnode_visible_recursive());
@@ -32,15 +32,36 @@ graphics::DocumentNodeGraphicsItem::~DocumentNodeGraphicsItem()
 void graphics::DocumentNodeGraphicsItem::shape_changed()
 {
 //     prepareGeometryChange();
+    Q_EMIT geometry_changing();
     rect_cache = {};
     cache_dirty = true;
 }
 
+void graphics::DocumentNodeGraphicsItem::visual_property_changed()
+{
+    shape_changed();
+    Q_EMIT damaged();
+}
+
+std::optional<QRectF> graphics::DocumentNodeGraphicsItem::cached_scene_bounding_rect() const
+{
+    if ( cache_dirty )
+        return {};
+    return sceneTransform().mapRect(rect_cache);
+}
+
+QRectF graphics::DocumentNodeGraphicsItem::updated_scene_bounding_rect()
+{
+    rect_cache = {};
+    cache_dirty = true;
+    return sceneBoundingRect();
+}
+
 QRectF graphics::DocumentNodeGraphicsItem::boundingRect() const
 {
     if ( cache_dirty )
     {
-        rect_cache = node_->local_bounding_rect(node_->time());
+        rect_cache = node_->cached_local_bounding_rect(node_->time());
         cache_dirty = false;
     }
     return rect_cache;
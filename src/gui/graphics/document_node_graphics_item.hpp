@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include <QGraphicsObject>
 
 namespace glaxnimate::model {
@@ -43,6 +45,17 @@ public:
     SelectionMode selection_mode() const { return selection_mode_; }
     void set_selection_mode(SelectionMode selection_mode) { selection_mode_ = selection_mode; }
 
+    /**
+     * \brief Scene bounding rect as it was last computed
+     * \returns An empty optional if the node has changed since
+     */
+    std::optional<QRectF> cached_scene_bounding_rect() const;
+
+    /**
+     * \brief Scene bounding rect computed from the current state of the node
+     */
+    QRectF updated_scene_bounding_rect();
+
 public Q_SLOTS:
     void set_visible(bool v)
     {
@@ -60,7 +73,9 @@ public Q_SLOTS:
 
     void set_transform_matrix(const QTransform& t)
     {
+        Q_EMIT geometry_changing();
         setTransform(t);
+        Q_EMIT damaged();
     }
 
     void set_opacity(qreal op)
@@ -68,6 +83,20 @@ public Q_SLOTS:
         setOpacity(op);
     }
 
+Q_SIGNALS:
+    /**
+     * \brief Emitted before the cached geometry is discarded
+     */
+    void geometry_changing();
+
+    /**
+     * \brief Emitted when the node changes in a way that affects how it's drawn
+     */
+    void damaged();
+
+private Q_SLOTS:
+    void visual_property_changed();
+
 protected:
     model::VisualNode* node_;
     bool visible_permitted = true;
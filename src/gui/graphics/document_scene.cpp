@@ -15,6 +15,7 @@
 #include "graphics/item_data.hpp"
 #include "tools/base.hpp"
 #include "glaxnimate/model/assets/composition.hpp"
+#include "glaxnimate/model/shapes/shape.hpp"
 
 using namespace glaxnimate::gui;
 
@@ -90,6 +91,48 @@ public:
         return it->second;
     }
 
+    void mark_damage_full()
+    {
+        damage_full = true;
+        damage_before.clear();
+        damaged_items.clear();
+    }
+
+    void item_geometry_changing(DocumentNodeGraphicsItem* item)
+    {
+        invalidation_pending = false;
+        if ( !damage_full && !damage_before.count(item) )
+            damage_before.emplace(item, item->cached_scene_bounding_rect());
+    }
+
+    void item_damaged(DocumentNodeGraphicsItem* item)
+    {
+        invalidation_pending = false;
+        if ( damage_full )
+            return;
+
+        // Shapes are drawn by the styles in the same group and operators
+        // in the outer groups, the rect of the outermost one covers all of them
+        if ( auto shape = item->node()->cast<model::ShapeElement>() )
+        {
+            if ( auto root = item_from_node(shape->drawing_root()) )
+                item = root;
+        }
+
+        item_geometry_changing(item);
+        if ( std::find(damaged_items.begin(), damaged_items.end(), item) == damaged_items.end() )
+            damaged_items.push_back(item);
+    }
+
+    void graphics_invalidated()
+    {
+        // The previous invalidation didn't come from a node in the scene
+        // (eg: an asset changed) so there's no telling what it affected
+        if ( invalidation_pending )
+            mark_damage_full();
+        invalidation_pending = true;
+    }
+
     model::Document* document = nullptr;
     std::unordered_map<model::VisualNode*, DocumentNodeGraphicsItem*> node_to_item;
     EditorMap node_to_editors;
@@ -98,6 +141,13 @@ public:
     // QBrush back;
     model::Composition* comp = nullptr;
     bool show_masks = false;
+
+    bool damage_full = true;
+    bool invalidation_pending = false;
+    /// Scene rect of items before they changed, empty if unknown
+    std::unordered_map<DocumentNodeGraphicsItem*, std::optional<QRectF>> damage_before;
+    /// Items that need both their old and new rect repainted
+    std::vector<DocumentNodeGraphicsItem*> damaged_items;
 };
 
 graphics::DocumentScene::DocumentScene()
@@ -121,11 +171,18 @@ void graphics::DocumentScene::set_document ( model::Document* document )
 {
     auto old = d->document;
 
+    if ( old )
+        disconnect(old, nullptr, this, nullptr);
+
     d->document = document;
     set_composition(nullptr);
     if ( document )
     {
-        connect(document, &model::Document::graphics_invalidated, this, [this]{update();});
+        connect(document, &model::Document::graphics_invalidated, this, [this]{
+            d->graphics_invalidated();
+            update();
+        });
+        connect(document, &model::Document::current_time_changing, this, [this]{ d->mark_damage_full(); });
         connect(document, &model::Document::record_to_keyframe_changed, this, [this]{update();});
     }
 
@@ -140,6 +197,7 @@ void graphics::DocumentScene::set_composition(model::Composition* comp)
     }
 
     clear_selection();
+    d->mark_damage_full();
     clear();
 
     d->comp = comp;
@@ -158,7 +216,10 @@ void graphics::DocumentScene::connect_node ( model::DocumentNode* n )
         return;
 
     d->node_to_item[node] = child;
+    d->mark_damage_full();
     child->setData(ItemData::NodePointer, QVariant::fromValue(node));
+    connect(child, &DocumentNodeGraphicsItem::geometry_changing, this, [this, child]{ d->item_geometry_changing(child); });
+    connect(child, &DocumentNodeGraphicsItem::damaged, this, [this, child]{ d->item_damaged(child); });
     connect(node, &model::DocumentNode::docnode_child_add_end, this, &DocumentScene::connect_node);
     connect(node, &model::DocumentNode::docnode_child_remove_end, this, &DocumentScene::disconnect_node);
     connect(node, &model::DocumentNode::docnode_child_move_end, this, &DocumentScene::move_node);
@@ -200,6 +261,7 @@ void graphics::DocumentScene::disconnect_node ( model::DocumentNode* n )
     auto item = d->node_to_item.find(node);
     if ( item != d->node_to_item.end() )
     {
+        d->mark_damage_full();
         delete item->second;
         d->node_to_item.erase(item);
     }
@@ -441,6 +503,7 @@ void graphics::DocumentScene::set_active_tool(tools::Tool* tool)
 
 void graphics::DocumentScene::move_node(model::DocumentNode* node, int, int)
 {
+    d->mark_damage_full();
     model::VisualNode* parent_node = static_cast<model::VisualNode*>(node)->docnode_visual_parent();
     int siblings_count = parent_node->docnode_child_count();
 
@@ -532,3 +595,32 @@ void graphics::DocumentScene::debug() const
 
     qDebug() << "==";
 }
+
+graphics::DocumentScene::Damage graphics::DocumentScene::take_damage()
+{
+    Damage damage;
+    damage.full = d->damage_full || d->invalidation_pending;
+
+    if ( !damage.full )
+    {
+        damage.rects.reserve(d->damaged_items.size() * 2);
+        for ( auto item : d->damaged_items )
+        {
+            const auto& before = d->damage_before[item];
+            if ( !before )
+            {
+                damage.full = true;
+                damage.rects.clear();
+                break;
+            }
+            damage.rects.push_back(*before);
+            damage.rects.push_back(item->updated_scene_bounding_rect());
+        }
+    }
+
+    d->damage_full = false;
+    d->invalidation_pending = false;
+    d->damage_before.clear();
+    d->damaged_items.clear();
+    return damage;
+}
@@ -28,6 +28,17 @@ public:
         Remove , ///< Removes from selection
     };
 
+    /**
+     * \brief Area of the composition that changed since it was last drawn
+     */
+    struct Damage
+    {
+        /// Whether the whole composition needs to be drawn again
+        bool full = true;
+        /// Changed areas in scene coordinates, with both the old and new position of the changed nodes
+        std::vector<QRectF> rects;
+    };
+
     DocumentScene();
     ~DocumentScene();
 
@@ -66,6 +77,11 @@ public:
 
     void debug() const;
 
+    /**
+     * \brief Returns the damage accumulated since the last call and resets it
+     */
+    Damage take_damage();
+
 Q_SIGNALS:
     void node_user_selected(const std::vector<model::VisualNode*>& selected, const std::vector<model::VisualNode*>& deselected);
     void document_changed(model::Document* new_doc, model::Document* old_doc);
@@ -324,7 +324,7 @@ void graphics::TransformGraphicsItem::update_handles()
     if ( d->block_updates )
         return;
     prepareGeometryChange();
-    d->cache = d->target->local_bounding_rect(d->target->time());
+    d->cache = d->target->cached_local_bounding_rect(d->target->time());
     for ( const auto& h : d->handles )
     {
         d->set_pos(h);
@@ -473,11 +473,7 @@ private:
         else if ( auto shape = node->cast<model::Shape>() )
         {
             selected_shapes.push_back(shape);
-            scene->invalidate(
-                shape->transform_matrix(shape->time())
-                .map(shape->local_bounding_rect(shape->time()))
-                .boundingRect()
-            );
+            scene->invalidate(shape->cached_bounding_rect(shape->time(), model::VisualNode::Conservative));
         }
     }
 
@@ -488,11 +484,7 @@ private:
         if ( auto shape = node->cast<model::Shape>() )
         {
             selected_shapes.erase(std::remove(selected_shapes.begin(), selected_shapes.end(), shape), selected_shapes.end());
-            scene->invalidate(
-                shape->transform_matrix(shape->time())
-                .map(shape->local_bounding_rect(shape->time()))
-                .boundingRect()
-            );
+            scene->invalidate(shape->cached_bounding_rect(shape->time(), model::VisualNode::Conservative));
         }
     }
 
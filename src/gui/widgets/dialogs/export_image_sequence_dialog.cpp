@@ -104,12 +104,12 @@ void glaxnimate::gui::ExportImageSequenceDialog::render()
 
         if ( is_svg )
         {
-            io::svg::SvgRenderer rend(io::svg::NotAnimated, io::svg::CssFontType::FontFace);
             QFile file(path.filePath(basename));
             if ( file.open(QFile::WriteOnly) )
             {
+                io::svg::SvgRenderer rend(&file, io::svg::NotAnimated, io::svg::CssFontType::FontFace);
                 rend.write_main(d->comp, f);
-                rend.write(&file, true);
+                rend.close();
             }
         }
         else
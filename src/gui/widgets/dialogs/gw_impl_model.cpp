@@ -244,7 +244,7 @@ void GlaxnimateWindow::Private::import_image()
     {
         auto bitmap = std::make_unique<model::Bitmap>(current_document.get());
         bitmap->filename.set(image_file);
-        if ( bitmap->pixmap().isNull() )
+        if ( bitmap->size().isEmpty() )
         {
             show_warning(i18n("Import Image"), i18n("Could not import image"));
             continue;
@@ -256,7 +256,7 @@ void GlaxnimateWindow::Private::import_image()
 
         auto image = std::make_unique<model::Image>(current_document.get());
         image->image.set(bmp_ptr);
-        QPointF p(bmp_ptr->pixmap().width() / 2.0, bmp_ptr->pixmap().height() / 2.0);
+        QPointF p(bmp_ptr->width.get() / 2.0, bmp_ptr->height.get() / 2.0);
         image->transform->anchor_point.set(p);
         image->transform->position.set(p);
         auto comp = current_composition();
@@ -5,6 +5,8 @@
  */
 #include "render_widget.hpp"
 
+#include <cmath>
+
 #include <QPainter>
 #include <QVBoxLayout>
 #include <QScrollBar>
@@ -12,6 +14,7 @@
 
 #include "glaxnimate_settings.hpp"
 #include "glaxnimate_app.hpp"
+#include "graphics/document_scene.hpp"
 
 using namespace glaxnimate;
 
@@ -33,6 +36,14 @@ public:
     QGraphicsView* view = nullptr;
     QVBoxLayout* layout;
 
+    /// Rendered composition, only the parts that changed are drawn again
+    QImage cache;
+    QTransform cache_transform;
+    bool cache_valid = false;
+    static constexpr int tile_size = 64;
+    /// Above this many separate areas it's faster to redraw their bounding box in one go
+    static constexpr int max_tiles_rects = 8;
+
     Private(RenderWidget* emitter, QWidget* parent)
         : emitter(emitter)
     {
@@ -54,6 +65,37 @@ public:
         world_transform.translate(-hb->value(), -vb->value());
         world_transform = view->transform() * world_transform;
     }
+
+    graphics::DocumentScene::Damage take_damage()
+    {
+        if ( view )
+        {
+            if ( auto scene = qobject_cast<graphics::DocumentScene*>(view->scene()) )
+                return scene->take_damage();
+        }
+        return {};
+    }
+
+    /**
+     * \brief Tiles of the cache image covering the given scene rects
+     */
+    QRegion damaged_tiles(const std::vector<QRectF>& rects) const
+    {
+        QTransform to_image = world_transform * QTransform::fromScale(global_scale, global_scale);
+        QRegion tiles;
+        for ( const auto& rect : rects )
+        {
+            // Extra margin for antialiasing
+            QRect pixels = to_image.mapRect(rect).toAlignedRect().adjusted(-2, -2, 2, 2);
+            int left = std::floor(pixels.left() / qreal(tile_size));
+            int top = std::floor(pixels.top() / qreal(tile_size));
+            int right = std::floor(pixels.right() / qreal(tile_size));
+            int bottom = std::floor(pixels.bottom() / qreal(tile_size));
+            QRect snapped(left * tile_size, top * tile_size, (right - left + 1) * tile_size, (bottom - top + 1) * tile_size);
+            tiles += snapped & cache.rect();
+        }
+        return tiles;
+    }
 };
 
 
@@ -72,9 +114,10 @@ public:
     }
 
 protected:
-    void render_composition()
+    void render_composition(const QPoint& offset = {})
     {
         d->renderer->render_start();
+        d->renderer->translate(-offset.x(), -offset.y());
         d->renderer->scale(d->global_scale, d->global_scale);
         d->renderer->layer_start();
         d->renderer->transform(d->world_transform);
@@ -83,6 +126,21 @@ protected:
         d->renderer->render_end();
     }
 
+    void render_tiles(const QRegion& tiles)
+    {
+        QPainter cache_painter(&d->cache);
+        cache_painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+        for ( const QRect& tile : tiles )
+        {
+            QImage img(tile.size(), QImage::Format_ARGB32_Premultiplied);
+            img.fill(Qt::transparent);
+            d->renderer->set_image_surface(&img);
+            render_composition(tile.topLeft());
+            cache_painter.drawImage(tile.topLeft(), img);
+        }
+    }
+
     void paintEvent(QPaintEvent* ev) override
     {
         Q_EMIT d->emitter->request_background();
@@ -109,11 +167,42 @@ protected:
         painter.setTransform({});
 
         // Composition
-        QImage img(qRound(this->width() * d->global_scale), qRound(this->height() * d->global_scale), QImage::Format_ARGB32_Premultiplied);
-        img.fill(Qt::transparent);
-        d->renderer->set_image_surface(&img);
-        render_composition();
-        painter.drawImage(QRectF(0, 0, width(), height()), img);
+        QSize image_size(qRound(this->width() * d->global_scale), qRound(this->height() * d->global_scale));
+        auto damage = d->take_damage();
+        if ( !d->cache_valid || d->cache.size() != image_size || d->cache_transform != d->world_transform )
+            damage.full = true;
+
+        QRegion tiles;
+        if ( !damage.full )
+        {
+            tiles = d->damaged_tiles(damage.rects);
+            if ( tiles.rectCount() > Private::max_tiles_rects )
+                tiles = tiles.boundingRect();
+
+            QRect bounds = tiles.boundingRect();
+            if ( qint64(bounds.width()) * bounds.height() * 2 > qint64(image_size.width()) * image_size.height() )
+                damage.full = true;
+        }
+
+        if ( damage.full )
+        {
+            d->cache = QImage(image_size, QImage::Format_ARGB32_Premultiplied);
+            d->cache.fill(Qt::transparent);
+            d->renderer->set_image_surface(&d->cache);
+            render_composition();
+            d->cache_transform = d->world_transform;
+            d->cache_valid = true;
+        }
+        else if ( !tiles.isEmpty() )
+        {
+            render_tiles(tiles);
+        }
+
+        painter.drawImage(QRectF(0, 0, width(), height()), d->cache);
+
+        // The changes outside this event would otherwise stay stale on screen
+        if ( (damage.full || !tiles.isEmpty()) && !QRegion(rect()).subtracted(ev->region()).isEmpty() )
+            update();
     }
 
 };
@@ -267,6 +356,7 @@ QWidget * glaxnimate::gui::RenderWidget::widget() const
 void glaxnimate::gui::RenderWidget::set_composition(model::Composition* comp)
 {
     d->composition = comp;
+    d->cache_valid = false;
 }
 
 void glaxnimate::gui::RenderWidget::render()
@@ -310,6 +400,8 @@ void gui::RenderWidget::set_renderer(std::unique_ptr<renderer::Renderer> rendere
     if ( renderer )
     {
         d->renderer = std::move(renderer);
+        d->renderer->set_image_detail(d->global_scale);
+        d->cache_valid = false;
         d->widget->update();
     }
 }
@@ -319,6 +411,9 @@ void gui::RenderWidget::set_quality(int quality)
 
     d->renderer->set_quality(quality);
     d->global_scale = quality < 5 ? 0.5 : 1;
+    // Large images don't need more detail than the downscaled canvas can show
+    d->renderer->set_image_detail(d->global_scale);
+    d->cache_valid = false;
     d->widget->update();
 }
 
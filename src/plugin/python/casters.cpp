@@ -146,6 +146,12 @@ pybind11::handle pybind11::detail::type_caster<QUuid>::cast(QUuid src, return_va
 
 bool pybind11::detail::type_caster<QImage>::load(handle src, bool)
 {
+    if ( isinstance<glaxnimate::plugin::python::ImageBuffer>(src) )
+    {
+        value = src.cast<const glaxnimate::plugin::python::ImageBuffer&>().image;
+        return true;
+    }
+
     if ( !isinstance(src, pybind11::module_::import("PIL.Image").attr("Image")) )
         return false;
 
@@ -187,42 +193,93 @@ bool pybind11::detail::type_caster<QImage>::load(handle src, bool)
 
 pybind11::handle pybind11::detail::type_caster<QImage>::cast(QImage src, return_value_policy, handle)
 {
-    auto mod = pybind11::module_::import("PIL.Image");
-    auto frombytes = mod.attr("frombytes");
+    if ( src.format() == QImage::Format_Invalid )
+        return pybind11::module_::import("PIL.Image").attr("Image")().release();
 
-    const char* mode;
+    py::object buffer = py::cast(glaxnimate::plugin::python::ImageBuffer(std::move(src)));
+    return glaxnimate::plugin::python::ImageBuffer::to_pil(buffer).release();
+}
 
-    switch ( src.format() )
+glaxnimate::plugin::python::ImageBuffer::ImageBuffer(QImage image)
+    : image(std::move(image))
+{
+    // Qt can convert between these in place as long as the data isn't shared
+    switch ( this->image.format() )
     {
         case QImage::Format_Invalid:
-            return mod.attr("Image")().release();
         case QImage::Format_RGB888:
-            mode = "RGB";
-            break;
         case QImage::Format_RGBA8888:
-            mode = "RGBA";
-            break;
         case QImage::Format_RGBA8888_Premultiplied:
-            mode = "RGBa";
-            break;
         case QImage::Format_RGBX8888:
-            mode = "RGBX";
+            break;
+        case QImage::Format_ARGB32_Premultiplied:
+            this->image.convertTo(QImage::Format_RGBA8888_Premultiplied);
+            break;
+        case QImage::Format_RGB32:
+            this->image.convertTo(QImage::Format_RGBX8888);
             break;
         default:
-            mode = "RGBA";
-            src = src.convertToFormat(QImage::Format_RGBA8888);
+            this->image.convertTo(QImage::Format_RGBA8888);
             break;
     }
+}
+
+const char* glaxnimate::plugin::python::ImageBuffer::mode() const
+{
+    switch ( image.format() )
+    {
+        case QImage::Format_Invalid:
+            return nullptr;
+        case QImage::Format_RGB888:
+            return "RGB";
+        case QImage::Format_RGBA8888_Premultiplied:
+            return "RGBa";
+        case QImage::Format_RGBX8888:
+            return "RGBX";
+        default:
+            return "RGBA";
+    }
+}
+
+int glaxnimate::plugin::python::ImageBuffer::channels() const
+{
+    return image.format() == QImage::Format_RGB888 ? 3 : 4;
+}
+
+pybind11::buffer_info glaxnimate::plugin::python::ImageBuffer::buffer_info() const
+{
+    int channels = this->channels();
+    // constBits() avoids detaching, Python gets a read-only view
+    return pybind11::buffer_info(
+        const_cast<uchar*>(image.constBits()),
+        1,
+        pybind11::format_descriptor<uint8_t>::format(),
+        3,
+        {py::ssize_t(image.height()), py::ssize_t(image.width()), py::ssize_t(channels)},
+        {py::ssize_t(image.bytesPerLine()), py::ssize_t(channels), py::ssize_t(1)},
+        true
+    );
+}
+
+pybind11::object glaxnimate::plugin::python::ImageBuffer::to_pil(const pybind11::object& buffer)
+{
+    const auto& self = buffer.cast<const ImageBuffer&>();
+    auto mod = pybind11::module_::import("PIL.Image");
+    if ( !self.mode() )
+        return mod.attr("Image")();
 
     py::tuple size(2);
-    size[0] = py::int_(src.width());
-    size[1] = py::int_(src.height());
+    size[0] = py::int_(self.image.width());
+    size[1] = py::int_(self.image.height());
 
-    auto image = frombytes(
-        mode,
+    // For RGBA / RGBa / RGBX PIL references the buffer instead of copying it
+    return mod.attr("frombuffer")(
+        self.mode(),
         size,
-        py::bytes((const char*)src.bits(), src.sizeInBytes())
+        py::memoryview(buffer),
+        "raw",
+        self.mode(),
+        self.image.bytesPerLine(),
+        1
     );
-
-    return image.release();
 }
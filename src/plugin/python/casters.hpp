@@ -350,6 +350,12 @@ template <typename V1, typename V2> struct type_caster<QPair<V1,V2>> {
 #endif
 
 
+/**
+ * \brief Converts to and from PIL images
+ *
+ * Images are converted to PIL without copying the pixels where possible,
+ * see glaxnimate::plugin::python::ImageBuffer.
+ */
 template <> struct type_caster<QImage>
 {
 public:
@@ -361,3 +367,33 @@ public:
 };
 
 } // namespace pybind11::detail
+
+namespace glaxnimate::plugin::python {
+
+/**
+ * \brief Exposes the pixels of a QImage through the Python buffer protocol
+ *
+ * The image is converted in place to a byte order PIL and NumPy understand,
+ * the buffer then shares its storage with the QImage.
+ */
+struct ImageBuffer
+{
+    explicit ImageBuffer(QImage image);
+
+    /**
+     * \brief PIL mode for the pixel data, nullptr for invalid images
+     */
+    const char* mode() const;
+    int channels() const;
+    pybind11::buffer_info buffer_info() const;
+
+    /**
+     * \brief Creates a PIL image sharing the pixels of \p buffer
+     * \param buffer Python object wrapping an ImageBuffer, kept alive by the PIL image
+     */
+    static pybind11::object to_pil(const pybind11::object& buffer);
+
+    QImage image;
+};
+
+} // namespace glaxnimate::plugin::python
@@ -155,25 +155,25 @@ static void define_trace(py::module& m)
     ;
     quantize.def(
         "color_frequencies", &utils::quantize::color_frequencies,
-        py::arg("image"), py::arg("alpha_threshold") = 128,
+        py::arg("image"), py::arg("alpha_threshold") = 128, py::arg("max_error") = 0,
         "Counts pixel values and returns a list of (rgba, count) pairs."
     );
     quantize.def(
         "k_modes",
         quantize_wrapper(&utils::quantize::k_modes),
-        py::arg("image"), py::arg("k"),
+        py::arg("image"), py::arg("k"), py::arg("max_error") = 0,
         "Returns the k colors that appear most frequently in image."
     );
     quantize.def(
         "k_means",
         quantize_wrapper(&utils::quantize::k_means),
-        py::arg("image"), py::arg("k"), py::arg("max_iterations") = 100, py::arg("match") = 1,
+        py::arg("image"), py::arg("k"), py::arg("max_iterations") = 100, py::arg("match") = 1, py::arg("max_error") = 0,
         "Returns the k colors that are at the center of clusters."
     );
     quantize.def(
         "octree",
         quantize_wrapper(&utils::quantize::octree),
-        py::arg("image"), py::arg("k"),
+        py::arg("image"), py::arg("k"), py::arg("max_error") = 0,
         "Returns the k best colors."
     );
     quantize.def(
@@ -307,6 +307,14 @@ void define_utils(py::module& m)
         .def_property("bottom_left", &QRectF::bottomLeft, &QRectF::setBottomLeft)
         .def_property("size", &QRectF::size, &QRectF::setSize)
     ;
+    py::class_<ImageBuffer>(utils, "ImageBuffer", py::buffer_protocol(),
+        "Rendered image exposed through the buffer protocol, use memoryview() or numpy.asarray() to access the pixels without copies")
+        .def_buffer(&ImageBuffer::buffer_info)
+        .def_property_readonly("width", [](const ImageBuffer& buf){ return buf.image.width(); })
+        .def_property_readonly("height", [](const ImageBuffer& buf){ return buf.image.height(); })
+        .def_property_readonly("mode", &ImageBuffer::mode, "PIL mode of the pixel data")
+        .def("to_pil", [](py::object self){ return ImageBuffer::to_pil(self); }, "Returns a PIL image sharing the pixel data")
+    ;
 
     define_bezier(utils);
     define_trace(utils);
@@ -6,6 +6,8 @@
 
 #include <pybind11/operators.h>
 
+#include <QtMath>
+
 #include "glaxnimate/model/visitor.hpp"
 #include "glaxnimate/model/animation/meta_animatable.hpp"
 
@@ -55,15 +57,41 @@ static QImage doc_to_image(model::Composition* comp)
     return io::raster::RasterMime::to_image({comp});
 }
 
+static std::vector<ImageBuffer> render_frames(
+    model::Composition* comp, model::FrameTime start, model::FrameTime end,
+    model::FrameTime step, QSize size)
+{
+    if ( step <= 0 )
+        throw py::value_error("step must be positive");
+
+    if ( !size.isValid() )
+        size = comp->size().toSize();
+
+    std::vector<ImageBuffer> frames;
+    if ( end > start )
+        frames.reserve(qCeil((end - start) / step));
+
+    // Single renderer for all the frames, each frame gets its own image as Python keeps a reference to it
+    auto renderer = renderer::RendererRegistry::instance().default_renderer(10);
+    for ( model::FrameTime time = start; time < end; time += step )
+    {
+        QImage image(size, QImage::Format_ARGB32);
+        comp->render_image(time, image, renderer.get());
+        frames.emplace_back(std::move(image));
+    }
+
+    return frames;
+}
+
 static QByteArray frame_to_svg(model::Composition* comp)
 {
     QByteArray data;
     QBuffer file(&data);
     file.open(QIODevice::WriteOnly);
 
-    io::svg::SvgRenderer rend(io::svg::NotAnimated, io::svg::CssFontType::FontFace);
+    io::svg::SvgRenderer rend(&file, io::svg::NotAnimated, io::svg::CssFontType::FontFace);
     rend.write_main(comp, comp->document()->current_time());
-    rend.write(&file, true);
+    rend.close();
 
     return data;
 }
@@ -80,12 +108,15 @@ void define_io(py::module& m)
     ;
 
     const char* to_image_docstring = "Renders the current frame to an image";
+    const char* render_frames_docstring = "Renders frames from start (inclusive) to end (exclusive) to a list of utils.ImageBuffer";
     py::class_<io::raster::RasterMime, io::mime::MimeSerializer>(io, "RasterMime")
         .def_static("render_frame", &io::raster::RasterMime::to_image, to_image_docstring)
         .def_static("render_frame", &doc_to_image, to_image_docstring)
         .def_static("render_frame", &io::raster::RasterMime::frame_to_image,
                     "Renders the given frame to image",
                     py::arg("node"), py::arg("frame"))
+        .def_static("render_frames", &render_frames, render_frames_docstring,
+                    py::arg("composition"), py::arg("start"), py::arg("end"), py::arg("step") = 1, py::arg("size") = QSize())
     ;
 
     using Fac = io::IoRegistry;
@@ -115,6 +146,8 @@ void define_io(py::module& m)
     register_from_meta<Reg, io::raster::RasterFormat, io::ImportExport>(io)
         .def_static("render_frame", &io::raster::RasterMime::to_image, to_image_docstring)
         .def_static("render_frame", &doc_to_image, to_image_docstring)
+        .def_static("render_frames", &render_frames, render_frames_docstring,
+                    py::arg("composition"), py::arg("start"), py::arg("end"), py::arg("step") = 1, py::arg("size") = QSize())
     ;
 
     register_from_meta<Reg, io::svg::SvgFormat, io::ImportExport>(io)
@@ -6,10 +6,13 @@
 
 #include "trace/quantize.hpp"
 
-#include <QHash>
+#include <QThread>
+#include <QThreadPool>
 
 #include <unordered_map>
+#include <algorithm>
 #include <memory>
+#include <cmath>
 
 using namespace glaxnimate;
 
@@ -91,36 +94,129 @@ struct Color
     }
 };
 
+/**
+ * \brief Number of chunks to split \p work items into for parallel_chunks()
+ */
+int chunk_count(qint64 work)
+{
+    // Below this many items per chunk starting a thread costs more than it saves
+    constexpr qint64 min_chunk = 1 << 16;
+    return qBound<qint64>(1, work / min_chunk, QThread::idealThreadCount());
+}
+
+/**
+ * \brief Calls func(begin, end, chunk) on \p chunks contiguous ranges covering [0, size) in parallel
+ *
+ * Each chunk should write to its own data, callers then merge the results
+ * in chunk order so the output doesn't depend on scheduling.
+ */
+template<class Func>
+void parallel_chunks(qint64 size, int chunks, const Func& func)
+{
+    if ( chunks <= 1 )
+    {
+        func(qint64(0), size, 0);
+        return;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(chunks);
+    for ( int i = 0; i < chunks; i++ )
+    {
+        qint64 begin = size * i / chunks;
+        qint64 end = size * (i + 1) / chunks;
+        pool.start([&func, begin, end, i]{ func(begin, end, i); });
+    }
+    pool.waitForDone();
+}
+
+/**
+ * \brief Number of pixels to sample so each color frequency is within \p max_error
+ *
+ * From Hoeffding's inequality, n >= ln(2 / p) / (2 * max_error^2) samples
+ * give an error of at most max_error with probability 1 - p.
+ */
+qint64 sample_count(qint64 n_pixels, qreal max_error)
+{
+    if ( max_error <= 0 )
+        return n_pixels;
+
+    constexpr qreal failure_probability = 0.01;
+    qreal samples = std::ceil(std::log(2 / failure_probability) / (2 * max_error * max_error));
+    if ( samples >= n_pixels )
+        return n_pixels;
+    return samples;
+}
+
+/**
+ * \brief Index of the pixel to use as sample \p i
+ *
+ * Uses splitmix64 rather than a random engine so the same image always gives the same palette
+ */
+inline qint64 sample_index(qint64 i, qint64 n_pixels)
+{
+    quint64 z = quint64(i + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return z % quint64(n_pixels);
+}
+
 using HistogramMap = std::unordered_map<ColorFrequency::first_type, ColorFrequency::second_type>;
 
-HistogramMap color_frequency_map(QImage image, int alpha_threshold)
+HistogramMap color_frequency_map(QImage image, int alpha_threshold, qreal max_error = 0)
 {
     if ( image.format() != QImage::Format_RGBA8888 )
         image = image.convertToFormat(QImage::Format_RGBA8888);
 
-    HistogramMap count;
     const uchar* data = image.constBits();
 
-    int n_pixels = image.width() * image.height();
-    for ( int i = 0; i < n_pixels; i++ )
-        if ( data[i*4+3] >= alpha_threshold )
-            ++count[qRgb(data[i*4], data[i*4+1], data[i*4+2])];
+    qint64 n_pixels = qint64(image.width()) * image.height();
+    qint64 n_samples = sample_count(n_pixels, max_error);
+    bool sampled = n_samples < n_pixels;
+
+    int chunks = chunk_count(n_samples);
+    std::vector<HistogramMap> partial(chunks);
+    parallel_chunks(n_samples, chunks, [&](qint64 begin, qint64 end, int chunk){
+        HistogramMap& count = partial[chunk];
+        for ( qint64 i = begin; i < end; i++ )
+        {
+            const uchar* pixel = data + (sampled ? sample_index(i, n_pixels) : i) * 4;
+            if ( pixel[3] >= alpha_threshold )
+                ++count[qRgb(pixel[0], pixel[1], pixel[2])];
+        }
+    });
+
+    HistogramMap count = std::move(partial[0]);
+    for ( int i = 1; i < chunks; i++ )
+    {
+        for ( const auto& entry : partial[i] )
+            count[entry.first] += entry.second;
+    }
+
+    if ( sampled )
+    {
+        // Scale back so the counts are comparable to the full image
+        qreal scale = qreal(n_pixels) / n_samples;
+        for ( auto& entry : count )
+            entry.second = qMax(1, qRound(entry.second * scale));
+    }
 
     return count;
 }
 
 } // utils::quantize::detail
 
-std::vector<utils::quantize::ColorFrequency> utils::quantize::color_frequencies(const QImage& image, int alpha_threshold)
+std::vector<utils::quantize::ColorFrequency> utils::quantize::color_frequencies(const QImage& image, int alpha_threshold, qreal max_error)
 {
-    auto count = detail::color_frequency_map(image, alpha_threshold);
+    auto count = detail::color_frequency_map(image, alpha_threshold, max_error);
     return std::vector<ColorFrequency>(count.begin(), count.end());
 }
 
 
-std::vector<QRgb> utils::quantize::k_modes(const QImage& image, int k)
+std::vector<QRgb> utils::quantize::k_modes(const QImage& image, int k, qreal max_error)
 {
-    auto freq = color_frequencies(image);
+    auto freq = color_frequencies(image, 128, max_error);
     return detail::color_frequencies_to_palette(freq, k);
 }
 
@@ -128,33 +224,97 @@ std::vector<QRgb> utils::quantize::k_modes(const QImage& image, int k)
 
 namespace glaxnimate::utils::quantize::detail::k_means {
 
-struct Point
+/**
+ * \brief Colors to cluster, with each channel in its own array
+ *
+ * This way the distance loops below have no branches nor strided loads
+ * and the compiler can turn them into SIMD code.
+ */
+struct Points
 {
-    Color color;
-
-    quint32 weight;
+    std::vector<qint32> r;
+    std::vector<qint32> g;
+    std::vector<qint32> b;
+    std::vector<quint32> weight;
+    std::vector<int> cluster;
+    // Distance from the closest centroid
+    std::vector<Distance> min_distance;
+
+    explicit Points(const std::vector<ColorFrequency>& freq)
+    {
+        int count = freq.size();
+        r.resize(count);
+        g.resize(count);
+        b.resize(count);
+        weight.resize(count);
+        cluster.resize(count, -1);
+        min_distance.resize(count, std::numeric_limits<Distance>::max());
+
+        for ( int i = 0; i < count; i++ )
+        {
+            r[i] = qRed(freq[i].first);
+            g[i] = qGreen(freq[i].first);
+            b[i] = qBlue(freq[i].first);
+            weight[i] = freq[i].second;
+        }
+    }
 
-    Distance min_distance = std::numeric_limits<Distance>::max();
+    int size() const
+    {
+        return r.size();
+    }
 
-    int cluster = -1;
+    Color color(int i) const
+    {
+        return {r[i], g[i], b[i]};
+    }
 
+    /**
+     * \brief Assigns points in [begin, end) to \p index if \p centroid is closer than their current cluster
+     */
+    void assign(const Color& centroid, int index, int begin, int end)
+    {
+        const qint32* pr = r.data();
+        const qint32* pg = g.data();
+        const qint32* pb = b.data();
+        Distance* pmin = min_distance.data();
+        int* pcluster = cluster.data();
 
-    constexpr Point(const ColorFrequency& p) noexcept
-        : color(p.first), weight(p.second)
-    {}
+        for ( int i = begin; i < end; i++ )
+        {
+            quint32 dr = pr[i] - centroid.r;
+            quint32 dg = pg[i] - centroid.g;
+            quint32 db = pb[i] - centroid.b;
+            Distance dist = dr * dr + dg * dg + db * db;
+            bool closer = dist < pmin[i];
+            pmin[i] = closer ? dist : pmin[i];
+            pcluster[i] = closer ? index : pcluster[i];
+        }
+    }
 };
 
 
 struct Cluster
 {
     Color centroid;
-    quint32 total_weight = 0;
-    Color sum = {};
+    // 64 bit sums as pixel counts times channel values overflow 32 bits for large images
+    quint64 total_weight = 0;
+    qint64 sum_r = 0;
+    qint64 sum_g = 0;
+    qint64 sum_b = 0;
 
     constexpr Cluster(const Color& color) noexcept
         : centroid(color)
     {}
 
+    void add(const Cluster& oth)
+    {
+        total_weight += oth.total_weight;
+        sum_r += oth.sum_r;
+        sum_g += oth.sum_g;
+        sum_b += oth.sum_b;
+    }
+
     bool update()
     {
         if ( total_weight == 0 )
@@ -162,114 +322,120 @@ struct Cluster
 
         auto old = centroid;
 
-        centroid.r = qRound(double(sum.r) / total_weight);
-        centroid.g = qRound(double(sum.g) / total_weight);
-        centroid.b = qRound(double(sum.b) / total_weight);
+        centroid.r = qRound(double(sum_r) / total_weight);
+        centroid.g = qRound(double(sum_g) / total_weight);
+        centroid.b = qRound(double(sum_b) / total_weight);
 
         total_weight = 0;
-        sum = {};
+        sum_r = sum_g = sum_b = 0;
         return old.rgb() != centroid.rgb();
     }
 };
 
+/**
+ * \brief Index of the point farthest away from the centroids, after adding \p centroid to them
+ */
+int add_centroid(Points& points, const Color& centroid, int index)
+{
+    int size = points.size();
+    int chunks = chunk_count(size);
+    std::vector<int> farthest(chunks, -1);
+
+    parallel_chunks(size, chunks, [&](qint64 begin, qint64 end, int chunk){
+        points.assign(centroid, index, begin, end);
+
+        Distance max_dist = 0;
+        for ( qint64 i = begin; i < end; i++ )
+        {
+            if ( points.min_distance[i] > max_dist )
+            {
+                max_dist = points.min_distance[i];
+                farthest[chunk] = i;
+            }
+        }
+    });
+
+    int best = -1;
+    for ( int candidate : farthest )
+    {
+        if ( candidate != -1 && (best == -1 || points.min_distance[candidate] > points.min_distance[best]) )
+            best = candidate;
+    }
+    return best;
+}
+
 } // utils::quantize::detail
 
-std::vector<QRgb> utils::quantize::k_means(const QImage& image, int k, int iterations, KMeansMatch match)
+std::vector<QRgb> utils::quantize::k_means(const QImage& image, int k, int iterations, KMeansMatch match, qreal max_error)
 {
-    auto freq = color_frequencies(image);
+    using namespace detail::k_means;
+
+    auto freq = color_frequencies(image, 128, max_error);
 
     // Avoid processing if we don't need to
     if ( int(freq.size()) <= k )
         return detail::color_frequencies_to_palette(freq, k);
 
-    // Initialize points
-    std::vector<detail::k_means::Point> points(freq.begin(), freq.end());
+    Points points(freq);
     freq.clear();
 
-    // Keep track of the clusters we already used
-    std::vector<detail::k_means::Point> cluster_init;
-    cluster_init.reserve(k);
+    int size = points.size();
+    int chunks = detail::chunk_count(size);
 
-    std::vector<detail::k_means::Cluster> clusters;
+    std::vector<Cluster> clusters;
     clusters.reserve(k);
 
     // Get the most common color as initial cluster centroid
-    quint32 max_freq = 0;
-    std::vector<detail::k_means::Point>::iterator best_iter;
-    for ( auto it = points.begin(); it != points.end(); ++it )
+    int best = 0;
+    for ( int i = 1; i < size; i++ )
     {
-        if ( it->weight > max_freq )
-        {
-            max_freq = it->weight;
-            best_iter = it;
-        }
+        if ( points.weight[i] > points.weight[best] )
+            best = i;
     }
-    cluster_init.push_back(*best_iter);
-    clusters.emplace_back(best_iter->color);
-    // remove centroid from points
-    std::swap(*best_iter, points.back());
-    points.pop_back();
 
     // k-means++-like processing from now on (but deterministic)
-    // ie: always select the centroid the farthest away from the other centroids
-    while ( int(clusters.size()) < k )
+    // ie: always select the point the farthest away from the centroids.
+    // min_distance keeps the distance from the closest centroid so far so
+    // each new centroid only needs to be compared against the points once
+    while ( int(clusters.size()) < k && best != -1 )
     {
-        detail::Distance max_dist = 0;
-
-        for ( auto it = points.begin(); it != points.end(); ++it )
-        {
-            detail::Distance p_max = 0;
-            for ( const auto& cluster : clusters )
-            {
-                auto dist = it->color.distance(cluster.centroid);
-                if ( dist < p_max )
-                    p_max = dist;
-            }
-
-            if ( p_max > max_dist )
-            {
-                max_dist = p_max;
-                best_iter = it;
-            }
-        }
-
-        cluster_init.push_back(*best_iter);
-        clusters.emplace_back(best_iter->color);
-        // remove centroid from points
-        std::swap(*best_iter, points.back());
-        points.pop_back();
+        clusters.emplace_back(points.color(best));
+        best = add_centroid(points, clusters.back().centroid, clusters.size() - 1);
     }
-
-    // add back the removed centroids
-    points.insert(points.end(), cluster_init.begin(), cluster_init.end());
-    cluster_init.clear();
-
+    k = clusters.size();
 
     // K-medoids
+    std::vector<std::vector<Cluster>> partial(chunks, clusters);
     bool loop = true;
     for ( int epoch = 0; epoch < iterations && loop; epoch++ )
     {
-        // Assign points to clusters
-        for ( int i = 0; i < k; i++ )
-        {
-            const auto& cluster = clusters[i];
-            for ( auto& p : points )
+        // Assign points to clusters and sum them up, each chunk has its own sums
+        detail::parallel_chunks(size, chunks, [&](qint64 begin, qint64 end, int chunk){
+            std::fill(points.min_distance.begin() + begin, points.min_distance.begin() + end, std::numeric_limits<detail::Distance>::max());
+            for ( int i = 0; i < k; i++ )
+                points.assign(clusters[i].centroid, i, begin, end);
+
+            auto& sums = partial[chunk];
+            for ( qint64 i = begin; i < end; i++ )
             {
-                auto dist = p.color.distance(cluster.centroid);
-                if (dist < p.min_distance )
-                {
-                    p.min_distance = dist;
-                    p.cluster = i;
-                }
+                auto& cluster = sums[points.cluster[i]];
+                quint64 weight = points.weight[i];
+                cluster.total_weight += weight;
+                cluster.sum_r += points.r[i] * weight;
+                cluster.sum_g += points.g[i] * weight;
+                cluster.sum_b += points.b[i] * weight;
             }
-        }
+        });
 
-        // Move centroids
-        for ( auto& p : points )
+        // Move centroids, merging chunks in order so the result is always the same
+        for ( auto& sums : partial )
         {
-            clusters[p.cluster].total_weight += p.weight;
-            clusters[p.cluster].sum.weighted_add(p.color, p.weight);
-            p.min_distance = std::numeric_limits<detail::Distance>::max();
+            for ( int i = 0; i < k; i++ )
+            {
+                clusters[i].add(sums[i]);
+                sums[i].total_weight = 0;
+                sums[i].sum_r = sums[i].sum_g = sums[i].sum_b = 0;
+            }
         }
 
         // Quit if nothing has changed
@@ -278,33 +444,28 @@ std::vector<QRgb> utils::quantize::k_means(const QImage& image, int k, int itera
             loop = cluster.update() || loop;
     }
 
-    // Post-process to find the closest color, reusing total_weight/sum for this
+    // Post-process to find the closest color
     if ( match )
     {
-        for ( auto& cluster : clusters )
-        {
-            cluster.total_weight = 0;
-            cluster.sum = {};
-        }
+        std::vector<quint32> best_score(k, 0);
+        std::vector<detail::Color> best_color(k);
 
-
-        for ( auto& p : points )
+        for ( int i = 0; i < size; i++ )
         {
-            auto& cluster = clusters[p.cluster];
-            auto score = match == MostFrequent ? p.weight :
-                std::numeric_limits<quint32>::max() - p.color.distance(cluster.centroid);
+            int cluster = points.cluster[i];
+            auto color = points.color(i);
+            auto score = match == MostFrequent ? points.weight[i] :
+                std::numeric_limits<quint32>::max() - color.distance(clusters[cluster].centroid);
 
-            if ( score > cluster.total_weight )
+            if ( score > best_score[cluster] )
             {
-                cluster.total_weight = score;
-                cluster.sum = p.color;
+                best_score[cluster] = score;
+                best_color[cluster] = color;
             }
         }
 
-        for ( auto& cluster : clusters )
-        {
-            cluster.centroid = cluster.sum;
-        }
+        for ( int i = 0; i < k; i++ )
+            clusters[i].centroid = best_color[i];
     }
 
     std::vector<QRgb> result;
@@ -627,11 +788,11 @@ std::unique_ptr<Node> add_pixels(Node* ref, ColorFrequency* data, int data_size)
 } // namespace glaxnimate::utils::quantize::detail::octree
 
 
-std::vector<QRgb> utils::quantize::octree(const QImage& image, int k)
+std::vector<QRgb> utils::quantize::octree(const QImage& image, int k, qreal max_error)
 {
     using namespace glaxnimate::utils::quantize::detail::octree;
 
-    auto freq = color_frequencies(image);
+    auto freq = color_frequencies(image, 128, max_error);
 
     // Avoid processing if we don't need to
     if ( int(freq.size()) <= k || k <= 1)
@@ -649,44 +810,89 @@ std::vector<QRgb> utils::quantize::octree(const QImage& image, int k)
     return colors;
 }
 
-static inline qint32 pixel_distance(QRgb p1, QRgb p2)
-{
-    int r1 = qRed(p1);
-    int g1 = qGreen(p1);
-    int b1 = qBlue(p1);
-    int a1 = qAlpha(p1);
-
-    int r2 = qRed(p2);
-    int g2 = qGreen(p2);
-    int b2 = qBlue(p2);
-    int a2 = qAlpha(p2);
-
-    qint32 dr = r1 - r2;
-    qint32 dg = g1 - g2;
-    qint32 db = b1 - b2;
-    qint32 da = a1 - a2;
-
-    return dr * dr + dg * dg + db * db + da * da;
-}
+namespace glaxnimate::utils::quantize::detail {
 
-static inline qint32 closest_match(QRgb pixel, const QVector<QRgb> &clut)
+/**
+ * \brief Finds the closest palette entry to each pixel
+ *
+ * The palette is stored one channel per array so computing the distance
+ * from all the entries vectorizes, and recent results are kept in a small
+ * direct-mapped table as images tend to repeat the same few pixel values.
+ *
+ * Not thread-safe, each thread should use its own copy.
+ */
+class PaletteMatcher
 {
-    if ( qAlpha(pixel) < 128 )
-        return clut.size() - 1;
+public:
+    explicit PaletteMatcher(const QVector<QRgb>& clut)
+        : r(clut.size()), g(clut.size()), b(clut.size()), a(clut.size()),
+          distance(clut.size()), cache(cache_size)
+    {
+        for ( int i = 0; i < clut.size(); i++ )
+        {
+            r[i] = qRed(clut[i]);
+            g[i] = qGreen(clut[i]);
+            b[i] = qBlue(clut[i]);
+            a[i] = qAlpha(clut[i]);
+        }
+    }
+
+    /**
+     * \brief Index of the palette entry closest to \p pixel
+     *
+     * Pixels with less than half opacity map to the last entry
+     */
+    int closest(QRgb pixel)
+    {
+        if ( qAlpha(pixel) < 128 )
+            return r.size() - 1;
+
+        CacheEntry& entry = cache[(pixel * 0x9e3779b1u) >> (32 - cache_bits)];
+        if ( entry.index == -1 || entry.pixel != pixel )
+            entry = {pixel, search(pixel)};
+        return entry.index;
+    }
+
+private:
+    struct CacheEntry
+    {
+        QRgb pixel = 0;
+        int index = -1;
+    };
+
+    static constexpr int cache_bits = 12;
+    static constexpr int cache_size = 1 << cache_bits;
 
-    int idx = 0;
-    qint32 current_distance = INT_MAX;
-    for ( int i = 0; i < clut.size(); ++i)
+    int search(QRgb pixel)
     {
-        int dist = pixel_distance(pixel, clut[i]);
-        if (dist < current_distance)
+        qint32 pr = qRed(pixel);
+        qint32 pg = qGreen(pixel);
+        qint32 pb = qBlue(pixel);
+        qint32 pa = qAlpha(pixel);
+
+        int count = r.size();
+        for ( int i = 0; i < count; i++ )
         {
-            current_distance = dist;
-            idx = i;
+            qint32 dr = r[i] - pr;
+            qint32 dg = g[i] - pg;
+            qint32 db = b[i] - pb;
+            qint32 da = a[i] - pa;
+            distance[i] = dr * dr + dg * dg + db * db + da * da;
         }
+
+        // min_element returns the first minimum, so ties go to the earlier color
+        return std::min_element(distance.begin(), distance.end()) - distance.begin();
     }
-    return idx;
-}
+
+    std::vector<qint32> r;
+    std::vector<qint32> g;
+    std::vector<qint32> b;
+    std::vector<qint32> a;
+    std::vector<qint32> distance;
+    std::vector<CacheEntry> cache;
+};
+
+} // namespace glaxnimate::utils::quantize::detail
 
 static QImage convert_with_palette(const QImage &src, const QVector<QRgb> &clut)
 {
@@ -695,24 +901,24 @@ static QImage convert_with_palette(const QImage &src, const QVector<QRgb> &clut)
     int h = src.height();
     int w = src.width();
 
-    QHash<QRgb, int> cache;
-
-    for (int y=0; y<h; ++y)
-    {
-        const QRgb *src_pixels = reinterpret_cast<const QRgb *>(src.scanLine(y));
-        uchar *dest_pixels = (uchar *) dest.scanLine(y);
-        for (int x = 0; x < w; ++x)
+    // Get the pointers here as scanLine() might detach when called from the threads
+    uchar* dest_bits = dest.bits();
+    qsizetype dest_stride = dest.bytesPerLine();
+    const uchar* src_bits = src.constBits();
+    qsizetype src_stride = src.bytesPerLine();
+
+    utils::quantize::detail::PaletteMatcher matcher(clut);
+    int chunks = utils::quantize::detail::chunk_count(qint64(w) * h);
+    utils::quantize::detail::parallel_chunks(h, chunks, [&](qint64 begin, qint64 end, int){
+        utils::quantize::detail::PaletteMatcher chunk_matcher = matcher;
+        for ( qint64 y = begin; y < end; ++y )
         {
-            int src_pixel = src_pixels[x];
-            qint32 value = cache.value(src_pixel, -1);
-            if (value == -1)
-            {
-                value = closest_match(src_pixel, clut);
-                cache.insert(src_pixel, value);
-            }
-            dest_pixels[x] = (uchar) value;
+            const QRgb *src_pixels = reinterpret_cast<const QRgb *>(src_bits + y * src_stride);
+            uchar *dest_pixels = dest_bits + y * dest_stride;
+            for ( int x = 0; x < w; ++x )
+                dest_pixels[x] = (uchar) chunk_matcher.closest(src_pixels[x]);
         }
-    }
+    });
 
     return dest;
 }
@@ -725,24 +931,10 @@ QImage utils::quantize::quantize(const QImage& source, const std::vector<QRgb>&
     return convert_with_palette(source.convertToFormat(QImage::Format_ARGB32), vcolors);
 }
 
-namespace glaxnimate::utils::quantize::detail::auto_colors {
-
-void decrease(QRgb color, HistogramMap& map)
-{
-    auto it = map.find(color | 0xff000000u);
-    if ( it != map.end() )
-        it->second -= 1;
-}
-
-} // namespace glaxnimate::utils::quantize::detail::auto_colors
-
-
 std::vector<QRgb> utils::quantize::edge_exclusion_modes(const QImage& image_in, int max_colors, qreal min_frequency)
 {
     int alpha_threshold = 128;
-    QImage image = image_in;
-    if ( image.format() != QImage::Format_RGBA8888 )
-        image = image.convertToFormat(QImage::Format_RGBA8888);
+    QImage image = image_in.convertToFormat(QImage::Format_ARGB32);
 
     detail::HistogramMap colors = detail::color_frequency_map(image, alpha_threshold);
 
@@ -755,6 +947,10 @@ std::vector<QRgb> utils::quantize::edge_exclusion_modes(const QImage& image_in,
     std::vector<QRgb> output;
     int min_amount = min_frequency * image.width() * image.height();
 
+    int inner_height = image.height() - 2;
+    int chunks = detail::chunk_count(qint64(image.width()) * inner_height);
+    std::vector<detail::HistogramMap> excluded(chunks);
+
     while ( int(output.size()) < max_colors && !colors.empty() )
     {
         auto best = colors.begin();
@@ -771,19 +967,40 @@ std::vector<QRgb> utils::quantize::edge_exclusion_modes(const QImage& image_in,
         output.push_back(color);
         colors.erase(best);
 
-        for ( int y = 1; y < image.height() - 1; y++ )
-        {
-            for ( int x = 1; x < image.width() - 1; x++ )
+        if ( inner_height <= 0 )
+            continue;
+
+        // colors is only read while scanning, each chunk counts its own exclusions
+        detail::parallel_chunks(inner_height, chunks, [&](qint64 begin, qint64 end, int chunk){
+            auto& count = excluded[chunk];
+            auto decrease = [&colors, &count](QRgb pixel) {
+                if ( colors.count(pixel | 0xff000000u) )
+                    ++count[pixel | 0xff000000u];
+            };
+
+            for ( qint64 y = begin + 1; y < end + 1; y++ )
             {
-                auto pix = image.pixel(x, y);
-                if ( pix == color )
+                auto above = reinterpret_cast<const QRgb*>(image.constScanLine(y - 1));
+                auto line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+                auto below = reinterpret_cast<const QRgb*>(image.constScanLine(y + 1));
+                for ( int x = 1; x < image.width() - 1; x++ )
                 {
-                    detail::auto_colors::decrease(image.pixel(x, y-1), colors);
-                    detail::auto_colors::decrease(image.pixel(x, y+1), colors);
-                    detail::auto_colors::decrease(image.pixel(x-1, y), colors);
-                    detail::auto_colors::decrease(image.pixel(x+1, y), colors);
+                    if ( line[x] == color )
+                    {
+                        decrease(above[x]);
+                        decrease(below[x]);
+                        decrease(line[x-1]);
+                        decrease(line[x+1]);
+                    }
                 }
             }
+        });
+
+        for ( auto& count : excluded )
+        {
+            for ( const auto& entry : count )
+                colors[entry.first] -= entry.second;
+            count.clear();
         }
     }
 
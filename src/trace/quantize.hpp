@@ -18,7 +18,7 @@ using ColorFrequency = std::pair<QRgb, int>;
 /**
  * \brief Returns the \p k colors that appear most frequently in \p image.
  */
-std::vector<QRgb> k_modes(const QImage& image, int k);
+std::vector<QRgb> k_modes(const QImage& image, int k, qreal max_error = 0);
 
 
 enum KMeansMatch
@@ -31,13 +31,13 @@ enum KMeansMatch
 /**
  * \brief k-means Algorithm
  */
-std::vector<QRgb> k_means(const QImage& image, int k, int iterations, KMeansMatch match);
+std::vector<QRgb> k_means(const QImage& image, int k, int iterations, KMeansMatch match, qreal max_error = 0);
 
 
 /**
  * \brief Octree Algorithm
  */
-std::vector<QRgb> octree(const QImage& image, int k);
+std::vector<QRgb> octree(const QImage& image, int k, qreal max_error = 0);
 
 
 /**
@@ -56,8 +56,12 @@ std::vector<QRgb> edge_exclusion_modes(const QImage& image, int max_colors, qrea
  * \brief Counts pixel values and returns a list of [rgba, count] pairs
  * \param image             The image to analyze
  * \param alpha_threshold   Minimum alpha value [0-255] for a color to be included
+ * \param max_error         If greater than 0, counts are estimated from a sample of the pixels
+ *                          so that with 99% confidence each frequency is off by at most
+ *                          \p max_error times the number of pixels.
+ *                          k_modes(), k_means() and octree() forward their \p max_error here.
  */
-std::vector<ColorFrequency> color_frequencies(const QImage& image, int alpha_threshold = 128);
+std::vector<ColorFrequency> color_frequencies(const QImage& image, int alpha_threshold = 128, qreal max_error = 0);
 
 /**
  * \brief Returns a quantized image with the given colors
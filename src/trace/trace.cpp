@@ -6,6 +6,8 @@
 
 #include "trace/trace.hpp"
 
+#include <type_traits>
+
 #include "potracelib.h"
 
 #include "glaxnimate/utils/color.hpp"
@@ -163,33 +165,42 @@ utils::trace::Tracer::Tracer(const QImage& image, const TraceOptions& options)
 
 utils::trace::Tracer::~Tracer() = default;
 
+utils::trace::Tracer::Tracer(const TraceOptions& options)
+    : Tracer(QImage(), options)
+{
+}
+
 bool utils::trace::Tracer::trace(math::bezier::MultiBezier& mbez)
 {
     QImage::Format target_format = d->callback == &Private::get_bit_index ? QImage::Format_Indexed8 : QImage::Format_RGBA8888;
     if ( d->image.format() != target_format )
         d->image = d->image.convertToFormat(target_format);
 
-    int line_len = d->image.width() / sizeof(potrace_word);
-    if ( d->image.width() % sizeof(potrace_word) )
-        line_len += 1;
-
-    static constexpr int N = sizeof(potrace_word) * CHAR_BIT;
     const int x_off = d->callback == &Private::get_bit_index ? 1 : 4;
-    std::vector<potrace_word> data(line_len * d->image.height(), 0);
+    BitMask mask(d->image.width(), d->image.height());
     for ( int y = 0, h = d->image.height(), w = d->image.width(); y < h; y++ )
     {
         auto line = d->image.constScanLine(y);
         for ( int x = 0; x < w; x++ )
         {
-            (data.data() + y*line_len)[x/N] |= (1ul << (N-1-x%N)) * (d.get()->*d->callback)(line+x*x_off);
+            if ( (d.get()->*d->callback)(line+x*x_off) )
+                mask.set(x, y);
         }
     }
 
+    return trace(mask, mbez);
+}
+
+bool utils::trace::Tracer::trace(const BitMask& mask, math::bezier::MultiBezier& mbez)
+{
+    static_assert(std::is_same_v<potrace_word, BitMask::Word>);
+
     potrace_bitmap_s bitmap{
-        d->image.width(),
-        d->image.height(),
-        line_len,
-        data.data()
+        mask.width(),
+        mask.height(),
+        mask.words_per_line(),
+        // potrace doesn't modify the bitmap
+        const_cast<potrace_word*>(mask.data())
     };
 
     potrace_state_t *result = potrace_trace(&d->params, &bitmap);
@@ -346,3 +357,62 @@ std::map<QRgb, std::vector<QRectF> > utils::trace::trace_pixels(QImage image)
 
     return traced;
 }
+
+std::vector<utils::trace::BitMask> utils::trace::split_indexed(const QImage& source, int count)
+{
+    QImage image = source;
+    if ( image.format() != QImage::Format_Indexed8 )
+        image = image.convertToFormat(QImage::Format_Indexed8);
+
+    int w = image.width();
+    int h = image.height();
+    std::vector<BitMask> masks(count, BitMask(w, h));
+
+    for ( int y = 0; y < h; y++ )
+    {
+        auto line = image.constScanLine(y);
+        for ( int x = 0; x < w; x++ )
+        {
+            if ( line[x] < count )
+                masks[line[x]].set(x, y);
+        }
+    }
+
+    return masks;
+}
+
+std::vector<utils::trace::BitMask> utils::trace::split_colors(const QImage& source, const std::vector<QRgb>& colors, qint32 tolerance)
+{
+    QImage image = source;
+    if ( image.format() != QImage::Format_RGBA8888 )
+        image = image.convertToFormat(QImage::Format_RGBA8888);
+
+    int w = image.width();
+    int h = image.height();
+    int count = colors.size();
+    std::vector<BitMask> masks(count, BitMask(w, h));
+
+    for ( int y = 0; y < h; y++ )
+    {
+        auto line = image.constScanLine(y);
+        for ( int x = 0; x < w; x++ )
+        {
+            const uchar* pixel = line + x * 4;
+            if ( tolerance > 0 )
+            {
+                for ( int i = 0; i < count; i++ )
+                    if ( utils::color::rgba_distance_squared(colors[i], pixel[0], pixel[1], pixel[2], pixel[3]) <= tolerance )
+                        masks[i].set(x, y);
+            }
+            else
+            {
+                QRgb color = rgba888(pixel);
+                for ( int i = 0; i < count; i++ )
+                    if ( colors[i] == color )
+                        masks[i].set(x, y);
+            }
+        }
+    }
+
+    return masks;
+}
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <climits>
 #include <QImage>
 #include <QObject>
 
@@ -32,14 +34,60 @@ private:
     std::unique_ptr<Private> d;
 };
 
+/**
+ * \brief 1-bit mask of the pixels to trace, in the layout used by potrace
+ */
+class BitMask
+{
+public:
+    using Word = unsigned long;
+    static constexpr int word_bits = sizeof(Word) * CHAR_BIT;
+
+    BitMask(int width, int height)
+        : width_(width),
+          height_(height),
+          words_per_line_((width + word_bits - 1) / word_bits),
+          words_(std::size_t(words_per_line_) * height, 0)
+    {}
+
+    void set(int x, int y)
+    {
+        words_[std::size_t(y) * words_per_line_ + x / word_bits] |= Word(1) << (word_bits - 1 - x % word_bits);
+    }
+
+    bool get(int x, int y) const
+    {
+        return words_[std::size_t(y) * words_per_line_ + x / word_bits] & (Word(1) << (word_bits - 1 - x % word_bits));
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int words_per_line() const { return words_per_line_; }
+    const Word* data() const { return words_.data(); }
+
+private:
+    int width_;
+    int height_;
+    int words_per_line_;
+    std::vector<Word> words_;
+};
+
 class Tracer : public QObject
 {
     Q_OBJECT
 public:
     Tracer(const QImage& image, const TraceOptions& options);
+    /**
+     * \brief Tracer for pre-computed masks only
+     */
+    explicit Tracer(const TraceOptions& options);
     ~Tracer();
 
     bool trace(math::bezier::MultiBezier& output);
+    /**
+     * \brief Traces \p mask rather than the image passed in the constructor
+     */
+    bool trace(const BitMask& mask, math::bezier::MultiBezier& output);
 
     static QString potrace_version();
 
@@ -59,4 +107,16 @@ private:
 
 std::map<QRgb, std::vector<QRectF>> trace_pixels(QImage image);
 
+/**
+ * \brief Splits an indexed image into one mask per color index, in a single pass over the pixels
+ */
+std::vector<BitMask> split_indexed(const QImage& image, int count);
+
+/**
+ * \brief Splits an image into one mask per color, in a single pass over the pixels
+ * \param tolerance Maximum squared distance for a pixel to match a color,
+ * when greater than 0 a pixel can be set in multiple masks
+ */
+std::vector<BitMask> split_colors(const QImage& image, const std::vector<QRgb>& colors, qint32 tolerance);
+
 } // namespace glaxnimate::utils::trace
@@ -5,6 +5,11 @@
  */
 
 #include "trace/trace_wrapper.hpp"
+
+#include <atomic>
+
+#include <QThreadPool>
+
 #include "trace/quantize.hpp"
 #include "glaxnimate/model/document.hpp"
 #include "glaxnimate/model/shapes/style/stroke.hpp"
@@ -32,6 +37,51 @@ public:
             source_image = image;
     }
 
+    /**
+     * \brief Traces each mask as a separate task on a thread pool
+     *
+     * Progress from all the tasks is combined and reported from the calling thread
+     */
+    void trace_masks(TraceWrapper* parent, const std::vector<BitMask>& masks, const std::vector<QRgb>& colors, std::vector<TraceResult>& result)
+    {
+        std::size_t first = result.size();
+        result.resize(first + masks.size());
+        std::vector<std::atomic<int>> task_progress(masks.size());
+        for ( auto& value : task_progress )
+            value = 0;
+
+        QThreadPool pool;
+        for ( std::size_t i = 0; i < masks.size(); i++ )
+        {
+            result[first + i].color = colors[i];
+            pool.start([this, &masks, &result, &task_progress, i, first]{
+                utils::trace::Tracer tracer(options);
+                tracer.set_progress_range(0, 100);
+                QObject::connect(&tracer, &utils::trace::Tracer::progress, [&task_progress, i](double value){
+                    task_progress[i] = int(value);
+                });
+                tracer.trace(masks[i], result[first + i].bezier);
+                task_progress[i] = 100;
+            });
+        }
+
+        int reported = -1;
+        auto report = [&]{
+            int total = 0;
+            for ( const auto& value : task_progress )
+                total += value;
+            if ( total != reported )
+            {
+                reported = total;
+                Q_EMIT parent->progress_changed(total);
+            }
+        };
+
+        while ( !pool.waitForDone(50) )
+            report();
+        report();
+    }
+
     void result_to_shapes(model::ShapeListProperty& prop, const TraceResult& result, qreal stroke_width)
     {
         auto fill = std::make_unique<model::Fill>(document);
@@ -65,7 +115,7 @@ public:
 };
 
 glaxnimate::utils::trace::TraceWrapper::TraceWrapper(model::Image* image)
-    : TraceWrapper(image->owner_composition(), image->image->pixmap().toImage(), image->object_name())
+    : TraceWrapper(image->owner_composition(), image->image->get_image(), image->object_name())
 {
     d->image = image;
 
@@ -110,19 +160,9 @@ void glaxnimate::utils::trace::TraceWrapper::trace_exact(
     const std::vector<QRgb>& colors, int tolerance, std::vector<TraceResult>& result
 )
 {
-    result.reserve(result.size() + colors.size());
     Q_EMIT progress_max_changed(100 * colors.size());
-    int progress_index = 0;
-    for ( QColor color : colors )
-    {
-        result.emplace_back();
-        result.back().color = color;
-        utils::trace::Tracer tracer(d->source_image, d->options);
-        tracer.set_target_color(color, tolerance * tolerance);
-        tracer.set_progress_range(100 * progress_index, 100 * (progress_index+1));
-        tracer.trace(result.back().bezier);
-        ++progress_index;
-    }
+    auto masks = utils::trace::split_colors(d->source_image, colors, tolerance * tolerance);
+    d->trace_masks(this, masks, colors, result);
 }
 
 void glaxnimate::utils::trace::TraceWrapper::trace_closest(
@@ -130,17 +170,8 @@ void glaxnimate::utils::trace::TraceWrapper::trace_closest(
 {
     Q_EMIT progress_max_changed(100 * colors.size());
     QImage converted = utils::quantize::quantize(d->source_image, colors);
-    utils::trace::Tracer tracer(converted, d->options);
-    result.reserve(result.size() + colors.size());
-
-    for ( int i = 0; i < int(colors.size()); i++ )
-    {
-        tracer.set_target_index(i);
-        tracer.set_progress_range(100 * i, 100 * (i+1));
-        result.emplace_back();
-        result.back().color = colors[i];
-        tracer.trace(result.back().bezier);
-    }
+    auto masks = utils::trace::split_indexed(converted, colors.size());
+    d->trace_masks(this, masks, colors, result);
 }
 
 void glaxnimate::utils::trace::TraceWrapper::trace_pixel(std::vector<TraceResult>& result)
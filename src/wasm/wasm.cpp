@@ -7,12 +7,14 @@
 
 #include <QCoreApplication>
 #include <QMetaProperty>
+#include <QtMath>
 
 #include "glaxnimate/io/io_registry.hpp"
 #include "glaxnimate/renderer/renderer.hpp"
 #include "glaxnimate/module/module.hpp"
 #include "glaxnimate/command/animation_commands.hpp"
 #include "glaxnimate/model/animation/meta_animatable.hpp"
+#include "glaxnimate/model/frame_cache.hpp"
 
 #include "glaxnimate/script/glaxnimate_model.hpp"
 
@@ -149,7 +151,9 @@ public:
     {
         if ( !comp )
             return;
-        frame = comp->render_image(current_time()).convertToFormat(QImage::Format_RGBA8888);
+        frame = frame_cache.frame(comp, current_time()).convertToFormat(QImage::Format_RGBA8888);
+        // Render ahead of playback while idle
+        frame_cache.prefetch(comp, current_time() + 1, qCeil(comp->fps.get()));
     }
 
     emscripten::val render()
@@ -200,6 +204,7 @@ private:
     QImage frame;
     std::unique_ptr<model::Document> document;
     model::Composition* comp = nullptr;
+    model::FrameCache frame_cache;
 
 };
 
@@ -0,0 +1,417 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Throughput benchmarks for loading, evaluating, rendering, and exporting.
+ *
+ * This accepts all the usual QtTest options, plus `-json FILE` to write the
+ * results in a format that can be compared across commits:
+ *
+ *      glaxnimate_benchmarks -json before.json
+ *      glaxnimate_benchmarks -json after.json benchmark_render
+ */
+
+#include <QTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QXmlStreamReader>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/assets/assets.hpp"
+#include "glaxnimate/model/assets/composition.hpp"
+#include "glaxnimate/model/shapes/composable/layer.hpp"
+#include "glaxnimate/model/shapes/composable/precomp_layer.hpp"
+#include "glaxnimate/model/shapes/shapes/rect.hpp"
+#include "glaxnimate/model/shapes/shapes/ellipse.hpp"
+#include "glaxnimate/model/shapes/style/fill.hpp"
+#include "glaxnimate/model/shapes/style/stroke.hpp"
+#include "glaxnimate/model/shapes/modifiers/trim.hpp"
+#include "glaxnimate/model/shapes/modifiers/offset_path.hpp"
+#include "glaxnimate/model/shapes/modifiers/repeater.hpp"
+#include "glaxnimate/math/bezier/bezier_length.hpp"
+#include "glaxnimate/renderer/renderer.hpp"
+#include "glaxnimate/io/io_registry.hpp"
+#include "glaxnimate/module/module.hpp"
+
+using namespace glaxnimate;
+
+class Benchmarks: public QObject
+{
+    Q_OBJECT
+
+    /**
+     * \brief Parameters for synthetic_document()
+     */
+    struct DocumentSpec
+    {
+        int layers;
+        int keyframes;
+        bool modifiers;
+        int precomps;
+    };
+
+    static constexpr model::FrameTime duration = 60;
+
+    template<class Property, class Func>
+    static void animate(Property& property, int keyframes, const Func& value)
+    {
+        if ( keyframes <= 1 )
+        {
+            property.set(value(0));
+            return;
+        }
+
+        for ( int i = 0; i < keyframes; i++ )
+            property.set_keyframe(duration * i / (keyframes - 1), value(i));
+    }
+
+    static std::unique_ptr<model::Layer> synthetic_layer(model::Document* document, int index, const DocumentSpec& spec)
+    {
+        auto layer = std::make_unique<model::Layer>(document);
+        layer->name.set(QString("Layer %1").arg(index));
+        layer->animation->last_frame.set(duration);
+
+        QPointF origin((index * 37) % 472, (index * 91) % 472);
+        animate(layer->transform->rotation, spec.keyframes, [](int k){ return k * 15.f; });
+        layer->transform->anchor_point.set(origin);
+        layer->transform->position.set(origin);
+
+        auto rect = std::make_unique<model::Rect>(document);
+        rect->size.set(QSizeF(40, 30));
+        rect->rounded.set(index % 3 * 4);
+        animate(rect->position, spec.keyframes, [&origin](int k){ return origin + QPointF(k * 5, 0); });
+        layer->shapes.insert(std::move(rect));
+
+        auto ellipse = std::make_unique<model::Ellipse>(document);
+        ellipse->position.set(origin + QPointF(20, 20));
+        animate(ellipse->size, spec.keyframes, [](int k){ return QSizeF(20 + k % 4 * 5, 20); });
+        layer->shapes.insert(std::move(ellipse));
+
+        if ( spec.modifiers )
+        {
+            auto offset = std::make_unique<model::OffsetPath>(document);
+            animate(offset->amount, spec.keyframes, [](int k){ return k % 2 ? 4.f : -2.f; });
+            layer->shapes.insert(std::move(offset));
+
+            auto trim = std::make_unique<model::Trim>(document);
+            animate(trim->end, spec.keyframes, [&spec](int k){ return float(k + 1) / spec.keyframes; });
+            layer->shapes.insert(std::move(trim));
+
+            auto repeater = std::make_unique<model::Repeater>(document);
+            repeater->copies.set(3);
+            repeater->transform->position.set(QPointF(8, 8));
+            layer->shapes.insert(std::move(repeater));
+        }
+
+        auto fill = std::make_unique<model::Fill>(document);
+        animate(fill->color, spec.keyframes, [index](int k){ return QColor::fromHsv((index * 20 + k * 30) % 360, 200, 220); });
+        layer->shapes.insert(std::move(fill));
+
+        auto stroke = std::make_unique<model::Stroke>(document);
+        stroke->color.set(QColor(20, 20, 20));
+        stroke->width.set(3);
+        layer->shapes.insert(std::move(stroke));
+
+        return layer;
+    }
+
+    /**
+     * \brief Builds a document with the main composition as its first composition
+     */
+    static std::unique_ptr<model::Document> synthetic_document(const DocumentSpec& spec)
+    {
+        auto document = std::make_unique<model::Document>("benchmark");
+        auto comp = document->assets()->add_comp_no_undo();
+        comp->name.set("Main");
+        comp->animation->last_frame.set(duration);
+
+        for ( int i = 0; i < spec.precomps; i++ )
+        {
+            auto precomp = document->assets()->add_comp_no_undo();
+            precomp->name.set(QString("Precomp %1").arg(i));
+            precomp->animation->last_frame.set(duration);
+            for ( int j = 0; j < 5; j++ )
+                precomp->shapes.insert(synthetic_layer(document.get(), j, spec));
+
+            auto layer = std::make_unique<model::PreCompLayer>(document.get());
+            layer->composition.set(precomp);
+            layer->size.set(QSizeF(precomp->width.get(), precomp->height.get()));
+            layer->timing->start_time.set(i * 5);
+            layer->transform->scale.set(QVector2D(0.5, 0.5));
+            comp->shapes.insert(std::move(layer));
+        }
+
+        for ( int i = 0; i < spec.layers; i++ )
+            comp->shapes.insert(synthetic_layer(document.get(), i, spec));
+
+        return document;
+    }
+
+    static void add_document_columns()
+    {
+        QTest::addColumn<int>("layers");
+        QTest::addColumn<int>("keyframes");
+        QTest::addColumn<bool>("modifiers");
+        QTest::addColumn<int>("precomps");
+    }
+
+    static void add_document_rows()
+    {
+        QTest::newRow("small") << 10 << 2 << false << 0;
+        QTest::newRow("medium") << 100 << 8 << true << 2;
+        QTest::newRow("large") << 500 << 16 << true << 8;
+    }
+
+    static std::unique_ptr<model::Document> fetch_document()
+    {
+        QFETCH(int, layers);
+        QFETCH(int, keyframes);
+        QFETCH(bool, modifiers);
+        QFETCH(int, precomps);
+        return synthetic_document({layers, keyframes, modifiers, precomps});
+    }
+
+    static void add_format_rows(io::ImportExport::Direction direction, const QStringList& slugs)
+    {
+        QTest::addColumn<QString>("format");
+        add_document_columns();
+
+        for ( const auto& slug : slugs )
+        {
+            // Optional modules might not have been built
+            if ( !io::IoRegistry::instance().from_slug(slug, direction) )
+                continue;
+
+            QTest::newRow(qUtf8Printable(slug + " small")) << slug << 10 << 2 << false << 0;
+            QTest::newRow(qUtf8Printable(slug + " medium")) << slug << 100 << 8 << true << 2;
+            // Video export of large documents takes too long to be useful here
+            if ( slug != "video" )
+                QTest::newRow(qUtf8Printable(slug + " large")) << slug << 500 << 16 << true << 8;
+        }
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        module::initialize();
+    }
+
+    void benchmark_load_data()
+    {
+        add_format_rows(io::ImportExport::Import, {"glaxnimate", "lottie", "tgs", "svg", "rive"});
+    }
+
+    void benchmark_load()
+    {
+        QFETCH(QString, format);
+        auto source = fetch_document();
+
+        auto exporter = io::IoRegistry::instance().from_slug(format, io::ImportExport::Export);
+        QVERIFY(exporter);
+        QString filename = "benchmark." + exporter->extensions(io::ImportExport::Export).value(0);
+        QByteArray data = exporter->save(source->assets()->compositions->values[0], {}, filename);
+        QVERIFY(!data.isEmpty());
+
+        auto importer = io::IoRegistry::instance().from_slug(format, io::ImportExport::Import);
+        QBENCHMARK {
+            model::Document document(filename);
+            QVERIFY(importer->load(&document, data, {}, filename));
+        }
+    }
+
+    void benchmark_evaluate_data()
+    {
+        add_document_columns();
+        add_document_rows();
+    }
+
+    void benchmark_evaluate()
+    {
+        auto document = fetch_document();
+
+        QBENCHMARK {
+            for ( model::FrameTime t = 0; t < duration; t++ )
+                document->set_current_time(t);
+        }
+    }
+
+    void benchmark_render_data()
+    {
+        QTest::addColumn<QString>("renderer");
+        add_document_columns();
+
+        for ( const auto& factory : renderer::RendererRegistry::instance().factories() )
+        {
+            QString id = factory.first;
+            QTest::newRow(qUtf8Printable(id + " small")) << id << 10 << 2 << false << 0;
+            QTest::newRow(qUtf8Printable(id + " medium")) << id << 100 << 8 << true << 2;
+            QTest::newRow(qUtf8Printable(id + " large")) << id << 500 << 16 << true << 8;
+        }
+    }
+
+    void benchmark_render()
+    {
+        QFETCH(QString, renderer);
+        auto document = fetch_document();
+        auto comp = document->assets()->compositions->values[0];
+        auto painter = renderer::RendererRegistry::instance().factory_build(renderer, 10);
+        QVERIFY(painter);
+        QImage image(comp->width.get(), comp->height.get(), QImage::Format_ARGB32_Premultiplied);
+
+        QBENCHMARK {
+            for ( model::FrameTime t = 0; t < duration; t += 10 )
+                comp->render_image(t, image, painter.get());
+        }
+    }
+
+    void benchmark_bezier_length_data()
+    {
+        QTest::addColumn<int>("segments");
+        QTest::newRow("10 segments") << 10;
+        QTest::newRow("100 segments") << 100;
+        QTest::newRow("1000 segments") << 1000;
+    }
+
+    void benchmark_bezier_length()
+    {
+        QFETCH(int, segments);
+
+        math::bezier::Bezier bez;
+        bez.add_point(QPointF(0, 0), QPointF(0, 0), QPointF(10, 5));
+        for ( int i = 1; i <= segments; i++ )
+            bez.add_point(QPointF(i * 20, i % 2 * 30), QPointF(-10, i % 3 * 5), QPointF(10, -i % 3 * 5));
+        math::bezier::MultiBezier mbez(bez);
+
+        QBENCHMARK {
+            math::bezier::LengthData length(mbez, 20);
+            for ( int i = 0; i <= 100; i++ )
+                length.at_ratio(i / 100.);
+        }
+    }
+
+    void benchmark_save_data()
+    {
+        add_format_rows(io::ImportExport::Export, {"glaxnimate", "lottie", "tgs", "svg", "rive", "video"});
+    }
+
+    void benchmark_save()
+    {
+        QFETCH(QString, format);
+        auto document = fetch_document();
+        auto comp = document->assets()->compositions->values[0];
+        auto exporter = io::IoRegistry::instance().from_slug(format, io::ImportExport::Export);
+        QString filename = "benchmark." + exporter->extensions(io::ImportExport::Export).value(0);
+
+        QBENCHMARK {
+            QVERIFY(!exporter->save(comp, {}, filename).isEmpty());
+        }
+    }
+
+    void benchmark_video_frame_rate_data()
+    {
+        add_document_columns();
+        QTest::newRow("small") << 10 << 2 << false << 0;
+        QTest::newRow("medium") << 100 << 8 << true << 2;
+    }
+
+    // Frames per second for a whole video export, rendering and encoding included
+    void benchmark_video_frame_rate()
+    {
+        auto exporter = io::IoRegistry::instance().from_slug("video", io::ImportExport::Export);
+        if ( !exporter )
+            QSKIP("The video module has not been built");
+
+        auto document = fetch_document();
+        auto comp = document->assets()->compositions->values[0];
+        QString filename = "benchmark." + exporter->extensions(io::ImportExport::Export).value(0);
+
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(!exporter->save(comp, {}, filename).isEmpty());
+        QTest::setBenchmarkResult(duration * 1e9 / timer.nsecsElapsed(), QTest::FramesPerSecond);
+    }
+};
+
+/**
+ * \brief Converts QtTest XML results into JSON
+ */
+static bool write_json(const QString& xml_filename, const QString& json_filename)
+{
+    QFile xml_file(xml_filename);
+    if ( !xml_file.open(QIODevice::ReadOnly) )
+        return false;
+
+    QJsonArray results;
+    QString function;
+    QXmlStreamReader xml(&xml_file);
+    while ( !xml.atEnd() )
+    {
+        if ( xml.readNext() != QXmlStreamReader::StartElement )
+            continue;
+
+        if ( xml.name() == QLatin1String("TestFunction") )
+        {
+            function = xml.attributes().value("name").toString();
+        }
+        else if ( xml.name() == QLatin1String("BenchmarkResult") )
+        {
+            auto attrs = xml.attributes();
+            results.push_back(QJsonObject{
+                {"benchmark", function},
+                {"tag", attrs.value("tag").toString()},
+                {"metric", attrs.value("metric").toString()},
+                {"value", attrs.value("value").toDouble()},
+                {"iterations", attrs.value("iterations").toInt()},
+            });
+        }
+    }
+
+    QFile json_file(json_filename);
+    if ( !json_file.open(QIODevice::WriteOnly) )
+        return false;
+
+    QJsonObject json{
+        {"qt_version", qVersion()},
+        {"results", results},
+    };
+    json_file.write(QJsonDocument(json).toJson());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+
+    QString json_filename;
+    int json_index = args.indexOf("-json");
+    if ( json_index != -1 && json_index + 1 < args.size() )
+    {
+        json_filename = args[json_index + 1];
+        args.remove(json_index, 2);
+    }
+
+    Benchmarks benchmarks;
+    if ( json_filename.isEmpty() )
+        return QTest::qExec(&benchmarks, args);
+
+    QTemporaryDir dir;
+    QString xml_filename = dir.filePath("results.xml");
+    args << "-o" << xml_filename + ",xml" << "-o" << "-,txt";
+    int result = QTest::qExec(&benchmarks, args);
+    if ( !write_json(xml_filename, json_filename) )
+    {
+        qWarning() << "Could not write" << json_filename;
+        return 1;
+    }
+    return result;
+}
+
+#include "benchmarks.moc"
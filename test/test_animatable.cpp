@@ -12,6 +12,7 @@
 #include "glaxnimate/model/object.hpp"
 #include "glaxnimate/model/document.hpp"
 #include "glaxnimate/command/animation_commands.hpp"
+#include "glaxnimate/math/bezier/bezier_length.hpp"
 
 using namespace glaxnimate::command;
 using namespace glaxnimate::model;
@@ -82,6 +83,13 @@ std::unique_ptr<Keyframe<T>> newkf(FrameTime time, T val, KeyframeTransition tra
     return p;
 }
 
+// Point at \p ratio of the path length, using LengthData the way lerp did before caching the length table
+QPointF reference_point(const math::bezier::CubicBezierSolver<QPointF>& segment, qreal ratio)
+{
+    math::bezier::LengthData data(segment, 20);
+    return segment.solve(data.at_ratio(ratio).ratio);
+}
+
 class TestAnimatable: public QObject
 {
     Q_OBJECT
@@ -134,6 +142,71 @@ private Q_SLOTS:
 
     }
 
+    void test_animation_container_sequential()
+    {
+        KeyframeContainer<int> cont;
+        for ( int i = 0; i < 10; i++ )
+            cont.insert(i * 10, i);
+
+        const auto& ccont = cont;
+        // Forwards, backwards and jumping around should match a fresh lookup
+        for ( int t : {-5, 0, 1, 9, 10, 11, 25, 30, 31, 90, 100, 50, 49, 40, 0, 75} )
+        {
+            int expected = std::clamp(t / 10, 0, 9);
+            QCOMPARE(*cont.find_best(t), expected);
+
+            int expected_strict = t <= 0 ? 0 : std::clamp((t - 1) / 10, 0, 9);
+            QCOMPARE(*ccont.find_best(t), expected_strict);
+        }
+
+        auto iter = cont.find_best(35);
+        QCOMPARE(iter.key(), 30);
+        cont.insert(iter, 35, 100);
+        QCOMPARE(cont.size(), 11);
+        QCOMPARE(*cont.find_best(36), 100);
+        QCOMPARE(*ccont.find_best(35), 3);
+        QCOMPARE(*cont.find(35), 100);
+    }
+
+    void test_animation_container_copy_move()
+    {
+        KeyframeContainer<int> cont;
+        for ( int i = 0; i < 5; i++ )
+            cont.insert(i * 10, i);
+        // Move the cursor past the end of the copies below
+        QCOMPARE(*cont.find_best(45), 4);
+
+        KeyframeContainer<int> copy(cont);
+        CONTAINER_COMPARE(copy, {0, 0}, {10, 1}, {20, 2}, {30, 3}, {40, 4});
+        // Copies are deep
+        *copy.find(10) = 100;
+        QCOMPARE(*cont.find(10), 1);
+
+        KeyframeContainer<int> short_cont;
+        short_cont.insert(0, 7);
+        cont = short_cont;
+        CONTAINER_COMPARE(cont, {0, 7});
+        QCOMPARE(*cont.find_best(45), 7);
+
+        KeyframeContainer<int> moved(std::move(copy));
+        CONTAINER_COMPARE(moved, {0, 0}, {10, 100}, {20, 2}, {30, 3}, {40, 4});
+        QCOMPARE(copy.empty(), true);
+        QCOMPARE(copy.find_best(45), copy.end());
+
+        moved = std::move(short_cont);
+        CONTAINER_COMPARE(moved, {0, 7});
+        QCOMPARE(*moved.find_best(45), 7);
+        QCOMPARE(short_cont.empty(), true);
+
+        // Containers can be stored in vectors, as the clipboard does
+        std::vector<KeyframeContainer<int>> vec;
+        vec.resize(2);
+        vec.push_back(moved);
+        vec.push_back(KeyframeContainer<int>(moved));
+        QCOMPARE(vec.size(), std::size_t(4));
+        CONTAINER_COMPARE(vec[3], {0, 7});
+    }
+
     void test_int_basics()
     {
         Document doc("");
@@ -406,6 +479,7 @@ private Q_SLOTS:
             QPointF(50, 200),
             QPointF(100, 200)
         );
+        QCOMPARE(property.get_at(50), reference_point(b, 0.5));
         QPointF p = b.solve(0.25);
         property.split_segment(0, 0.25);
         PROPERTY_KEYFRAMES(type, property, newkf<type>(0, QPointF(0, 0)), newkf<type>(10, p), newkf<type>(100, QPointF(100, 200)));
@@ -418,6 +492,38 @@ private Q_SLOTS:
         PROPERTY_KEYFRAMES(type, property, newkf<type>(0, QPointF(1, 23)), newkf<type>(10, QPointF(4, 56)), newkf<type>(100, QPointF(8, 67)));
     }
 
+    void test_point_bezier_cached_length()
+    {
+        Document doc("");
+        MetaTestSubject ts(&doc);
+        auto& property = ts.anim_point;
+
+        math::bezier::Point start(QPointF(0, 0), QPointF(0, 0), QPointF(0, -50));
+        property.set_keyframe(0, QPointF(0, 0));
+        property.set_keyframe(100, QPointF(100, 200));
+        property.keyframe_at(0)->set_point(start);
+        QPointF expected = reference_point({QPointF(0, 0), QPointF(0, -50), QPointF(100, 200), QPointF(100, 200)}, 0.5);
+        QCOMPARE(property.get_at(50), expected);
+        // Uses the table built by the previous call
+        QCOMPARE(property.get_at(50), expected);
+
+        MetaTestSubject uncached(&doc);
+        uncached.anim_point.set_keyframe(0, QPointF(0, 0));
+        uncached.anim_point.set_keyframe(100, QPointF(100, 200));
+        uncached.anim_point.keyframe_at(0)->set_point(start);
+        QCOMPARE(property.get_at(50), uncached.anim_point.get_at(50));
+
+        // Changing the next keyframe must invalidate the cached length data
+        property.keyframe_at(100)->set_point(math::bezier::Point(
+            QPointF(100, 200),
+            QPointF(50, 200),
+            QPointF(100, 200)
+        ));
+        expected = reference_point({QPointF(0, 0), QPointF(0, -50), QPointF(50, 200), QPointF(100, 200)}, 0.5);
+        QVERIFY(property.get_at(50) != uncached.anim_point.get_at(50));
+        QCOMPARE(property.get_at(50), expected);
+    }
+
     void test_command_set_keyframe()
     {
         Document doc("");
@@ -174,6 +174,71 @@ private Q_SLOTS:
             CLOSE_ENOUGH(seg.solve(child_split.descend().ratio).y(), 100, false);
         }
     }
+
+    void test_segment_table_matches_length_data()
+    {
+        Solver seg{{0, 0}, {0, -50}, {50, 200}, {100, 200}};
+        LengthData data(seg, 20);
+        SegmentLengthTable table(seg, 20);
+        QCOMPARE(table.length(), data.length());
+
+        for ( int i = 0; i <= 100; i += 5 )
+        {
+            qreal ratio = i / 100.;
+            QCOMPARE(table.t_at_ratio(ratio), data.at_ratio(ratio).ratio);
+        }
+    }
+
+    void test_segment_table_length_at_t()
+    {
+        Solver seg{{0, 0}, {33.333, 0}, {66.667, 0}, {100, 0}};
+        SegmentLengthTable table(seg, 10);
+        QCOMPARE(table.length(), 100);
+
+        for ( int i = 0; i <= 100; i += 10 )
+        {
+            CLOSE_ENOUGH(table.length_at_t(i / 100.), i, false);
+            CLOSE_ENOUGH(table.t_at_ratio(table.length_at_t(i / 100.) / table.length()), i / 100., false);
+        }
+    }
+
+    void benchmark_motion_path_lookup_data()
+    {
+        QTest::addColumn<bool>("cached");
+        QTest::newRow("LengthData") << false;
+        QTest::newRow("SegmentLengthTable") << true;
+    }
+
+    void benchmark_motion_path_lookup()
+    {
+        QFETCH(bool, cached);
+
+        // Hundreds of motion paths evaluated over a second of animation
+        std::vector<Solver> segments;
+        for ( int i = 0; i < 500; i++ )
+            segments.emplace_back(QPointF(i, 0), QPointF(i, -50), QPointF(i + 50, 200), QPointF(i + 100, 200));
+
+        std::vector<SegmentLengthTable> tables;
+        for ( const auto& seg : segments )
+            tables.emplace_back(seg, 20);
+
+        qreal sum = 0;
+        QBENCHMARK
+        {
+            for ( int frame = 0; frame < 60; frame++ )
+            {
+                qreal ratio = frame / 60.;
+                for ( std::size_t i = 0; i < segments.size(); i++ )
+                {
+                    if ( cached )
+                        sum += segments[i].solve(tables[i].t_at_ratio(ratio)).x();
+                    else
+                        sum += segments[i].solve(LengthData(segments[i], 20).at_ratio(ratio).ratio).x();
+                }
+            }
+        }
+        QVERIFY(sum > 0);
+    }
 };
 
 QTEST_GUILESS_MAIN(TestCase)
@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QImage>
+#include <QBuffer>
+
+#include "glaxnimate/model/assets/bitmap_cache.hpp"
+
+using namespace glaxnimate::model;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    static QByteArray encoded_image(int width, int height, QRgb color)
+    {
+        QImage image(width, height, QImage::Format_ARGB32);
+        image.fill(color);
+        QByteArray data;
+        QBuffer buf(&data);
+        buf.open(QIODevice::WriteOnly);
+        image.save(&buf, "PNG");
+        return data;
+    }
+
+private Q_SLOTS:
+    void init()
+    {
+        BitmapCache::instance().clear();
+        BitmapCache::instance().set_memory_budget(256 * 1024 * 1024);
+    }
+
+    void test_shared_decode()
+    {
+        QByteArray data = encoded_image(16, 8, qRgb(255, 0, 0));
+        // Separate copies of the same bytes, as two bitmaps would have
+        QByteArray other = QByteArray(data.constData(), data.size());
+
+        auto& cache = BitmapCache::instance();
+        QImage first = cache.image(BitmapCache::key(data), data);
+        QImage second = cache.image(BitmapCache::key(other), other);
+
+        QCOMPARE(first.size(), QSize(16, 8));
+        QCOMPARE(first.format(), QImage::Format_ARGB32_Premultiplied);
+        QCOMPARE(first.pixel(3, 3), qRgb(255, 0, 0));
+        // Same pixel buffer, decoded once
+        QCOMPARE(first.cacheKey(), second.cacheKey());
+        QCOMPARE(cache.memory_usage(), qint64(first.sizeInBytes()));
+    }
+
+    void test_preview()
+    {
+        QByteArray data = encoded_image(64, 32, qRgb(0, 0, 255));
+        auto key = BitmapCache::key(data);
+
+        auto& cache = BitmapCache::instance();
+        QImage preview = cache.image(key, data, QSize(16, 16));
+        QCOMPARE(preview.size(), QSize(16, 8));
+        QCOMPARE(preview.pixel(4, 4), qRgb(0, 0, 255));
+
+        QImage full = cache.image(key, data);
+        QCOMPARE(full.size(), QSize(64, 32));
+        QCOMPARE(cache.memory_usage(), qint64(full.sizeInBytes() + preview.sizeInBytes()));
+    }
+
+    void test_eviction()
+    {
+        QByteArray first = encoded_image(32, 32, qRgb(255, 0, 0));
+        QByteArray second = encoded_image(32, 32, qRgb(0, 255, 0));
+
+        auto& cache = BitmapCache::instance();
+        cache.set_memory_budget(32 * 32 * 4);
+
+        QImage first_image = cache.image(BitmapCache::key(first), first);
+        QImage second_image = cache.image(BitmapCache::key(second), second);
+        QCOMPARE(cache.memory_usage(), qint64(32 * 32 * 4));
+
+        // The first image has been evicted, so it gets decoded again
+        QImage again = cache.image(BitmapCache::key(first), first);
+        QVERIFY(again.cacheKey() != first_image.cacheKey());
+        QCOMPARE(again, first_image);
+
+        cache.clear();
+        QCOMPARE(cache.memory_usage(), qint64(0));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_bitmap_cache.moc"
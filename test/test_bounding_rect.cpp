@@ -0,0 +1,152 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/assets/assets.hpp"
+#include "glaxnimate/model/assets/composition.hpp"
+#include "glaxnimate/model/shapes/composable/group.hpp"
+#include "glaxnimate/model/shapes/shapes/path.hpp"
+#include "glaxnimate/model/shapes/modifiers/repeater.hpp"
+#include "glaxnimate/model/shapes/style/stroke.hpp"
+#include "glaxnimate/command/shape_commands.hpp"
+
+using namespace glaxnimate;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    // Arc whose handles are further out than the curve
+    static math::bezier::Bezier arc()
+    {
+        math::bezier::Bezier bez(QPointF(0, 0));
+        bez.cubic_to(QPointF(0, -40), QPointF(100, -40), QPointF(100, 0));
+        return bez;
+    }
+
+    struct Tree
+    {
+        model::Document document{""};
+        model::Composition* comp;
+        model::Group* group;
+        model::Path* path;
+
+        Tree()
+        {
+            comp = document.assets()->add_comp_no_undo();
+            auto group_ptr = std::make_unique<model::Group>(&document);
+            group = group_ptr.get();
+            auto path_ptr = std::make_unique<model::Path>(&document);
+            path = path_ptr.get();
+            path->shape.set(arc());
+            group->shapes.insert(std::move(path_ptr));
+            document.push_command(new command::AddShape(&comp->shapes, std::move(group_ptr)));
+        }
+    };
+
+private Q_SLOTS:
+    void test_control_box()
+    {
+        auto bez = arc();
+        QCOMPARE(bez.bounding_box(), QRectF(0, -30, 100, 30));
+        QCOMPARE(bez.control_box(), QRectF(0, -40, 100, 40));
+
+        // Outer tangents are only used by closed curves
+        bez[0].tan_in = QPointF(-10, 0);
+        QCOMPARE(bez.control_box(), QRectF(0, -40, 100, 40));
+        bez.close();
+        QCOMPARE(bez.control_box(), QRectF(-10, -40, 110, 40));
+    }
+
+    void test_modes()
+    {
+        Tree tree;
+        QCOMPARE(tree.group->cached_local_bounding_rect(0), QRectF(0, -30, 100, 30));
+        QCOMPARE(tree.group->cached_local_bounding_rect(0, model::VisualNode::Conservative), QRectF(0, -40, 100, 40));
+        QCOMPARE(tree.group->cached_local_bounding_rect(0), tree.group->local_bounding_rect(0));
+    }
+
+    void test_invalidation()
+    {
+        Tree tree;
+        QCOMPARE(tree.group->cached_local_bounding_rect(0), QRectF(0, -30, 100, 30));
+
+        // Changes to the children propagate to the parent
+        math::bezier::Bezier line(QPointF(0, 0));
+        line.line_to(QPointF(50, 50));
+        tree.path->shape.set(line);
+        QCOMPARE(tree.path->cached_local_bounding_rect(0), QRectF(0, 0, 50, 50));
+        QCOMPARE(tree.group->cached_local_bounding_rect(0), QRectF(0, 0, 50, 50));
+        QCOMPARE(tree.group->cached_local_bounding_rect(0, model::VisualNode::Conservative), QRectF(0, 0, 50, 50));
+
+        // Keyed by frame
+        tree.path->shape.set_keyframe(0, line);
+        tree.path->shape.set_keyframe(10, arc());
+        QCOMPARE(tree.group->cached_local_bounding_rect(0), QRectF(0, 0, 50, 50));
+        QCOMPARE(tree.group->cached_local_bounding_rect(10), QRectF(0, -30, 100, 30));
+    }
+
+    void test_document_coordinates()
+    {
+        Tree tree;
+        QCOMPARE(tree.path->cached_bounding_rect(0), QRectF(0, -30, 100, 30));
+
+        tree.group->transform->position.set(QPointF(10, 20));
+        QCOMPARE(tree.group->cached_local_bounding_rect(0), QRectF(0, -30, 100, 30));
+        QCOMPARE(tree.path->cached_bounding_rect(0), QRectF(10, -10, 100, 30));
+        QCOMPARE(tree.group->cached_bounding_rect(0, model::VisualNode::Conservative), QRectF(10, -20, 100, 40));
+    }
+
+    void test_empty_group()
+    {
+        Tree tree;
+        tree.group->shapes.remove(0);
+        QCOMPARE(tree.group->cached_local_bounding_rect(0), QRectF(0, 0, 512, 512));
+
+        tree.comp->width.set(100);
+        QCOMPARE(tree.group->cached_local_bounding_rect(0), QRectF(0, 0, 100, 512));
+    }
+
+    // The canvas repaints the rect of drawing_root() when a shape changes
+    void test_drawing_root()
+    {
+        Tree tree;
+        auto inner_ptr = std::make_unique<model::Group>(&tree.document);
+        auto inner = inner_ptr.get();
+        auto path_ptr = std::make_unique<model::Path>(&tree.document);
+        auto path = path_ptr.get();
+        path->shape.set(arc());
+        inner->shapes.insert(std::move(path_ptr));
+        inner->shapes.insert(std::make_unique<model::Stroke>(&tree.document), 0);
+        tree.group->shapes.insert(std::move(inner_ptr));
+
+        // Only drawn by the stroke in the same group
+        QVERIFY(path->drawing_root() == inner);
+        QVERIFY(inner->drawing_root() == inner);
+
+        // Repeater in the parent group
+        tree.group->shapes.insert(std::make_unique<model::Repeater>(&tree.document), 0);
+        QVERIFY(path->drawing_root() == tree.group);
+        QVERIFY(inner->drawing_root() == tree.group);
+        tree.group->shapes.remove(0);
+        QVERIFY(path->drawing_root() == inner);
+
+        // Stroke in the parent group
+        auto stroke = tree.group->shapes.insert(std::make_unique<model::Stroke>(&tree.document), 0);
+        QVERIFY(path->drawing_root() == tree.group);
+        stroke->width.set(20);
+        QVERIFY(tree.group->cached_local_bounding_rect(0).contains(inner->cached_local_bounding_rect(0)));
+
+        // Operators only affect the shapes that come after them
+        tree.group->shapes.move(0, tree.group->shapes.size() - 1);
+        QVERIFY(path->drawing_root() == inner);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_bounding_rect.moc"
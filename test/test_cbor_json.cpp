@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QBuffer>
+
+#include "glaxnimate/io/lottie/cbor_write_json.hpp"
+
+using namespace glaxnimate::io::lottie;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    static QCborMap sample()
+    {
+        QCborMap nested;
+        nested[QLatin1String("a")] = 1.5;
+        nested[QLatin1String("b")] = QCborArray{1, 2, QCborMap{}};
+        nested[QLatin1String("c")] = QCborArray{};
+
+        QCborMap json;
+        json[QLatin1String("v")] = QLatin1String("5.7.1");
+        json[QLatin1String("fr")] = 60;
+        json[QLatin1String("nm")] = QStringLiteral("\"quoted\"\n");
+        json[QLatin1String("assets")] = QCborArray{};
+        json[QLatin1String("layers")] = QCborArray{nested, nested};
+        json[QLatin1String("meta")] = nested;
+        return json;
+    }
+
+    static QByteArray stream(const QCborMap& json, bool compact)
+    {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        CborJsonStreamWriter writer(&buffer, compact);
+        writer.start_object();
+        for ( auto it = json.begin(); it != json.end(); ++it )
+        {
+            writer.write_key(it.key().toString());
+            if ( it.value().isArray() )
+            {
+                // Stream arrays one element at a time
+                writer.start_array();
+                for ( const auto& item : it.value().toArray() )
+                    writer.write_value(item);
+                writer.end_array();
+            }
+            else
+            {
+                writer.write_value(it.value());
+            }
+        }
+        writer.end_object();
+        return buffer.data();
+    }
+
+private Q_SLOTS:
+    void test_stream_matches_data()
+    {
+        QTest::addColumn<bool>("compact");
+        QTest::newRow("compact") << true;
+        QTest::newRow("pretty") << false;
+    }
+
+    void test_stream_matches()
+    {
+        QFETCH(bool, compact);
+        QCborMap json = sample();
+        QCOMPARE(stream(json, compact), cbor_write_json(json, compact));
+    }
+
+    void test_write_members()
+    {
+        QCborMap json = sample();
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        CborJsonStreamWriter writer(&buffer, false);
+        writer.start_object();
+        writer.write_members(json);
+        writer.end_object();
+        QCOMPARE(buffer.data(), cbor_write_json(json, false));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_cbor_json.moc"
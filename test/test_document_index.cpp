@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/assets/assets.hpp"
+#include "glaxnimate/model/assets/composition.hpp"
+#include "glaxnimate/model/shapes/composable/group.hpp"
+#include "glaxnimate/model/shapes/shapes/rect.hpp"
+#include "glaxnimate/command/shape_commands.hpp"
+
+using namespace glaxnimate;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    struct Tree
+    {
+        model::Document document{""};
+        model::Composition* comp;
+        model::Group* group;
+        model::Rect* rect;
+
+        Tree()
+        {
+            comp = document.assets()->add_comp_no_undo();
+            auto group_ptr = std::make_unique<model::Group>(&document);
+            group_ptr->name.set("Group");
+            group = group_ptr.get();
+            // Child added before the group is in the document
+            auto rect_ptr = std::make_unique<model::Rect>(&document);
+            rect_ptr->name.set("Rect");
+            rect = rect_ptr.get();
+            group->shapes.insert(std::move(rect_ptr));
+            document.push_command(new command::AddShape(&comp->shapes, std::move(group_ptr)));
+        }
+    };
+
+private Q_SLOTS:
+    void test_find_by_uuid()
+    {
+        Tree tree;
+        QCOMPARE(tree.document.find_by_uuid(tree.comp->uuid.get()), tree.comp);
+        QCOMPARE(tree.document.find_by_uuid(tree.group->uuid.get()), tree.group);
+        QCOMPARE(tree.document.find_by_uuid(tree.rect->uuid.get()), tree.rect);
+        QCOMPARE(tree.document.find_by_uuid(tree.document.assets()->uuid.get()), tree.document.assets());
+        QCOMPARE(tree.document.find_by_uuid(QUuid::createUuid()), nullptr);
+    }
+
+    void test_find_by_name()
+    {
+        Tree tree;
+        QCOMPARE(tree.document.find_by_name("Group"), tree.group);
+        QCOMPARE(tree.document.find_by_name("Rect"), tree.rect);
+        QCOMPARE(tree.document.find_by_name("Nope"), nullptr);
+    }
+
+    void test_undo_redo()
+    {
+        Tree tree;
+        QUuid group_uuid = tree.group->uuid.get();
+        QUuid rect_uuid = tree.rect->uuid.get();
+
+        QVERIFY(tree.document.undo());
+        QCOMPARE(tree.document.find_by_uuid(group_uuid), nullptr);
+        QCOMPARE(tree.document.find_by_uuid(rect_uuid), nullptr);
+        QCOMPARE(tree.document.find_by_name("Rect"), nullptr);
+
+        QVERIFY(tree.document.redo());
+        QCOMPARE(tree.document.find_by_uuid(group_uuid), tree.group);
+        QCOMPARE(tree.document.find_by_uuid(rect_uuid), tree.rect);
+        QCOMPARE(tree.document.find_by_name("Rect"), tree.rect);
+    }
+
+    void test_rename()
+    {
+        Tree tree;
+        tree.rect->name.set("Renamed");
+        QCOMPARE(tree.document.find_by_name("Rect"), nullptr);
+        QCOMPARE(tree.document.find_by_name("Renamed"), tree.rect);
+    }
+
+    void test_uuid_changed()
+    {
+        Tree tree;
+        QUuid old_uuid = tree.rect->uuid.get();
+        tree.group->refresh_uuid();
+        QCOMPARE(tree.document.find_by_uuid(old_uuid), nullptr);
+        QCOMPARE(tree.document.find_by_uuid(tree.rect->uuid.get()), tree.rect);
+        QCOMPARE(tree.document.find_by_uuid(tree.group->uuid.get()), tree.group);
+    }
+
+    void test_duplicate_names()
+    {
+        Tree tree;
+        auto rect = std::make_unique<model::Rect>(&tree.document);
+        rect->name.set("Rect");
+        auto other = rect.get();
+        tree.comp->shapes.insert(std::move(rect), 0);
+
+        // Same result as walking the tree
+        QCOMPARE(tree.document.find_by_name("Rect"), tree.document.assets()->docnode_find_by_name("Rect"));
+
+        other->name.set("Other");
+        QCOMPARE(tree.document.find_by_name("Rect"), tree.rect);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_document_index.moc"
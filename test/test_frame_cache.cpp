@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/frame_cache.hpp"
+#include "glaxnimate/model/assets/assets.hpp"
+#include "glaxnimate/model/assets/composition.hpp"
+#include "glaxnimate/model/shapes/shapes/path.hpp"
+#include "glaxnimate/module/module.hpp"
+
+using namespace glaxnimate;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    static math::bezier::Bezier square(qreal size)
+    {
+        math::bezier::Bezier bez(QPointF(0, 0));
+        bez.line_to(QPointF(size, 0));
+        bez.line_to(QPointF(size, size));
+        bez.line_to(QPointF(0, size));
+        bez.close();
+        return bez;
+    }
+
+    // 10x10 composition with frames from 0 to 9
+    struct Tree
+    {
+        model::Document document{""};
+        model::Composition* comp;
+        model::Path* path;
+
+        Tree()
+        {
+            comp = document.assets()->add_comp_no_undo();
+            comp->width.set(10);
+            comp->height.set(10);
+            comp->animation->first_frame.set(0);
+            comp->animation->last_frame.set(9);
+            auto path_ptr = std::make_unique<model::Path>(&document);
+            path = path_ptr.get();
+            path->shape.set(square(5));
+            comp->shapes.insert(std::move(path_ptr));
+        }
+    };
+
+    static constexpr qint64 frame_bytes = 10 * 10 * 4;
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        module::initialize();
+    }
+
+    void test_lru()
+    {
+        Tree tree;
+        model::FrameCache cache(2 * frame_bytes);
+
+        QCOMPARE(cache.frame(tree.comp, 0).size(), QSize(10, 10));
+        cache.frame(tree.comp, 1);
+        QCOMPARE(cache.size(), 2);
+        QCOMPARE(cache.memory_usage(), 2 * frame_bytes);
+
+        // Frame 0 becomes the most recently used, so 1 is evicted instead
+        cache.frame(tree.comp, 0);
+        cache.frame(tree.comp, 2);
+        QCOMPARE(cache.size(), 2);
+        QVERIFY(cache.contains(tree.comp, 0));
+        QVERIFY(!cache.contains(tree.comp, 1));
+        QVERIFY(cache.contains(tree.comp, 2));
+
+        // Size and background are part of the key
+        QVERIFY(!cache.contains(tree.comp, 2, QSize(5, 5)));
+        QVERIFY(!cache.contains(tree.comp, 2, {}, Qt::white));
+
+        cache.set_memory_budget(frame_bytes);
+        QCOMPARE(cache.size(), 1);
+        QVERIFY(cache.contains(tree.comp, 2));
+
+        // Frames larger than the budget are rendered but not kept
+        QCOMPARE(cache.frame(tree.comp, 3, QSize(20, 20)).size(), QSize(20, 20));
+        QVERIFY(!cache.contains(tree.comp, 3, QSize(20, 20)));
+        QCOMPARE(cache.memory_usage(), frame_bytes);
+    }
+
+    void test_invalidation()
+    {
+        Tree tree;
+        model::FrameCache cache;
+        tree.path->shape.set_keyframe(0, square(5));
+        tree.path->shape.set_keyframe(9, square(10));
+
+        cache.frame(tree.comp, 5);
+        QVERIFY(cache.contains(tree.comp, 5));
+
+        // Moving the current time doesn't change any frame
+        tree.document.set_current_time(3);
+        QVERIFY(cache.contains(tree.comp, 5));
+
+        // Keyframe away from the current time
+        tree.path->shape.set_keyframe(9, square(8));
+        QVERIFY(!cache.contains(tree.comp, 5));
+
+        cache.frame(tree.comp, 5);
+        Q_EMIT tree.document.keyframes_changed();
+        QVERIFY(!cache.contains(tree.comp, 5));
+
+        // Graphics change
+        cache.frame(tree.comp, 5);
+        tree.path->visible.set(false);
+        QVERIFY(!cache.contains(tree.comp, 5));
+
+        // Other documents are not affected
+        Tree other;
+        cache.frame(tree.comp, 5);
+        cache.frame(other.comp, 5);
+        other.path->visible.set(false);
+        QVERIFY(cache.contains(tree.comp, 5));
+        QVERIFY(!cache.contains(other.comp, 5));
+    }
+
+    void test_prefetch()
+    {
+        Tree tree;
+        model::FrameCache cache;
+
+        // Frames are only rendered from the event loop
+        cache.prefetch(tree.comp, 8, 4);
+        QCOMPARE(cache.size(), 0);
+        QTRY_COMPARE(cache.size(), 4);
+
+        // Wraps around the animation range
+        for ( int frame : {8, 9, 0, 1} )
+            QVERIFY(cache.contains(tree.comp, frame));
+
+        // Edits drop the frames that are still pending
+        cache.clear();
+        cache.prefetch(tree.comp, 0, 10);
+        Q_EMIT tree.document.keyframes_changed();
+        QTest::qWait(50);
+        QCOMPARE(cache.size(), 0);
+
+        cache.prefetch(tree.comp, 0, 10);
+        cache.stop_prefetch();
+        QTest::qWait(50);
+        QCOMPARE(cache.size(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_frame_cache.moc"
@@ -0,0 +1,322 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <map>
+#include <set>
+
+#include "glaxnimate/io/lottie/json_stream_reader.hpp"
+#include "glaxnimate/io/lottie/cbor_write_json.hpp"
+#include "glaxnimate/io/lottie/lottie_format.hpp"
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/assets/assets.hpp"
+
+using namespace glaxnimate;
+using namespace glaxnimate::io::lottie;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    static QJsonObject shape_layer(int index)
+    {
+        QJsonObject rect{
+            {"ty", "rc"},
+            {"p", QJsonObject{{"a", 0}, {"k", QJsonArray{index, index}}}},
+            {"s", QJsonObject{{"a", 0}, {"k", QJsonArray{10, 20}}}},
+            {"r", QJsonObject{{"a", 0}, {"k", 0}}},
+        };
+        QJsonObject fill{
+            {"ty", "fl"},
+            {"c", QJsonObject{{"a", 0}, {"k", QJsonArray{1, 0, 0}}}},
+            {"o", QJsonObject{{"a", 0}, {"k", 100}}},
+        };
+        return QJsonObject{
+            {"ty", 4},
+            {"ind", index},
+            {"nm", QString("Layer %1").arg(index)},
+            {"ip", 0},
+            {"op", 60},
+            {"st", 0},
+            {"ks", QJsonObject{}},
+            {"shapes", QJsonArray{rect, fill}},
+        };
+    }
+
+    static QByteArray synthetic_lottie(int layer_count)
+    {
+        QJsonArray layers;
+        for ( int i = 0; i < layer_count; i++ )
+            layers.push_back(shape_layer(i));
+
+        QJsonObject json{
+            {"v", "5.7.1"},
+            {"fr", 60},
+            {"ip", 0},
+            {"op", 60},
+            {"w", 512},
+            {"h", 512},
+            {"nm", "Synthetic"},
+            {"assets", QJsonArray{}},
+            {"layers", layers},
+        };
+        return QJsonDocument(json).toJson(QJsonDocument::Compact);
+    }
+
+    // Parenting, a track matte, animated properties, and a precomp
+    static QByteArray complex_lottie()
+    {
+        QJsonObject parent{
+            {"ty", 3},
+            {"ind", 30},
+            {"nm", "Parent"},
+            {"ip", 0},
+            {"op", 60},
+            {"st", 0},
+            {"ks", QJsonObject{}},
+        };
+
+        QJsonObject child = shape_layer(10);
+        child["parent"] = 30;
+        QJsonArray keyframes{
+            QJsonObject{
+                {"t", 0},
+                {"s", QJsonArray{0, 0}},
+                {"o", QJsonObject{{"x", QJsonArray{0.5}}, {"y", QJsonArray{0}}}},
+                {"i", QJsonObject{{"x", QJsonArray{0.5}}, {"y", QJsonArray{1}}}},
+            },
+            QJsonObject{{"t", 30}, {"s", QJsonArray{100, 50}}},
+        };
+        child["ks"] = QJsonObject{{"p", QJsonObject{{"a", 1}, {"k", keyframes}}}};
+
+        QJsonObject matte = shape_layer(40);
+        matte["td"] = 1;
+        QJsonObject matted = shape_layer(50);
+        matted["tt"] = 1;
+
+        QJsonObject precomp_layer{
+            {"ty", 0},
+            {"ind", 20},
+            {"nm", "Precomp"},
+            {"refId", "precomp"},
+            {"w", 512},
+            {"h", 512},
+            {"ip", 0},
+            {"op", 60},
+            {"st", 0},
+            {"ks", QJsonObject{}},
+        };
+
+        QJsonObject json{
+            {"v", "5.7.1"},
+            {"fr", 60},
+            {"ip", 0},
+            {"op", 60},
+            {"w", 512},
+            {"h", 512},
+            {"nm", "Complex"},
+            {"assets", QJsonArray{QJsonObject{{"id", "precomp"}, {"layers", QJsonArray{shape_layer(1)}}}}},
+            {"layers", QJsonArray{parent, child, matte, matted, precomp_layer}},
+        };
+        return QJsonDocument(json).toJson(QJsonDocument::Compact);
+    }
+
+    static QStringList layer_names(model::Document& document)
+    {
+        QStringList names;
+        for ( const auto& shape : document.assets()->compositions->values[0]->shapes )
+            names.push_back(shape->name.get());
+        return names;
+    }
+
+private Q_SLOTS:
+    void test_reader_members()
+    {
+        QByteArray data = R"({"a": 1, "b" : [true, null, "x,]}"], "c\"": {"d": -1.5e2}, "e": []})";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        JsonStreamReader reader(&buffer);
+
+        QString key;
+        QVERIFY(reader.begin_object());
+
+        QVERIFY(reader.next_member(key));
+        QCOMPARE(key, QString("a"));
+        QCOMPARE(reader.read_value().toInt(), 1);
+
+        QVERIFY(reader.next_member(key));
+        QCOMPARE(key, QString("b"));
+        QVERIFY(reader.next_is_array());
+        QVERIFY(reader.begin_array());
+        QVERIFY(reader.next_element());
+        QCOMPARE(reader.read_value(), QJsonValue(true));
+        QVERIFY(reader.next_element());
+        QVERIFY(reader.read_value().isNull());
+        QVERIFY(reader.next_element());
+        QCOMPARE(reader.read_value().toString(), QString("x,]}"));
+        QVERIFY(!reader.next_element());
+
+        QVERIFY(reader.next_member(key));
+        QCOMPARE(key, QString("c\""));
+        QCOMPARE(reader.read_value().toObject()["d"].toDouble(), -150.);
+
+        QVERIFY(reader.next_member(key));
+        QCOMPARE(key, QString("e"));
+        reader.skip_value();
+
+        QVERIFY(!reader.next_member(key));
+        QVERIFY(!reader.has_error());
+        QCOMPARE(reader.position(), qint64(data.size()));
+    }
+
+    void test_reader_chunks()
+    {
+        // Value larger than the read buffer
+        QString long_string(200000, 'x');
+        long_string[150000] = '"';
+        QByteArray data = QJsonDocument(QJsonObject{{"data", long_string}, {"after", 2}}).toJson();
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        JsonStreamReader reader(&buffer);
+
+        QString key;
+        QVERIFY(reader.begin_object());
+        QVERIFY(reader.next_member(key));
+        QCOMPARE(reader.read_value().toString(), long_string);
+        QVERIFY(reader.next_member(key));
+        QCOMPARE(key, QString("after"));
+        QCOMPARE(reader.read_value().toInt(), 2);
+        QVERIFY(!reader.next_member(key));
+        QVERIFY(!reader.has_error());
+    }
+
+    void test_reader_truncated()
+    {
+        QByteArray data = R"({"a": [1, 2)";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        JsonStreamReader reader(&buffer);
+
+        QString key;
+        QVERIFY(reader.begin_object());
+        QVERIFY(reader.next_member(key));
+        reader.read_value();
+        QVERIFY(reader.has_error());
+        QVERIFY(!reader.next_member(key));
+    }
+
+    void test_import_matches()
+    {
+        QByteArray data = synthetic_lottie(20);
+
+        LottieFormat format;
+        model::Document dom_document("");
+        QVERIFY(format.load_json(data, &dom_document));
+
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        model::Document stream_document("");
+        QVERIFY(format.load_json(buffer, &stream_document));
+
+        QCOMPARE(layer_names(stream_document), layer_names(dom_document));
+        QCOMPARE(layer_names(stream_document).size(), 20);
+        auto comp = stream_document.assets()->compositions->values[0];
+        QCOMPARE(comp->fps.get(), 60.f);
+        QCOMPARE(comp->width.get(), 512.f);
+    }
+
+    void test_export_matches_data()
+    {
+        QTest::addColumn<bool>("compact");
+        QTest::newRow("compact") << true;
+        QTest::newRow("pretty") << false;
+    }
+
+    void test_export_matches()
+    {
+        QFETCH(bool, compact);
+        LottieFormat format;
+        model::Document document("");
+        QVERIFY(format.load_json(complex_lottie(), &document));
+        auto comp = document.assets()->compositions->values[0];
+
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        format.write_json(buffer, comp, compact);
+
+        QByteArray dom = cbor_write_json(format.to_json(comp), compact);
+        QCOMPARE(buffer.data(), dom);
+        QCOMPARE(QJsonDocument::fromJson(buffer.data())["assets"].toArray().size(), 1);
+    }
+
+    void test_export_layer_indices()
+    {
+        LottieFormat format;
+        model::Document document("");
+        QVERIFY(format.load_json(synthetic_lottie(3), &document));
+        auto comp = document.assets()->compositions->values[0];
+        comp->shapes[0]->name.set("Bottom");
+
+        // Imported "ind" values are not kept, layers are numbered as they are written
+        QCborArray layers = format.to_json(comp)[QLatin1String("layers")].toArray();
+        QCOMPARE(layers.size(), 3);
+        for ( int i = 0; i < layers.size(); i++ )
+            QCOMPARE(layers[i][QLatin1String("ind")].toInteger(), qint64(i + 1));
+        QCOMPARE(layers[2][QLatin1String("nm")].toString(), QString("Bottom"));
+
+        // Parents refer to the new index
+        model::Document complex("");
+        QVERIFY(format.load_json(complex_lottie(), &complex));
+        comp = complex.assets()->compositions->values[0];
+        std::map<QString, QCborMap> by_name;
+        std::set<qint64> indices;
+        layers = format.to_json(comp)[QLatin1String("layers")].toArray();
+        for ( const auto& layer : layers )
+        {
+            by_name[layer[QLatin1String("nm")].toString()] = layer.toMap();
+            indices.insert(layer[QLatin1String("ind")].toInteger());
+        }
+        QCOMPARE(qint64(indices.size()), qint64(layers.size()));
+        QVERIFY(!indices.count(30));
+        QCOMPARE(by_name[QString("Layer 10")][QLatin1String("parent")].toInteger(), by_name[QString("Parent")][QLatin1String("ind")].toInteger());
+    }
+
+    void benchmark_import_data()
+    {
+        QTest::addColumn<bool>("stream");
+        QTest::newRow("dom") << false;
+        QTest::newRow("stream") << true;
+    }
+
+    void benchmark_import()
+    {
+        QFETCH(bool, stream);
+        QByteArray data = synthetic_lottie(5000);
+        LottieFormat format;
+
+        QBENCHMARK {
+            model::Document document("");
+            if ( stream )
+            {
+                QBuffer buffer(&data);
+                buffer.open(QIODevice::ReadOnly);
+                format.load_json(buffer, &document);
+            }
+            else
+            {
+                format.load_json(data, &document);
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_lottie_stream.moc"
@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "bezier_test.hpp"
+
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/shapes/modifiers/offset_path.hpp"
+
+using namespace glaxnimate;
+
+class TestOffsetPath: public QObject, public BezierTestBase
+{
+    Q_OBJECT
+
+private:
+    // Wavy closed outline, similar to what the tracer produces
+    static math::bezier::Bezier blob(QPointF center, int segments)
+    {
+        math::bezier::Bezier bez;
+        for ( int i = 0; i < segments; i++ )
+        {
+            qreal angle = 2 * M_PI * i / segments;
+            qreal radius = 20 + (i % 2 ? 3 : -3);
+            QPointF pos = center + QPointF(std::cos(angle), std::sin(angle)) * radius;
+            QPointF tangent = QPointF(-std::sin(angle), std::cos(angle)) * radius * 0.1;
+            bez.add_point(pos, pos - tangent, pos + tangent);
+        }
+        bez.close();
+        return bez;
+    }
+
+    static math::bezier::MultiBezier blobs(int count, int segments)
+    {
+        math::bezier::MultiBezier mbez;
+        for ( int i = 0; i < count; i++ )
+            mbez.beziers().push_back(blob(QPointF(i % 10 * 60, i / 10 * 60), segments));
+        return mbez;
+    }
+
+private Q_SLOTS:
+    void test_parallel_matches_serial()
+    {
+        model::Document doc("foo");
+        model::OffsetPath offset(&doc);
+        offset.amount.set(4);
+
+        // Enough segments to be processed in parallel
+        auto input = blobs(20, 32);
+        auto output = offset.process(0, input);
+        QCOMPARE(output.size(), input.size());
+
+        for ( int i = 0; i < input.size(); i++ )
+        {
+            math::bezier::MultiBezier single;
+            single.beziers().push_back(input.beziers()[i]);
+            math::bezier::MultiBezier expected = offset.process(0, single);
+            math::bezier::MultiBezier actual;
+            actual.beziers().push_back(output.beziers()[i]);
+            COMPARE_MULTIBEZIER(actual, expected);
+        }
+    }
+
+    void test_cache()
+    {
+        model::Document doc("foo");
+        model::OffsetPath offset(&doc);
+        offset.amount.set_keyframe(0, 4);
+        offset.amount.set_keyframe(10, 4);
+        offset.amount.set_keyframe(20, -4);
+
+        auto input = blobs(1, 16);
+        auto first = offset.process(0, input);
+        QCOMPARE(offset.computed_count(), quint64(1));
+
+        // Same input and parameters at a different time
+        COMPARE_MULTIBEZIER(offset.process(5, input), first);
+        QCOMPARE(offset.computed_count(), quint64(1));
+
+        // Different parameters
+        auto shrunk = offset.process(20, input);
+        QCOMPARE(offset.computed_count(), quint64(2));
+        QVERIFY(shrunk.bounding_box().width() < first.bounding_box().width());
+
+        // Different input
+        auto moved = input.translated(QPointF(100, 0));
+        QCOMPARE(offset.process(0, moved).bounding_box(), first.bounding_box().translated(100, 0));
+        QCOMPARE(offset.computed_count(), quint64(3));
+
+        // Join is part of the key too
+        offset.join.set(model::Stroke::MiterJoin);
+        offset.process(0, input);
+        QCOMPARE(offset.computed_count(), quint64(4));
+    }
+
+    void benchmark_traced()
+    {
+        model::Document doc("foo");
+        model::OffsetPath offset(&doc);
+        offset.amount.set(4);
+        auto input = blobs(100, 64);
+
+        QBENCHMARK
+        {
+            // Slightly different input each time, to bypass the cache
+            input.beziers()[0][0].pos += QPointF(0.01, 0);
+            offset.process(0, input);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestOffsetPath)
+#include "test_offset_path.moc"
@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QImage>
+
+#include <vector>
+#include "glaxnimate/module/video/pixel_copy.hpp"
+
+using namespace glaxnimate::av;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    static QImage pattern_image(int width, int height)
+    {
+        QImage image(width, height, QImage::Format_ARGB32);
+        for ( int y = 0; y < height; y++ )
+        {
+            auto line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for ( int x = 0; x < width; x++ )
+                line[x] = qRgba(x, y, x ^ y, 255 - x);
+        }
+        return image;
+    }
+
+    // Per-byte copy, as video export used to do
+    static void naive_copy(uint8_t* dest, int dest_stride, const QImage& image)
+    {
+        for ( int y = 0; y < image.height(); y++)
+        {
+            auto line = image.constScanLine(y);
+            for ( int x = 0; x < image.bytesPerLine(); x++ )
+                dest[y * dest_stride + x] = line[x];
+        }
+    }
+
+private Q_SLOTS:
+    void test_same_stride()
+    {
+        QImage image = pattern_image(16, 8);
+        std::vector<uint8_t> dest(image.sizeInBytes());
+        copy_plane(dest.data(), image.bytesPerLine(), image.constBits(), image.bytesPerLine(), image.bytesPerLine(), image.height());
+        QCOMPARE(std::memcmp(dest.data(), image.constBits(), dest.size()), 0);
+    }
+
+    void test_padded_stride()
+    {
+        QImage image = pattern_image(13, 7);
+        int stride = image.bytesPerLine() + 12;
+        std::vector<uint8_t> dest(stride * image.height(), 0xAA);
+        copy_plane(dest.data(), stride, image.constBits(), image.bytesPerLine(), image.bytesPerLine(), image.height());
+
+        for ( int y = 0; y < image.height(); y++ )
+        {
+            QCOMPARE(std::memcmp(dest.data() + y * stride, image.constScanLine(y), image.bytesPerLine()), 0);
+            // Padding is left alone
+            QCOMPARE(dest[y * stride + image.bytesPerLine()], uint8_t(0xAA));
+        }
+    }
+
+    void benchmark_frame_copy_data()
+    {
+        QTest::addColumn<bool>("naive");
+        QTest::addColumn<int>("padding");
+
+        QTest::newRow("per byte") << true << 0;
+        QTest::newRow("per byte padded") << true << 64;
+        QTest::newRow("plane") << false << 0;
+        QTest::newRow("rows padded") << false << 64;
+    }
+
+    void benchmark_frame_copy()
+    {
+        QFETCH(bool, naive);
+        QFETCH(int, padding);
+
+        // 4K frame
+        QImage image = pattern_image(3840, 2160);
+        int stride = image.bytesPerLine() + padding;
+        std::vector<uint8_t> dest(stride * image.height());
+
+        if ( naive )
+        {
+            QBENCHMARK {
+                naive_copy(dest.data(), stride, image);
+            }
+        }
+        else
+        {
+            QBENCHMARK {
+                copy_plane(dest.data(), stride, image.constBits(), image.bytesPerLine(), image.bytesPerLine(), image.height());
+            }
+        }
+
+        QCOMPARE(std::memcmp(dest.data() + stride * 100, image.constScanLine(100), image.bytesPerLine()), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_pixel_copy.moc"
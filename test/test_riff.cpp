@@ -5,6 +5,8 @@
  */
 
 #include <QTest>
+#include <QBuffer>
+#include <QTemporaryFile>
 
 #include <vector>
 #include "glaxnimate/module/extraformats/aep/riff.hpp"
@@ -26,17 +28,17 @@ private Q_SLOTS:
     void test_chunk_find()
     {
         RiffChunk parent{QByteArrayLiteral("rawr"), 0};
-        parent.children.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("itm1")}));
-        parent.children.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("itm3")}));
-        parent.children.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("rept"), 1}));
-        parent.children.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("rept"), 2}));
-        parent.children.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("itm2")}));
+        parent.child_chunks.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("itm1")}));
+        parent.child_chunks.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("itm3")}));
+        parent.child_chunks.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("rept"), 1}));
+        parent.child_chunks.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("rept"), 2}));
+        parent.child_chunks.push_back(std::make_unique<RiffChunk>(RiffChunk{QByteArrayLiteral("itm2")}));
 
         auto it1 = parent.find("itm3");
-        QVERIFY(it1 != parent.children.end());
+        QVERIFY(it1 != parent.children().end());
         QCOMPARE((*it1)->header, "itm3");
         auto it2 = parent.find("rept", it1);
-        QVERIFY(it2 != parent.children.end());
+        QVERIFY(it2 != parent.children().end());
         QCOMPARE((*it2)->header, "rept");
         QCOMPARE(parent.child("itm3")->header, "itm3");
         QCOMPARE(parent.child("itm7"), nullptr);
@@ -250,7 +252,7 @@ private Q_SLOTS:
         QCOMPARE(chunk.length, 4);
         QCOMPARE(chunk.subheader, "rawr");
         QCOMPARE(chunk.data().size(), 0);
-        QCOMPARE(chunk.children.size(), 0);
+        QCOMPARE(chunk.children().size(), 0);
     }
 
     void test_rifx_reader_chunk()
@@ -266,25 +268,25 @@ private Q_SLOTS:
         QCOMPARE(chunk.length, 40);
         QCOMPARE(chunk.subheader, "rawr");
         QCOMPARE(chunk.data().size(), 0);
-        QCOMPARE(chunk.children.size(), 3);
+        QCOMPARE(chunk.children().size(), 3);
 
-        auto child = chunk.children[0].get();
+        auto child = chunk.children()[0].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 4);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3\4"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
 
-        child = chunk.children[1].get();
+        child = chunk.children()[1].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 3);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
 
-        child = chunk.children[2].get();
+        child = chunk.children()[2].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 4);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3\4"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
     }
 
 
@@ -301,35 +303,35 @@ private Q_SLOTS:
         QCOMPARE(chunk.length, 52);
         QCOMPARE(chunk.subheader, "rawr");
         QCOMPARE(chunk.data().size(), 0);
-        QCOMPARE(chunk.children.size(), 1);
+        QCOMPARE(chunk.children().size(), 1);
 
-        auto list = chunk.children[0].get();
+        auto list = chunk.children()[0].get();
         QCOMPARE(list->header, "LIST");
         QCOMPARE(list->subheader, "list");
         QCOMPARE(list->length, 40);
         QCOMPARE(list->data().size(), 0);
-        QCOMPARE(list->children.size(), 3);
+        QCOMPARE(list->children().size(), 3);
 
-        auto child = list->children[0].get();
+        auto child = list->children()[0].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 4);
         QCOMPARE(child->data().size(), 4);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3\4"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
 
-        child = list->children[1].get();
+        child = list->children()[1].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 3);
         QCOMPARE(child->data().size(), 3);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
 
-        child = list->children[2].get();
+        child = list->children()[2].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 4);
         QCOMPARE(child->data().size(), 4);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3\4"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
     }
 
     void test_riff_reader_list()
@@ -345,35 +347,143 @@ private Q_SLOTS:
         QCOMPARE(chunk.length, 52);
         QCOMPARE(chunk.subheader, "rawr");
         QCOMPARE(chunk.data().size(), 0);
-        QCOMPARE(chunk.children.size(), 1);
+        QCOMPARE(chunk.children().size(), 1);
 
-        auto list = chunk.children[0].get();
+        auto list = chunk.children()[0].get();
         QCOMPARE(list->header, "LIST");
         QCOMPARE(list->subheader, "list");
         QCOMPARE(list->length, 40);
         QCOMPARE(list->data().size(), 0);
-        QCOMPARE(list->children.size(), 3);
+        QCOMPARE(list->children().size(), 3);
 
-        auto child = list->children[0].get();
+        auto child = list->children()[0].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 4);
         QCOMPARE(child->data().size(), 4);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3\4"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
 
-        child = list->children[1].get();
+        child = list->children()[1].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 3);
         QCOMPARE(child->data().size(), 3);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
 
-        child = list->children[2].get();
+        child = list->children()[2].get();
         QCOMPARE(child->header, "awoo");
         QCOMPARE(child->length, 4);
         QCOMPARE(child->data().size(), 4);
         QCOMPARE(child->data().read(), QByteArrayLiteral("\1\2\3\4"));
-        QCOMPARE(child->children.size(), 0);
+        QCOMPARE(child->children().size(), 0);
+    }
+
+    void test_mapped_file()
+    {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write(QByteArrayLiteral(
+            "RIFX\x00\x00\x00\x34rawrLIST\0\0\0\x28listawoo\0\0\0\4\1\2\3\4awoo\0\0\0\3\1\2\3\0awoo\0\0\0\4\1\2\3\4"
+        ));
+        file.seek(0);
+        RiffReader reader;
+        auto chunk = reader.parse(&file);
+        QCOMPARE(chunk.length, 52);
+
+        auto list = chunk.child("list");
+        QVERIFY(list);
+        QCOMPARE(list->children().size(), 3);
+        QCOMPARE(list->children()[1]->data().read(), QByteArrayLiteral("\1\2\3"));
+
+        auto data = list->children()[2]->data();
+        QCOMPARE(data.read_uint32(), 0x01020304u);
+        QCOMPARE(data.available(), std::int64_t(0));
+    }
+
+    void test_lazy_children()
+    {
+        // The chunk in the list is longer than the list itself
+        QByteArray arr = QByteArrayLiteral(
+            "RIFX\x00\x00\x00\x1crawrLIST\0\0\0\x10listawoo\0\0\0\x40\1\2\3\4"
+        );
+        QBuffer file(&arr);
+        file.open(QIODevice::ReadOnly);
+        RiffReader reader;
+        auto chunk = reader.parse(&file);
+        QCOMPARE(chunk.children().size(), 1);
+
+        // The error only shows up once the list is accessed
+        auto list = chunk.children()[0].get();
+        QCOMPARE(list->subheader, "list");
+
+        // Accessing it again keeps failing rather than showing an empty list
+        for ( int i = 0; i < 2; i++ )
+        {
+            bool thrown = false;
+            try
+            {
+                list->children();
+            }
+            catch ( const RiffError& )
+            {
+                thrown = true;
+            }
+            QVERIFY(thrown);
+        }
+    }
+
+    void test_read_view()
+    {
+        auto source = std::make_shared<const RiffBuffer>(QByteArrayLiteral("\0\0\0\x2a" "abc"));
+        BinaryReader reader(Endianness::Big(), source);
+        QCOMPARE(reader.read_uint32(), 42u);
+
+        // Views point into the source data
+        auto view = reader.read_view(3);
+        QVERIFY(view.data() == source->bytes().data() + 4);
+        QCOMPARE(view.toByteArray(), QByteArrayLiteral("abc"));
+
+        bool thrown = false;
+        try
+        {
+            reader.read_uint8();
+        }
+        catch ( const RiffError& )
+        {
+            thrown = true;
+        }
+        QVERIFY(thrown);
+    }
+
+    void benchmark_lazy_parse()
+    {
+        // Lots of lists with data that is never looked at
+        QByteArray lists;
+        QByteArray junk(4096, 'x');
+        for ( int i = 0; i < 2000; i++ )
+        {
+            lists += "LIST";
+            lists += Endianness::Big().write_uint(std::uint32_t(4 + 8 + junk.size()));
+            lists += "listjunk";
+            lists += Endianness::Big().write_uint(std::uint32_t(junk.size()));
+            lists += junk;
+        }
+        lists += QByteArrayLiteral("awoo\0\0\0\4\1\2\3\4");
+
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write("RIFX");
+        file.write(Endianness::Big().write_uint(std::uint32_t(4 + lists.size())));
+        file.write("rawr");
+        file.write(lists);
+
+        QBENCHMARK
+        {
+            file.seek(0);
+            RiffReader reader;
+            auto chunk = reader.parse(&file);
+            QCOMPARE(chunk.child("awoo")->data().read_uint32(), 0x01020304u);
+        }
     }
 
     void test_flags()
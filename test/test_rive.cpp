@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QBuffer>
+
+#include "glaxnimate/module/extraformats/rive/rive_loader.hpp"
+#include "glaxnimate/module/extraformats/rive/rive_serializer.hpp"
+
+using namespace glaxnimate::io;
+using namespace glaxnimate::io::rive;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    static QByteArray serialize(const std::vector<Object>& objects)
+    {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        RiveSerializer serializer(&buffer);
+        serializer.write_property_table({});
+        for ( const auto& object : objects )
+            serializer.write_object(object);
+        return data;
+    }
+
+    static std::vector<Object> deserialize(const QByteArray& data)
+    {
+        RiveFormat format;
+        BinaryInputStream stream(data);
+        return RiveLoader(stream, &format).load_object_list();
+    }
+
+private Q_SLOTS:
+    void test_layout()
+    {
+        TypeSystem types;
+        auto type = types.get_type(TypeId::KeyFrameDouble);
+        QVERIFY(type);
+
+        // Inherited properties are part of the layout
+        auto frame = type->property("frame");
+        auto value = type->property("value");
+        QVERIFY(frame);
+        QVERIFY(value);
+        QCOMPARE(type->property(frame->id), frame);
+        QCOMPARE(type->properties[type->property_index(value)], value);
+        QCOMPARE(type->bytes_count, 0);
+        QCOMPARE(type->property_index(Identifier(100000)), -1);
+
+        // Properties from other types aren't found
+        auto artboard = types.get_type(TypeId::Artboard);
+        QCOMPARE(type->property_index(artboard->property("width")), -1);
+        QCOMPARE(artboard->bytes_count, 1);
+    }
+
+    void test_set_get()
+    {
+        TypeSystem types;
+        Object object = types.object(TypeId::Artboard);
+
+        QVERIFY(!object.has("width"));
+        QCOMPARE(object.get<Float32>("width", 12), 12.f);
+        QVERIFY(object.set("width", 512));
+        QVERIFY(object.has("width"));
+        QCOMPARE(object.get<Float32>("width"), 512.f);
+        QCOMPARE(object.get<int>("width"), 512);
+
+        QVERIFY(object.set("name", QString("Artboard")));
+        QCOMPARE(object.get<QString>("name"), QString("Artboard"));
+        QCOMPARE(object.get_variant("name"), QVariant(QString("Artboard")));
+
+        QVERIFY(object.set("clip", 2));
+        QCOMPARE(object.get<bool>("clip"), true);
+        QCOMPARE(object.get_variant("clip"), QVariant(true));
+
+        // Values not matching the property type are converted
+        QVERIFY(object.set("height", QVariant(QString("2.5"))));
+        QCOMPARE(object.get<Float32>("height"), 2.5f);
+        QVERIFY(object.set("defaultStateMachineId", QString("3")));
+        QCOMPARE(object.get<VarUint>("defaultStateMachineId"), VarUint(3));
+
+        QVERIFY(object.set("height", QVariant()));
+        QVERIFY(!object.has("height"));
+
+        QVERIFY(!object.set("not a property", 1));
+    }
+
+    void test_round_trip()
+    {
+        TypeSystem types;
+        std::vector<Object> objects;
+
+        objects.push_back(types.object(TypeId::Artboard));
+        objects.back().set("name", QString("Main"));
+        objects.back().set("width", 512.5);
+        objects.back().set("clip", true);
+
+        objects.push_back(types.object(TypeId::SolidColor));
+        objects.back().set("colorValue", QColor(255, 128, 0, 64));
+        objects.back().set("parentId", 3);
+        // Empty strings are skipped
+        objects.back().set("name", QString());
+
+        objects.push_back(types.object(TypeId::FileAssetContents));
+        objects.back().set("bytes", QByteArray("\0\1\2", 3));
+
+        auto loaded = deserialize(serialize(objects));
+        QCOMPARE(int(loaded.size()), 3);
+
+        QVERIFY(loaded[0].type().id == TypeId::Artboard);
+        QCOMPARE(loaded[0].get<QString>("name"), QString("Main"));
+        QCOMPARE(loaded[0].get<Float32>("width"), 512.5f);
+        QCOMPARE(loaded[0].get<bool>("clip"), true);
+        QVERIFY(!loaded[0].has("height"));
+
+        QCOMPARE(loaded[1].get<QColor>("colorValue"), QColor(255, 128, 0, 64));
+        QCOMPARE(loaded[1].get<Identifier>("parentId"), Identifier(3));
+        QVERIFY(!loaded[1].has("name"));
+
+        QCOMPARE(loaded[2].get<QByteArray>("bytes"), QByteArray("\0\1\2", 3));
+    }
+
+    void benchmark_round_trip()
+    {
+        TypeSystem types;
+        auto kf_type = types.get_type(TypeId::KeyFrameDouble);
+        std::vector<Object> objects;
+        for ( int i = 0; i < 20000; i++ )
+        {
+            objects.emplace_back(kf_type);
+            objects.back().set("interpolationType", 1);
+            objects.back().set("frame", i);
+            objects.back().set("value", i * 0.5);
+        }
+
+        QBENCHMARK
+        {
+            QCOMPARE(int(deserialize(serialize(objects)).size()), 20000);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_rive.moc"
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QBuffer>
+#include <QDomDocument>
+
+#include "glaxnimate/io/svg/svg_parser.hpp"
+#include "glaxnimate/io/svg/parse_error.hpp"
+#include "glaxnimate/io/svg/svg_renderer.hpp"
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/assets/assets.hpp"
+#include "glaxnimate/model/assets/composition.hpp"
+#include "glaxnimate/model/assets/gradient.hpp"
+#include "glaxnimate/model/shapes/composable/layer.hpp"
+#include "glaxnimate/model/shapes/shapes/path.hpp"
+#include "glaxnimate/model/shapes/style/fill.hpp"
+
+using namespace glaxnimate;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    // Shapes refer to elements defined later in the file
+    static QByteArray forward_svg(const QByteArray& extra = {})
+    {
+        return R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink" width="100" height="100">
+            <rect x="0" y="0" width="10" height="10" fill="url(#grad)"/>
+            <use xlink:href="#later" x="5"/>
+            <g id="group"><circle cx="5" cy="5" r="5"/></g>
+            <rect x="0" y="0" width="10" height="10" clip-path="url(#clip)"/>
+            <defs>
+                <linearGradient id="grad" x1="0" y1="0" x2="10" y2="0">
+                    <stop offset="0" stop-color="red"/>
+                    <stop offset="1" stop-color="blue"/>
+                </linearGradient>
+                <clipPath id="clip"><rect width="5" height="5"/></clipPath>
+            </defs>
+            <path id="later" d="M 0 0 L 10 10"/>)" + extra + "</svg>";
+    }
+
+    static model::Layer* parse(model::Document& document, QByteArray data)
+    {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        io::svg::SvgParser(&buffer, io::svg::SvgParser::Groups, &document).parse_to_document();
+        auto comp = document.assets()->compositions->values[0];
+        return static_cast<model::Layer*>(comp->shapes[0]);
+    }
+
+    static QString svg_id(model::DocumentNode* node)
+    {
+        return node->type_name() + "_" + node->uuid.get().toString(QUuid::Id128);
+    }
+
+    static QDomElement find_by_id(const QDomDocument& dom, const QString& tag, const QString& id)
+    {
+        auto elements = dom.elementsByTagName(tag);
+        for ( int i = 0; i < elements.count(); i++ )
+        {
+            auto element = elements.at(i).toElement();
+            if ( element.attribute("id") == id )
+                return element;
+        }
+        return {};
+    }
+
+    static void check_forward(model::Layer* root)
+    {
+        QCOMPARE(root->shapes.size(), 5);
+
+        // Gradient defined after the shape using it
+        auto rect = static_cast<model::Group*>(root->shapes[0]);
+        auto fills = rect->docnode_find_by_type<model::Fill>();
+        QCOMPARE(int(fills.size()), 1);
+        QVERIFY(qobject_cast<model::Gradient*>(fills[0]->use.get()));
+
+        // <use> before its target keeps its position
+        auto use = static_cast<model::Group*>(root->shapes[1]);
+        QCOMPARE(use->transform->position.get(), QPointF(5, 0));
+        QCOMPARE(use->shapes.size(), 1);
+        auto used = static_cast<model::Group*>(use->shapes[0]);
+        QVERIFY(!used->docnode_find_by_type<model::Path>().empty());
+
+        QCOMPARE(root->shapes[2]->name.get(), QString("group"));
+
+        // Clip path defined later
+        auto masked = qobject_cast<model::Layer*>(root->shapes[3]);
+        QVERIFY(masked);
+        QVERIFY(masked->mask->has_mask());
+        QCOMPARE(masked->shapes.size(), 2);
+
+        QCOMPARE(root->shapes[4]->name.get(), QString("later"));
+    }
+
+private Q_SLOTS:
+    void test_forward_references()
+    {
+        model::Document document("");
+        check_forward(parse(document, forward_svg()));
+    }
+
+    void test_animated_matches_streamed()
+    {
+        // Animations make the parser use a DOM, the result should be the same
+        model::Document document("");
+        check_forward(parse(document, forward_svg(R"(<animate xlink:href="#group" attributeName="opacity" from="0" to="1" dur="1s"/>)")));
+    }
+
+    void test_export_streamed()
+    {
+        model::Document document("");
+        auto root = parse(document, forward_svg());
+        auto comp = document.assets()->compositions->values[0];
+        comp->animation->last_frame.set(60);
+        auto group = static_cast<model::Group*>(root->shapes[2]);
+        group->transform->position.set_keyframe(0, QPointF(0, 0));
+        group->transform->position.set_keyframe(30, QPointF(10, 0));
+
+        QByteArray streamed;
+        QBuffer out(&streamed);
+        out.open(QIODevice::WriteOnly);
+        io::svg::SvgRenderer rend(&out, io::svg::SMIL, io::svg::CssFontType::None);
+        rend.write_main(comp, 0);
+        rend.close();
+
+        // Same output when rendering in memory
+        io::svg::SvgRenderer buffered_rend(io::svg::SMIL, io::svg::CssFontType::None);
+        buffered_rend.write_main(comp, 0);
+        QByteArray buffered;
+        QBuffer buffered_out(&buffered);
+        buffered_out.open(QIODevice::WriteOnly);
+        buffered_rend.write(&buffered_out, true);
+        QCOMPARE(streamed, buffered);
+
+        QDomDocument dom;
+        QVERIFY(dom.setContent(streamed));
+        QCOMPARE(dom.documentElement().attribute("width"), QString("100"));
+
+        // Styler attributes are on the shape element
+        auto rect_group = static_cast<model::Group*>(root->shapes[0]);
+        auto fill = rect_group->docnode_find_by_type<model::Fill>()[0];
+        auto rect = find_by_id(dom, "rect", svg_id(fill));
+        QVERIFY(!rect.isNull());
+        QVERIFY(rect.attribute("fill").startsWith("url(#"));
+
+        // Animated transforms wrap the group
+        auto motion = dom.elementsByTagName("animateMotion");
+        QCOMPARE(motion.count(), 1);
+        auto wrapper = motion.at(0).parentNode().toElement();
+        QCOMPARE(wrapper.firstChildElement("g").attribute("id"), svg_id(group));
+
+        // The mask is defined before the masked layer
+        auto masked = static_cast<model::Layer*>(root->shapes[3]);
+        auto layer = find_by_id(dom, "g", svg_id(masked));
+        QVERIFY(!layer.isNull());
+        QString mask_id = "clip_" + svg_id(masked);
+        QCOMPARE(layer.attribute("mask"), "url(#" + mask_id + ")");
+        QVERIFY(!find_by_id(dom, "mask", mask_id).isNull());
+    }
+
+    void test_parse_error()
+    {
+        model::Document document("");
+        QByteArray data = "<svg xmlns=\"http://www.w3.org/2000/svg\"><g></svg>";
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        bool thrown = false;
+        try
+        {
+            io::svg::SvgParser(&buffer, io::svg::SvgParser::Groups, &document);
+        }
+        catch ( const io::svg::SvgParseError& err )
+        {
+            thrown = true;
+            QCOMPARE(err.line, 1);
+        }
+        QVERIFY(thrown);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_svg_stream.moc"
@@ -0,0 +1,140 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <thread>
+
+#include "glaxnimate/model/shapes/shapes/text_cache.hpp"
+
+using namespace glaxnimate;
+using namespace glaxnimate::model;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    static math::bezier::MultiBezier square(qreal size)
+    {
+        math::bezier::MultiBezier bez;
+        bez.move_to(QPointF(0, 0));
+        bez.line_to(QPointF(size, 0));
+        bez.line_to(QPointF(size, size));
+        bez.line_to(QPointF(0, size));
+        bez.close();
+        return bez;
+    }
+
+private Q_SLOTS:
+    void init()
+    {
+        TextCache::instance().clear();
+        TextCache::instance().reset_stats();
+        TextCache::instance().set_memory_budget(TextCache::Glyphs, 32 * 1024 * 1024);
+        TextCache::instance().set_memory_budget(TextCache::Layouts, 16 * 1024 * 1024);
+    }
+
+    void test_shared_glyphs()
+    {
+        auto& cache = TextCache::instance();
+        int built = 0;
+        auto build = [&built]{ built++; return square(10); };
+
+        // Same font from two different shapes
+        auto first = cache.glyph("font", 5, true, build);
+        auto second = cache.glyph("font", 5, true, build);
+        QCOMPARE(built, 1);
+        QCOMPARE(first.bounding_box(), QRectF(0, 0, 10, 10));
+        QCOMPARE(second.bounding_box(), first.bounding_box());
+
+        // Font, glyph, and paint fix are all part of the key
+        cache.glyph("other font", 5, true, build);
+        cache.glyph("font", 6, true, build);
+        cache.glyph("font", 5, false, build);
+        QCOMPARE(built, 4);
+
+        auto stats = cache.stats(TextCache::Glyphs);
+        QCOMPARE(stats.hits, qint64(1));
+        QCOMPARE(stats.misses, qint64(4));
+        QCOMPARE(stats.entries, qint64(4));
+        QVERIFY(stats.memory_usage > 0);
+        QCOMPARE(stats.hit_rate(), 0.2);
+        QCOMPARE(cache.stats(TextCache::Layouts).misses, qint64(0));
+    }
+
+    void test_layouts()
+    {
+        auto& cache = TextCache::instance();
+        int built = 0;
+        auto build = [&built]{
+            built++;
+            Font::ParagraphData para(1);
+            para[0].text = "hello";
+            para[0].glyphs.push_back({1, QPointF(0, 0)});
+            return para;
+        };
+
+        QCOMPARE(cache.layout("font", 1, "hello", build)[0].text, QString("hello"));
+        QCOMPARE(cache.layout("font", 1, "hello", build)[0].glyphs.size(), std::size_t(1));
+        QCOMPARE(built, 1);
+
+        // Line height changes the layout
+        cache.layout("font", 1.5, "hello", build);
+        QCOMPARE(built, 2);
+
+        cache.reset_stats();
+        QCOMPARE(cache.stats(TextCache::Layouts).hits, qint64(0));
+        QCOMPARE(cache.stats(TextCache::Layouts).entries, qint64(2));
+    }
+
+    void test_eviction()
+    {
+        auto& cache = TextCache::instance();
+        int built = 0;
+        auto build = [&built]{ built++; return square(1); };
+
+        cache.glyph("font", 1, true, build);
+        qint64 entry_size = cache.stats(TextCache::Glyphs).memory_usage;
+        cache.set_memory_budget(TextCache::Glyphs, entry_size * 2);
+
+        cache.glyph("font", 2, true, build);
+        // Makes 2 the least recently used one
+        cache.glyph("font", 1, true, build);
+        cache.glyph("font", 3, true, build);
+        QCOMPARE(built, 3);
+        QCOMPARE(cache.stats(TextCache::Glyphs).entries, qint64(2));
+
+        cache.glyph("font", 1, true, build);
+        QCOMPARE(built, 3);
+        cache.glyph("font", 2, true, build);
+        QCOMPARE(built, 4);
+
+        cache.clear();
+        QCOMPARE(cache.stats(TextCache::Glyphs).memory_usage, qint64(0));
+    }
+
+    void test_threads()
+    {
+        auto& cache = TextCache::instance();
+        std::vector<std::thread> threads;
+        for ( int i = 0; i < 4; i++ )
+        {
+            threads.emplace_back([&cache]{
+                for ( quint32 glyph = 0; glyph < 200; glyph++ )
+                    cache.glyph("font", glyph, true, [glyph]{ return square(glyph); });
+            });
+        }
+        for ( auto& thread : threads )
+            thread.join();
+
+        auto stats = cache.stats(TextCache::Glyphs);
+        QCOMPARE(stats.entries, qint64(200));
+        QCOMPARE(stats.hits + stats.misses, qint64(800));
+        QCOMPARE(cache.glyph("font", 42, true, []{ return square(0); }).bounding_box(), QRectF(0, 0, 42, 42));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_text_cache.moc"
@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText: 2019-2026 Mattia Basaglia <dev@dragon.best>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "glaxnimate/io/lottie/cbor_write_json.hpp"
+#include "glaxnimate/module/gzip/gzip.hpp"
+#include "glaxnimate/module/gzip/tgs_format.hpp"
+#include "glaxnimate/model/document.hpp"
+#include "glaxnimate/model/assets/assets.hpp"
+
+using namespace glaxnimate;
+using namespace glaxnimate::io::lottie;
+
+class TestCase: public QObject
+{
+    Q_OBJECT
+
+    static QByteArray sticker(int layer_count)
+    {
+        QJsonArray layers;
+        for ( int i = 0; i < layer_count; i++ )
+        {
+            QJsonObject ellipse{
+                {"ty", "el"},
+                {"p", QJsonObject{{"a", 0}, {"k", QJsonArray{256, 256}}}},
+                {"s", QJsonObject{{"a", 0}, {"k", QJsonArray{i * 10, i * 10}}}},
+            };
+            QJsonObject fill{
+                {"ty", "fl"},
+                {"c", QJsonObject{{"a", 0}, {"k", QJsonArray{0, 0, 1}}}},
+                {"o", QJsonObject{{"a", 0}, {"k", 100}}},
+            };
+            layers.push_back(QJsonObject{
+                {"ty", 4},
+                {"ind", i},
+                {"ip", 0},
+                {"op", 60},
+                {"st", 0},
+                {"ks", QJsonObject{}},
+                {"shapes", QJsonArray{ellipse, fill}},
+            });
+        }
+
+        QJsonObject json{
+            {"v", "5.7.1"},
+            {"fr", 60},
+            {"ip", 0},
+            {"op", 60},
+            {"w", 512},
+            {"h", 512},
+            {"assets", QJsonArray{}},
+            {"layers", layers},
+        };
+        return QJsonDocument(json).toJson(QJsonDocument::Compact);
+    }
+
+private Q_SLOTS:
+    void test_gzip_stream_chunks()
+    {
+        QByteArray data = sticker(100);
+        QBuffer compressed;
+        compressed.open(QIODevice::WriteOnly);
+
+        QStringList errors;
+        gzip::GzipStream stream(&compressed, [&errors](const QString& s){ errors.push_back(s); });
+        QVERIFY(stream.open(QIODevice::WriteOnly));
+        for ( int i = 0; i < data.size(); i += 1000 )
+            QCOMPARE(stream.write(data.mid(i, 1000)), qint64(data.mid(i, 1000).size()));
+        stream.close();
+
+        QCOMPARE(errors, QStringList());
+        QCOMPARE(stream.ouput_size(), qint64(compressed.data().size()));
+        QVERIFY(gzip::is_compressed(compressed.data()));
+
+        QByteArray decompressed;
+        QVERIFY(gzip::decompress(compressed.data(), decompressed, [](const QString&){}));
+        QCOMPARE(decompressed, data);
+    }
+
+    void test_tgs_round_trip()
+    {
+        TgsFormat format;
+        model::Document document("");
+        QVERIFY(format.load_json(sticker(5), &document));
+        auto comp = document.assets()->compositions->values[0];
+
+        QBuffer file;
+        file.open(QIODevice::WriteOnly);
+        QVERIFY(format.save(file, "test.tgs", comp, {}));
+        file.close();
+
+        // Same JSON as the DOM with the TGS settings
+        QByteArray json;
+        QVERIFY(gzip::decompress(file.data(), json, [](const QString&){}));
+        QVariantMap settings;
+        settings[QStringLiteral("duplicate_masks")] = true;
+        QCborMap dom = format.to_json(comp, true, true, settings);
+        dom[QLatin1String("tgs")] = 1;
+        QCOMPARE(json, cbor_write_json(dom, true));
+
+        model::Document loaded("");
+        file.open(QIODevice::ReadOnly);
+        QVERIFY(format.open(file, "test.tgs", &loaded, {}));
+        auto loaded_comp = loaded.assets()->compositions->values[0];
+        QCOMPARE(loaded_comp->shapes.size(), comp->shapes.size());
+        QCOMPARE(loaded_comp->width.get(), 512.f);
+        QCOMPARE(loaded_comp->fps.get(), 60.f);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCase)
+#include "test_tgs.moc"
@@ -8,8 +8,10 @@
 #include <filesystem>
 
 #include "trace/quantize.hpp"
+#include "trace/trace.hpp"
 
 using namespace glaxnimate::utils::quantize;
+using namespace glaxnimate::utils::trace;
 
 
 class TestTrace: public QObject
@@ -20,6 +22,116 @@ private:
 
 private Q_SLOTS:
 
+    void test_split_colors()
+    {
+        // Wider than a word so masks span multiple words per line
+        QImage image(70, 3, QImage::Format_RGBA8888);
+        image.fill(Qt::transparent);
+        image.setPixel(0, 0, qRgb(255, 0, 0));
+        image.setPixel(65, 1, qRgb(255, 0, 0));
+        image.setPixel(1, 2, qRgb(0, 0, 255));
+        image.setPixel(2, 2, qRgb(0, 0, 250));
+
+        auto masks = split_colors(image, {qRgb(255, 0, 0), qRgb(0, 0, 255)}, 0);
+        QCOMPARE(int(masks.size()), 2);
+        QCOMPARE(masks[0].words_per_line(), (70 + BitMask::word_bits - 1) / BitMask::word_bits);
+        QVERIFY(masks[0].get(0, 0));
+        QVERIFY(masks[0].get(65, 1));
+        QVERIFY(!masks[0].get(1, 2));
+        QVERIFY(masks[1].get(1, 2));
+        QVERIFY(!masks[1].get(2, 2));
+        QVERIFY(!masks[1].get(0, 0));
+
+        // With tolerance close colors match too
+        masks = split_colors(image, {qRgb(255, 0, 0), qRgb(0, 0, 255)}, 10 * 10);
+        QVERIFY(masks[1].get(2, 2));
+    }
+
+    void test_split_indexed()
+    {
+        QImage image(3, 2, QImage::Format_Indexed8);
+        image.setColorTable({qRgb(0, 0, 0), qRgb(255, 255, 255)});
+        image.fill(0);
+        image.setPixel(1, 0, 1);
+        image.setPixel(2, 1, 1);
+
+        auto masks = split_indexed(image, 2);
+        QCOMPARE(int(masks.size()), 2);
+        QVERIFY(masks[0].get(0, 0));
+        QVERIFY(!masks[0].get(1, 0));
+        QVERIFY(masks[1].get(1, 0));
+        QVERIFY(masks[1].get(2, 1));
+        QVERIFY(!masks[1].get(0, 1));
+    }
+
+    void test_quantize()
+    {
+        // Big enough to be split across threads
+        QImage image(512, 512, QImage::Format_ARGB32);
+        for ( int y = 0; y < image.height(); y++ )
+            for ( int x = 0; x < image.width(); x++ )
+                image.setPixel(x, y, qRgba(x / 2, y / 2, 0, x < 8 ? 0 : 255));
+
+        std::vector<QRgb> colors{qRgb(0, 0, 0), qRgb(255, 0, 0), qRgb(0, 255, 0), qRgb(255, 255, 0)};
+        QImage quantized = quantize(image, colors);
+        QCOMPARE(quantized.format(), QImage::Format_Indexed8);
+        // Transparent pixels use the extra entry at the end
+        QCOMPARE(quantized.pixelIndex(0, 0), 4);
+        QCOMPARE(quantized.pixelIndex(10, 10), 0);
+        QCOMPARE(quantized.pixelIndex(500, 10), 1);
+        QCOMPARE(quantized.pixelIndex(10, 500), 2);
+        QCOMPARE(quantized.pixelIndex(500, 500), 3);
+    }
+
+    void test_k_means_separated()
+    {
+        QImage image(300, 10, QImage::Format_RGBA8888);
+        for ( int x = 0; x < image.width(); x++ )
+        {
+            // Most pixels are shades of red, so the initial centroids must not all come from there
+            QRgb color = x < 200 ? qRgb(200 + x % 50, 0, 0) : x < 250 ? qRgb(0, 200, x % 10) : qRgb(0, x % 10, 200);
+            for ( int y = 0; y < image.height(); y++ )
+                image.setPixel(x, y, color);
+        }
+
+        auto colors = k_means(image, 3, 100, KMeansMatch::None);
+        QCOMPARE(int(colors.size()), 3);
+        std::sort(colors.begin(), colors.end(), [](QRgb a, QRgb b){ return qRed(a) > qRed(b); });
+        QVERIFY(qRed(colors[0]) > 200);
+        QVERIFY(qGreen(colors[1]) > 150 || qGreen(colors[2]) > 150);
+        QVERIFY(qBlue(colors[1]) > 150 || qBlue(colors[2]) > 150);
+    }
+
+    void test_color_frequencies_sampled()
+    {
+        QImage image(1000, 1000, QImage::Format_RGBA8888);
+        image.fill(qRgb(255, 0, 0));
+        for ( int y = 0; y < 250; y++ )
+            for ( int x = 0; x < image.width(); x++ )
+                image.setPixel(x, y, qRgb(0, 0, 255));
+
+        qreal max_error = 0.01;
+        auto freq = color_frequencies(image, 128, max_error);
+        QCOMPARE(int(freq.size()), 2);
+        for ( const auto& entry : freq )
+        {
+            int expected = entry.first == qRgb(255, 0, 0) ? 750000 : 250000;
+            QVERIFY(qAbs(entry.second - expected) <= max_error * 1000000);
+        }
+    }
+
+    void benchmark_quantize()
+    {
+        auto path = std::filesystem::path(__FILE__).parent_path().parent_path() / "data" / "trace" / "images" / "flat.png";
+        QImage image(QString::fromStdString(path.u8string()));
+        auto colors = octree(image, 16);
+
+        QBENCHMARK
+        {
+            quantize(image, colors);
+        }
+    }
+
     void benchmark_eem()
     {
         auto path = std::filesystem::path(__FILE__).parent_path().parent_path() / "data" / "trace" / "images" / "flat.png";